@@ -0,0 +1,37 @@
+#ifndef FLASH_DIGEST_H_
+#define FLASH_DIGEST_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "api/libflash.h"
+#include "api/flash_hash.h"
+
+/*
+ * Per-sector digest cache. Sector digests are computed on demand and kept
+ * in RAM until the sector is erased or programmed through the driver, so
+ * that unchanged sectors are not hashed again.
+ *
+ * Flash content changes not going through the driver (e.g. from another
+ * task, or by the debugger) are not seen: flash_digest_invalidate() must
+ * then be called.
+ */
+
+#define FLASH_DIGEST_NB_SECTORS 24
+
+/* select the digest algorithm, dropping the cached digests */
+t_flash_err flash_digest_init(const t_flash_hash_alg *alg);
+
+/* digest of a sector content (alg->digest_size bytes) */
+t_flash_err flash_digest_sector(uint8_t sector, uint8_t *digest);
+
+/*
+ * Digest of the consecutive sectors [first, first + nb[: the digest of the
+ * concatenation of their sector digests, only the dirty sectors being
+ * hashed again.
+ */
+t_flash_err flash_digest_region(uint8_t first, uint8_t nb, uint8_t *digest);
+
+/* drop the cached digest of a sector */
+void flash_digest_invalidate(uint8_t sector);
+
+#endif/*!FLASH_DIGEST_H_*/
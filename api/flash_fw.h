@@ -0,0 +1,112 @@
+#ifndef FLASH_FW_H_
+#define FLASH_FW_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "api/libflash.h"
+#include "api/flash_hash.h"
+
+/*
+ * Flip/flop (A/B) firmware image update, for the WOOKEY 2MB dual bank
+ * layout:
+ *
+ *            bank 1 (flip)            bank 2 (flop)
+ * shared     0x08008000 (sector 2)    0x08108000 (sector 14)
+ * image      0x08010000 (sectors 4-11) 0x08110000 (sectors 16-23)
+ *
+ * Each bank shared area starts with a firmware header describing the image
+ * of the bank. The active bank is the one holding a valid header with the
+ * highest counter.
+ *
+ * An update streams the new image into the inactive bank, erasing its
+ * sectors just before they are reached, and computing the image CRC on the
+ * fly. Once the image is complete and verified, the inactive bank header
+ * is written, with a counter greater than the active one, its magic word
+ * being programmed last: the active bank switch is a single word program.
+ */
+
+#define FLASH_FW_MAGIC          0x46574844
+
+typedef enum {
+    FLASH_FW_FLIP = 0,
+    FLASH_FW_FLOP = 1,
+} t_flash_fw_bank;
+
+typedef struct {
+    uint32_t version;
+    uint32_t size;      /* image size */
+    uint32_t crc32;     /* image CRC-32 */
+    uint32_t counter;   /* the highest valid counter gives the active bank */
+    uint32_t hdr_crc;   /* CRC-32 of the above fields */
+    uint32_t magic;     /* FLASH_FW_MAGIC, programmed last */
+} t_flash_fw_header;
+
+/*
+ * Return the active bank and its header. FLASH_ERR_NOENT is returned when
+ * no bank holds a valid header (flip is then considered active).
+ */
+t_flash_err flash_fw_get_active(t_flash_fw_bank *bank, t_flash_fw_header *hdr);
+
+/* image area start address of a bank */
+physaddr_t flash_fw_get_image(t_flash_fw_bank bank);
+
+/* bank written by the current update */
+t_flash_fw_bank flash_fw_get_target(void);
+
+/* start writing an image of the given size into the inactive bank */
+t_flash_err flash_fw_begin(uint32_t size, uint32_t version);
+
+/*
+ * Resume an interrupted update of the same image (size and version) into
+ * the inactive bank. The sector being written when the update stopped is
+ * checked against the last checkpoint, and rewritten if needed. The image
+ * data sent again from offset must be the same as before the interruption. On
+ * success, offset is the image offset from which the streaming continues.
+ * FLASH_ERR_NOENT is returned when there is nothing to resume: the update
+ * must be restarted by flash_fw_begin().
+ */
+t_flash_err flash_fw_resume(uint32_t size, uint32_t version, uint32_t *offset);
+
+/*
+ * Sector-skip update. The inactive bank usually holds the image before the
+ * current one, most of it being unchanged by a new release. An image
+ * sector whose content is already the expected one is neither erased nor
+ * programmed. It is detected either:
+ * - from a manifest, given after flash_fw_begin() or flash_fw_resume(),
+ *   holding the CRC-32 of each image sector part (first image sector
+ *   first, the last one being truncated to the image size), or
+ * - without manifest, when a flash_fw_write() chunk starts at a sector
+ *   start and covers the whole sector, by direct comparison.
+ * The manifest is not copied, and must remain valid during the update.
+ */
+t_flash_err flash_fw_set_manifest(const uint32_t *sector_crc, uint32_t nb);
+
+/*
+ * Compute an additional digest of the image (e.g. &flash_hash_sha256),
+ * given after flash_fw_begin() or flash_fw_resume(). As the image CRC-32,
+ * it is computed on the flash content, read back just after each chunk is
+ * programmed, so that the image is not read again by flash_fw_finish().
+ */
+t_flash_err flash_fw_set_hash(const t_flash_hash_alg *alg);
+
+/*
+ * Digest of the last completed (flash_fw_finish()) update, if any. Returns
+ * the digest size, 0 if no digest is available.
+ */
+uint8_t flash_fw_get_digest(uint8_t *digest);
+
+/* number of image sectors skipped by the current update */
+uint32_t flash_fw_get_skipped(void);
+
+/* stream the next image chunk */
+t_flash_err flash_fw_write(const uint8_t *data, uint32_t len);
+
+/*
+ * Check the image against its expected CRC-32, both on the streamed data
+ * and on the programmed flash content read back while streaming, then make
+ * the bank active. The additional digest, if any, is then available.
+ * FLASH_ERR_VERIFY is returned on mismatch, the active bank is unchanged.
+ */
+t_flash_err flash_fw_finish(uint32_t crc32);
+
+#endif/*!FLASH_FW_H_*/
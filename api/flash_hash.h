@@ -0,0 +1,69 @@
+#ifndef FLASH_HASH_H_
+#define FLASH_HASH_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "api/libflash.h"
+
+/*
+ * Digest primitives used by the flash content integrity checks.
+ */
+
+/*
+ * CRC-32 (IEEE 802.3), zlib compatible: starting from 0, the CRC of a
+ * buffer can be computed incrementally, chunk by chunk:
+ *   crc = flash_crc32(crc, chunk, len);
+ */
+uint32_t flash_crc32(uint32_t crc, const uint8_t *buf, uint32_t len);
+
+/*
+ * Incremental hash contexts. An algorithm is a set of init, update and
+ * final functions working on a t_flash_hash_ctx, so that other ones (e.g.
+ * the HASH peripheral of the STM32F43x) can be plugged in, using the raw
+ * context storage.
+ */
+#define FLASH_HASH_MAX_DIGEST   32
+
+typedef struct {
+    uint32_t state[8];
+    uint32_t len_lo;    /* message length in bytes */
+    uint32_t len_hi;
+    uint8_t block[64];
+} t_flash_sha256_ctx;
+
+struct flash_hash_alg;
+
+typedef struct {
+    const struct flash_hash_alg *alg;
+    union {
+        uint32_t crc;
+        t_flash_sha256_ctx sha256;
+        uint32_t raw[26];
+    } u;
+} t_flash_hash_ctx;
+
+typedef struct flash_hash_alg {
+    uint8_t digest_size;
+    void (*init)(t_flash_hash_ctx *ctx);
+    void (*update)(t_flash_hash_ctx *ctx, const uint8_t *buf, uint32_t len);
+    void (*final)(t_flash_hash_ctx *ctx, uint8_t *digest);
+} t_flash_hash_alg;
+
+/* CRC-32 (digest in little endian byte order) and SHA-256 */
+extern const t_flash_hash_alg flash_hash_crc32;
+extern const t_flash_hash_alg flash_hash_sha256;
+
+void flash_hash_init(t_flash_hash_ctx *ctx, const t_flash_hash_alg *alg);
+
+void flash_hash_update(t_flash_hash_ctx *ctx, const uint8_t *buf, uint32_t len);
+
+/* write the digest (alg->digest_size bytes) */
+void flash_hash_final(t_flash_hash_ctx *ctx, uint8_t *digest);
+
+/*
+ * hash the flash content of [addr, addr + size[, the flash_read() error
+ * (PCROP sector) being returned
+ */
+t_flash_err flash_hash_region(t_flash_hash_ctx *ctx, physaddr_t addr, uint32_t size);
+
+#endif/*!FLASH_HASH_H_*/
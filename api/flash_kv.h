@@ -0,0 +1,53 @@
+#ifndef FLASH_KV_H_
+#define FLASH_KV_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "api/libflash.h"
+
+/*
+ * Log-structured key/value store (EEPROM emulation).
+ *
+ * The store uses two or more flash sectors of the same size. Updates are
+ * appended as records to the head sector, programming only erased bits, so
+ * that an update costs a few word programs instead of a sector erase. The
+ * latest record of each key is indexed in RAM.
+ *
+ * One sector is always kept erased (spare). When the head sector is full,
+ * the spare becomes the new head, the still valid records of the oldest
+ * sector are moved into it, and the oldest sector is erased, becoming the
+ * new spare.
+ *
+ * Keys are in the [0, CONFIG_USR_DRV_FLASH_KV_MAX_KEYS[ range, values are
+ * at most FLASH_KV_MAX_VALUE bytes long. The live records (8 bytes plus the
+ * value rounded up to a word, for each key) must fit in one sector, keeping
+ * room for the update: more sectors only spread the wear.
+ */
+
+#define FLASH_KV_MAX_SECTORS    4
+#define FLASH_KV_MAX_VALUE      255
+
+/*
+ * Mount the store on the given sectors (sector numbers), formatting them
+ * if they don't hold a store, and completing an operation interrupted by
+ * a power loss.
+ */
+t_flash_err flash_kv_init(const uint8_t *sectors, uint8_t nb_sectors);
+
+/*
+ * Read the value of a key. len gives the buffer size, and receives the
+ * value size. FLASH_ERR_NOENT is returned when the key is not set.
+ */
+t_flash_err flash_kv_get(uint16_t key, void *buf, uint16_t *len);
+
+/*
+ * Set the value of a key (a zero length value is not allowed).
+ * FLASH_ERR_NOSPACE is returned when the live records wouldn't fit in one
+ * sector anymore.
+ */
+t_flash_err flash_kv_set(uint16_t key, const void *value, uint16_t len);
+
+/* Delete a key */
+t_flash_err flash_kv_delete(uint16_t key);
+
+#endif/*!FLASH_KV_H_*/
@@ -0,0 +1,60 @@
+#ifndef FLASH_LOG_H_
+#define FLASH_LOG_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "api/libflash.h"
+
+/*
+ * Append-only circular log.
+ *
+ * The log uses consecutive flash sectors of the same size as a ring.
+ * Sectors are divided into fixed size slots, the first one holding the
+ * sector header (magic and sequence number), the others holding one record
+ * each. Records are appended in order to the head sector. When it is full,
+ * the next sector of the ring becomes the head, the oldest records it held
+ * being erased.
+ *
+ * As the slots of the head sector are written in order, the write head is
+ * recovered at init by a binary search over the written/erased boundary of
+ * the head sector: the boot time doesn't depend on the log size.
+ *
+ * Each record is identified by its position, increasing with time:
+ * position = sector sequence number * slots per sector + slot.
+ */
+
+#define FLASH_LOG_MAX_SLOT      256
+
+/*
+ * Called for each record by flash_log_iterate(). Returning false stops the
+ * iteration.
+ */
+typedef bool (*t_flash_log_cb)(uint32_t pos, const uint8_t *rec, uint16_t len,
+                               void *ctx);
+
+/*
+ * Mount the log on nb_sectors consecutive sectors (at least 2), starting
+ * at first_sector, with the given slot size (multiple of 4, from 16 to
+ * FLASH_LOG_MAX_SLOT bytes). A record is at most slot_size - 4 bytes long.
+ */
+t_flash_err flash_log_init(uint8_t first_sector, uint8_t nb_sectors,
+                           uint16_t slot_size);
+
+/* append a record, erasing the oldest sector when the log is full */
+t_flash_err flash_log_append(const void *rec, uint16_t len);
+
+/* position of the oldest record, and position following the newest one */
+uint32_t flash_log_first(void);
+uint32_t flash_log_end(void);
+
+/* call cb for each valid record in the [from, to[ positions range */
+t_flash_err flash_log_iterate(uint32_t from, uint32_t to, t_flash_log_cb cb,
+                              void *ctx);
+
+/*
+ * Drop the oldest records by erasing the oldest sector. The head sector
+ * is never erased (FLASH_ERR_NOENT is returned).
+ */
+t_flash_err flash_log_truncate(void);
+
+#endif/*!FLASH_LOG_H_*/
@@ -0,0 +1,34 @@
+#ifndef FLASH_LZ4_H_
+#define FLASH_LZ4_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "api/libflash.h"
+
+/*
+ * Compressed firmware update: an LZ4 frame (as produced by the lz4 command
+ * line tool) is decompressed on the fly into the current flash_fw update
+ * (see api/flash_fw.h).
+ *
+ * The decompressed image is programmed sequentially: LZ4 matches, which
+ * refer to the last 64KB of output, are read back from the already
+ * programmed part of the image, so that no decompression window is kept in
+ * RAM, whatever the frame block size. Only FLASH_LZ4_BUF_SIZE bytes of
+ * output are buffered before being programmed.
+ *
+ * Frame checksums are not checked, the image CRC-32 being checked by
+ * flash_fw_finish(). Frames with a dictionary are not supported.
+ */
+
+#define FLASH_LZ4_BUF_SIZE      256
+
+/* start decompressing into the update started by flash_fw_begin() */
+t_flash_err flash_lz4_begin(void);
+
+/* decompress the next compressed chunk, of any size */
+t_flash_err flash_lz4_write(const uint8_t *data, uint32_t len);
+
+/* check the frame is complete and program the remaining output */
+t_flash_err flash_lz4_finish(void);
+
+#endif/*!FLASH_LZ4_H_*/
@@ -0,0 +1,58 @@
+#ifndef FLASH_MERKLE_H_
+#define FLASH_MERKLE_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "api/libflash.h"
+
+/*
+ * Merkle tree integrity index over a flash region, split in
+ * FLASH_MERKLE_BLOCK_SIZE bytes blocks.
+ *
+ * Leaves are the SHA-256 of the blocks, inner nodes the SHA-256 of their
+ * two children (with distinct leaf and node prefixes). The tree is stored
+ * in one of two metadata sectors, written alternately, so that a tree
+ * update interrupted by a power loss leaves the previous one.
+ *
+ * Checking a block against a trusted root (e.g. from a signed header) only
+ * hashes the block and reads log2(blocks) nodes: the tree itself doesn't
+ * need to be trusted. Blocks erased or programmed through the driver are
+ * tracked, and only their path is hashed again by flash_merkle_update().
+ * The stored tree is marked dirty before the region is first modified: if
+ * the device resets before the update, flash_merkle_init() builds it
+ * again. Each update still erases a metadata sector and writes all the
+ * nodes of the tree.
+ */
+
+#define FLASH_MERKLE_BLOCK_SIZE 4096
+#define FLASH_MERKLE_MAX_BLOCKS 256
+#define FLASH_MERKLE_NODE_SIZE  32
+
+typedef struct {
+    physaddr_t base;        /* region start, block aligned */
+    uint32_t nb_blocks;     /* region size, in blocks */
+    uint8_t meta[2];        /* metadata sectors, out of the region */
+} t_flash_merkle_conf;
+
+/*
+ * Load the tree of the region from the metadata sectors, building it if
+ * there is none, or if it has been built for another region.
+ */
+t_flash_err flash_merkle_init(const t_flash_merkle_conf *conf);
+
+/* build the whole tree from the region content */
+t_flash_err flash_merkle_build(void);
+
+/* hash again the modified blocks paths, and store the new tree */
+t_flash_err flash_merkle_update(void);
+
+/* root of the tree, updated first if blocks have been modified */
+t_flash_err flash_merkle_root(uint8_t *root);
+
+/*
+ * Check a block content against the given root. FLASH_ERR_VERIFY is
+ * returned if the block or the path to the root doesn't match.
+ */
+t_flash_err flash_merkle_verify(uint32_t block, const uint8_t *root);
+
+#endif/*!FLASH_MERKLE_H_*/
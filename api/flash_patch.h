@@ -0,0 +1,48 @@
+#ifndef FLASH_PATCH_H_
+#define FLASH_PATCH_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "api/libflash.h"
+
+/*
+ * Delta update: a patch stream, applied to the active bank image, gives the
+ * new image, written to the inactive bank through the flash_fw update
+ * (see api/flash_fw.h).
+ *
+ * Patch format (little endian words):
+ * - header: FLASH_PATCH_MAGIC, new image size, new image version, new
+ *   image CRC-32, base (active) image CRC-32
+ * - operations, until the new image is complete:
+ *   FLASH_PATCH_COPY,   offset, len: len bytes of the base image at offset
+ *   FLASH_PATCH_ADD,    offset, len, len bytes: base image bytes at offset,
+ *                       each added (mod 256) to the next patch byte
+ *   FLASH_PATCH_INSERT, len, len bytes: literal bytes
+ * The operation code is a single byte. The new image is produced in order,
+ * so that the inactive bank is written sequentially.
+ *
+ * The patch is given chunk by chunk, of any size: the RAM usage doesn't
+ * depend on the patch nor the image size.
+ */
+
+#define FLASH_PATCH_MAGIC       0x31505746
+
+#define FLASH_PATCH_COPY        0x01
+#define FLASH_PATCH_ADD         0x02
+#define FLASH_PATCH_INSERT      0x03
+
+/* new image bytes buffered before being programmed */
+#define FLASH_PATCH_BUF_SIZE    256
+
+t_flash_err flash_patch_begin(void);
+
+/*
+ * Apply the next patch chunk. FLASH_ERR_VERIFY is returned when the active
+ * image is not the patch base, FLASH_ERR_INVAL on malformed patch.
+ */
+t_flash_err flash_patch_write(const uint8_t *data, uint32_t len);
+
+/* check the patch is complete, then complete the update (flash_fw_finish) */
+t_flash_err flash_patch_finish(void);
+
+#endif/*!FLASH_PATCH_H_*/
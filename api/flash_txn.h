@@ -0,0 +1,48 @@
+#ifndef FLASH_TXN_H_
+#define FLASH_TXN_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "api/libflash.h"
+
+/*
+ * Power-fail safe transactional update of a flash region.
+ *
+ * The region is made of one or more sectors, each associated to a shadow
+ * sector of the same size. The new content of the updated sectors is
+ * staged into their shadow sectors, then the transaction is committed by
+ * programming a single commit word in the journal. The shadow sectors are
+ * then copied to the region. The journal is made of two sectors of the
+ * same size, used in turn, so that erasing a full journal sector never
+ * touches the last transaction record.
+ *
+ * At init, a committed transaction whose copy was not completed (power
+ * loss) is copied again, and an uncommitted one is dropped: the region
+ * holds either the old or the new content, never a mix of both.
+ *
+ * Staged writes must be done in increasing address order in each sector:
+ * the bytes left between them are taken from the current region content.
+ */
+
+#define FLASH_TXN_MAX_SECTORS   8
+
+typedef struct {
+    uint8_t journal[2];                         /* journal sectors */
+    uint8_t nb_sectors;
+    uint8_t sectors[FLASH_TXN_MAX_SECTORS];     /* region sectors */
+    uint8_t shadows[FLASH_TXN_MAX_SECTORS];     /* associated shadow sectors */
+} t_flash_txn_region;
+
+/* set the region, and recover an interrupted transaction */
+t_flash_err flash_txn_init(const t_flash_txn_region *region);
+
+t_flash_err flash_txn_begin(void);
+
+/* stage a write into the region */
+t_flash_err flash_txn_write(physaddr_t addr, const uint8_t *buf, uint32_t size);
+
+t_flash_err flash_txn_commit(void);
+
+t_flash_err flash_txn_abort(void);
+
+#endif/*!FLASH_TXN_H_*/
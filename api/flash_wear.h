@@ -0,0 +1,51 @@
+#ifndef FLASH_WEAR_H_
+#define FLASH_WEAR_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "api/libflash.h"
+
+/*
+ * Per-sector erase counters and wear leveling sector allocator.
+ *
+ * Each sector erase made through the driver (sector, bank or mass erase)
+ * increments the sector erase counter. Counters are persistent: they are
+ * appended to one of two reserved flash sectors
+ * (CONFIG_USR_DRV_FLASH_WEAR_SECTOR and CONFIG_USR_DRV_FLASH_WEAR_SECTOR2),
+ * and compacted into the other one when it is full. These sectors must not
+ * be used for anything else.
+ *
+ * The allocator hands out the least worn free sector of a pool configured
+ * by the application.
+ */
+
+#define FLASH_WEAR_NB_SECTORS   24
+
+/* load the erase counters from the reserved sector (done at first use) */
+t_flash_err flash_wear_init(void);
+
+/* erase counter of the given sector */
+uint32_t flash_wear_get_count(uint8_t sector);
+
+/*
+ * Set the allocator pool, as a bitmask of sector numbers (bit n for
+ * sector n). All the pool sectors are free after this call.
+ */
+t_flash_err flash_wear_set_pool(uint32_t sectors);
+
+/*
+ * Mark a pool sector as allocated, e.g. a sector found in use at boot.
+ */
+t_flash_err flash_wear_reserve(uint8_t sector);
+
+/*
+ * Allocate the least worn free sector of the pool. The sector content is
+ * left untouched: the caller erases it before use.
+ * FLASH_ERR_NOSPACE is returned when all the pool sectors are allocated.
+ */
+t_flash_err flash_wear_alloc(uint8_t *sector);
+
+/* give an allocated sector back to the pool */
+t_flash_err flash_wear_release(uint8_t sector);
+
+#endif/*!FLASH_WEAR_H_*/
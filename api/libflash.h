@@ -140,6 +140,11 @@
 #define FLASH_SECTOR_SYSTEM_MEM_END	((uint32_t) 0x1FFF77FF)
 #define FLASH_SECTOR_OTP_AREA		((uint32_t) 0x1FFF7800) /* 528 B */
 #define FLASH_SECTOR_OTP_AREA_END	((uint32_t) 0x1FFF7A0F)
+/* OTP area: 16 blocks of 32 bytes, then one lock byte per block */
+#define FLASH_OTP_BLOCKS		16
+#define FLASH_OTP_BLOCK_SIZE		32
+#define FLASH_OTP_LOCK_OFFSET		(FLASH_OTP_BLOCKS * FLASH_OTP_BLOCK_SIZE)
+#define FLASH_OTP_SIZE			(FLASH_OTP_LOCK_OFFSET + FLASH_OTP_BLOCKS)
 #define FLASH_OPTION_BYTES		((uint32_t) 0x1FFFC000) /* 16 B */
 #define FLASH_OPTION_BYTES_END		((uint32_t) 0x1FFFC00F)
 
@@ -212,7 +217,7 @@ typedef struct {
 # endif
 #endif
     bool map_ctrl;
-#if CONFIG_WOOKEY
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
     bool map_ctrl_2;
 #endif
     bool map_system;
@@ -233,6 +238,54 @@ typedef enum {
     FLASH_BANK_1 = 1
 } t_flash_bank_id;
 
+/*
+ * flash driver errors. Operations returning a t_flash_err report their
+ * failure cause directly. flash_sector_erase(), which returns the erased
+ * sector number, keeps it for flash_get_last_error().
+ */
+typedef enum {
+    FLASH_ERR_NONE = 0,
+    FLASH_ERR_INVAL,    /* invalid parameter or address out of flash */
+    FLASH_ERR_PROG,     /* programming error reported by FLASH_SR */
+    FLASH_ERR_TIMEOUT,  /* flash still busy after the datasheet max duration */
+    FLASH_ERR_NOSPACE,  /* no free sector or space left */
+    FLASH_ERR_NOENT,    /* no such entry */
+    FLASH_ERR_VERIFY,   /* content check (CRC, digest) failed */
+    FLASH_ERR_WRP,      /* sector write protected (nWRP or PCROP) */
+    FLASH_ERR_PCROP,    /* sector read protected (PCROP) */
+} t_flash_err;
+
+/*
+ * Hook called periodically during long flash busy waits (erase), with the
+ * time elapsed since the beginning of the wait. Typically used to refresh
+ * the watchdog.
+ */
+typedef void (*t_flash_progress_hook)(uint32_t elapsed_us);
+
+/* RDP option byte values, any other value being level 1 */
+#define FLASH_RDP_LEVEL_0       0xAA
+#define FLASH_RDP_LEVEL_2       0xCC    /* irreversible */
+
+/*
+ * Option bytes, staged by flash_opt_read() and programmed at once by
+ * flash_opt_commit(). nWRP holds one bit per sector (bits 0-11: bank 1
+ * from FLASH_OPTCR, bits 12-23: bank 2 from FLASH_OPTCR1), cleared for a
+ * write protected sector (set for a PCROP protected sector when sprmod is
+ * set). DB1M, BFB2, SPRMOD and the bank 2 nWRP bits only exist on
+ * f42xxx/43xxx, and must be left to their read value on other devices.
+ */
+typedef struct {
+    uint8_t  rdp;
+    uint8_t  bor_lev;       /* 0 (BOR level 3) to 3 (BOR off) */
+    bool     wdg_sw;        /* software watchdog */
+    bool     nrst_stop;     /* no reset when entering stop mode */
+    bool     nrst_stdby;    /* no reset when entering standby mode */
+    uint32_t nwrp;
+    bool     db1m;          /* dual bank 1MB flash */
+    bool     bfb2;          /* boot from bank 2 */
+    bool     sprmod;        /* nWRP bits select PCROP instead of WRP */
+} t_flash_opt;
+
 int flash_get_descriptor(t_flash_dev_id id);
 
 /******* Flash operations **********/
@@ -246,17 +299,31 @@ void flash_lock_opt(void);
 
 uint8_t flash_select_sector(physaddr_t addr);
 
+/* sectors holding [addr, addr + size[, bit n for sector n */
+uint32_t flash_range_sectors(physaddr_t addr, uint32_t size);
+
 uint8_t flash_sector_erase(physaddr_t addr);
 
-void flash_mass_erase(void);
+t_flash_err flash_bank_erase(uint8_t bank);
+
+t_flash_err flash_mass_erase(void);
+
+t_flash_err flash_program_dword(uint64_t *addr, uint64_t value);
+
+t_flash_err flash_program_word(uint32_t *addr, uint32_t word);
+
+t_flash_err flash_program_hword(uint16_t *addr, uint16_t value);
 
-void flash_program_dword(uint64_t *addr, uint64_t value);
+t_flash_err flash_program_byte(uint8_t *addr, uint8_t value);
 
-void flash_program_word(uint32_t *addr, uint32_t word);
+/* program already erased flash, without any implicit sector erase */
+t_flash_err flash_write(physaddr_t addr, const uint8_t *buf, uint32_t size);
 
-void flash_program_byte(uint8_t *addr, uint8_t value);
+t_flash_err flash_get_last_error(void);
 
-void flash_read(uint8_t *buffer, physaddr_t addr, uint32_t size);
+void flash_set_progress_hook(t_flash_progress_hook hook, uint32_t period_us);
+
+t_flash_err flash_read(uint8_t *buffer, physaddr_t addr, uint32_t size);
 
 #if defined(USR_DRV_FLASH_DUAL_BANK)	/*  Only on f42xxx/43xxx */
 uint8_t flash_get_bank_conf(void);
@@ -264,7 +331,48 @@ uint8_t flash_get_bank_conf(void);
 void flash_set_bank_conf(uint8_t conf);
 #endif
 
-void flash_copy_sector(physaddr_t dest, physaddr_t src);
+/* option bytes transaction, the option register being unlocked */
+t_flash_err flash_opt_read(t_flash_opt *opt);
+
+t_flash_err flash_opt_commit(const t_flash_opt *opt);
+
+/* irreversible, refused by flash_opt_commit() */
+t_flash_err flash_opt_set_rdp_level2(void);
+
+/* write protection of the sectors covering [addr, addr + len[ */
+t_flash_err flash_wrp_stage_range(t_flash_opt *opt, physaddr_t addr, uint32_t len,
+                                  bool protect);
+
+t_flash_err flash_wrp_set_range(physaddr_t addr, uint32_t len, bool protect);
+
+/* write protected sectors, bit n for sector n */
+uint32_t flash_wrp_query(void);
+
+/* PCROP (SPRMOD) protection of the sectors covering [addr, addr + len[ */
+t_flash_err flash_pcrop_stage_range(t_flash_opt *opt, physaddr_t addr, uint32_t len);
+
+t_flash_err flash_pcrop_set_range(physaddr_t addr, uint32_t len);
+
+/* PCROP protected sectors, bit n for sector n */
+uint32_t flash_pcrop_query(void);
+
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK     /*  Only on f42xxx/43xxx */
+/* bank booted from, and bank to boot from at the next reset (BFB2) */
+t_flash_bank_id flash_boot_get_bank(void);
+
+t_flash_err flash_boot_set_bank(t_flash_bank_id bank);
+#endif
+
+/* OTP blocks, read from a RAM copy of the OTP area */
+t_flash_err flash_otp_read(uint8_t block, uint32_t offset, uint8_t *buf, uint32_t size);
+
+t_flash_err flash_otp_write(uint8_t block, uint32_t offset, const uint8_t *buf, uint32_t size);
+
+t_flash_err flash_otp_lock(uint8_t block);
+
+bool flash_otp_is_locked(uint8_t block);
+
+t_flash_err flash_copy_sector(physaddr_t dest, physaddr_t src);
 
 int flash_device_early_init(t_device_mapping *devmap);
 
@@ -275,5 +383,7 @@ bool flash_is_device_registered(t_flash_dev_id device);
 
 uint32_t flash_sector_size(uint8_t sector);
 
+physaddr_t flash_sector_addr(uint8_t sector);
+
 #endif /* _STM32F4XX_FLASH_H */
 
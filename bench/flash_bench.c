@@ -0,0 +1,302 @@
+/** @file flash_bench.c
+ * \brief Flash driver throughput and latency benchmarks
+ *
+ * Measured:
+ * - program throughput, for each access width (byte to double word)
+ * - flash_write() (burst programming) throughput
+ * - sector erase latency, for each sector size (16, 64 and 128 KB)
+ * - flash_copy_sector() throughput
+ * - flash_read() bandwidth
+ * - flash_select_sector() lookup cost
+ *
+ * Flash bound operations are timed in microseconds (simulator virtual clock
+ * or systick). CPU bound ones are timed with the host monotonic clock (ns)
+ * in the simulator, in cycles on target.
+ */
+
+#include "autoconf.h"
+#include "api/libflash.h"
+#include "libc/stdio.h"
+#include "libc/string.h"
+#include "libc/syscall.h"
+#include "flash_regs.h"
+#include "flash_bench.h"
+
+#if CONFIG_USR_DRV_FLASH_BACKEND_EXTERN
+# include <time.h>
+# include "flash_sim.h"
+# define BENCH_MODE             "sim"
+# define BENCH_CPU_UNIT         "ns"
+/* double word programming requires the external Vpp */
+# define BENCH_DWORD            1
+#else
+# define BENCH_MODE             "target"
+# define BENCH_CPU_UNIT         "cycles"
+# ifndef BENCH_DWORD
+#  define BENCH_DWORD           0
+# endif
+#endif
+
+/* configuration name, given by sim/Makefile for the simulator builds */
+#ifndef BENCH_CONFIG
+# if CONFIG_WOOKEY
+#  define BENCH_CONFIG          "2m_wookey"
+# elif CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+#  define BENCH_CONFIG          "2m_rt"
+# elif CONFIG_USR_DRV_FLASH_2M
+#  define BENCH_CONFIG          "2m"
+# elif CONFIG_USR_DRV_FLASH_DUAL_BANK
+#  define BENCH_CONFIG          "1m_db"
+# else
+#  define BENCH_CONFIG          "1m"
+# endif
+#endif
+
+/*
+ * Benchmark sectors. On target, in dual bank mode, the second bank is used,
+ * the code running from the first one.
+ */
+#if !CONFIG_USR_DRV_FLASH_BACKEND_EXTERN && CONFIG_USR_DRV_FLASH_DUAL_BANK
+# define BENCH_SECTOR_16K       FLASH_SECTOR_13
+# define BENCH_SECTOR_16K_SRC   FLASH_SECTOR_14
+# define BENCH_SECTOR_16K_DST   FLASH_SECTOR_15
+# define BENCH_SECTOR_64K       FLASH_SECTOR_16
+# define BENCH_SECTOR_128K      FLASH_SECTOR_17
+#else
+# define BENCH_SECTOR_16K       FLASH_SECTOR_1
+# define BENCH_SECTOR_16K_SRC   FLASH_SECTOR_2
+# define BENCH_SECTOR_16K_DST   FLASH_SECTOR_3
+# define BENCH_SECTOR_64K       FLASH_SECTOR_4
+# define BENCH_SECTOR_128K      FLASH_SECTOR_5
+#endif
+
+#if CONFIG_USR_DRV_FLASH_2M
+# define BENCH_FLASH_END        FLASH_SECTOR_23_END
+#elif CONFIG_USR_DRV_FLASH_DUAL_BANK
+# define BENCH_FLASH_END        FLASH_SECTOR_19_END
+#else
+# define BENCH_FLASH_END        FLASH_SECTOR_11_END
+#endif
+
+#define BENCH_PROG_SIZE         0x8000
+#define BENCH_WRITE_CHUNK       256
+#define BENCH_READ_SIZE         0x10000
+#define BENCH_READ_CHUNK        256
+#define BENCH_READ_LOOPS        64
+#define BENCH_LOOKUP_STRIDE     256
+#define BENCH_LOOKUP_LOOPS      16
+
+static inline uint64_t bench_flash_time_us(void)
+{
+#if CONFIG_USR_DRV_FLASH_BACKEND_EXTERN
+    return flash_sim_clock_us();
+#else
+    uint64_t ts = 0;
+    sys_get_systick(&ts, PREC_MICRO);
+    return ts;
+#endif
+}
+
+static inline uint64_t bench_cpu_time(void)
+{
+#if CONFIG_USR_DRV_FLASH_BACKEND_EXTERN
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    uint64_t ts = 0;
+    sys_get_systick(&ts, PREC_CYCLE);
+    return ts;
+#endif
+}
+
+static void bench_report_flash(const char *bench, const char *param,
+                               uint32_t value, uint32_t bytes, uint64_t us)
+{
+    uint32_t bps = us ? (uint32_t)(((uint64_t)bytes * 1000000) / us) : 0;
+
+    printf("{\"mode\":\"%s\",\"config\":\"%s\",\"bench\":\"%s\",\"%s\":%u,"
+           "\"bytes\":%u,\"time_us\":%u,\"bytes_per_s\":%u}\n",
+           BENCH_MODE, BENCH_CONFIG, bench, param, value, bytes,
+           (uint32_t)us, bps);
+}
+
+static void bench_report_cpu(const char *bench, const char *count_name,
+                             uint32_t count, uint64_t time)
+{
+    printf("{\"mode\":\"%s\",\"config\":\"%s\",\"bench\":\"%s\",\"%s\":%u,"
+           "\"cpu_time\":%u,\"unit\":\"%s\"}\n",
+           BENCH_MODE, BENCH_CONFIG, bench, count_name, count,
+           (uint32_t)time, BENCH_CPU_UNIT);
+}
+
+/*
+ * Program throughput for a given access width. The sector start is
+ * skipped, as programming it triggers the implicit sector erase.
+ */
+static int bench_program(uint8_t width)
+{
+    physaddr_t addr = BENCH_SECTOR_128K + 16;
+    physaddr_t end = addr + BENCH_PROG_SIZE;
+    uint64_t start;
+    t_flash_err err = FLASH_ERR_NONE;
+
+    if (flash_sector_erase(BENCH_SECTOR_128K) == 0xff) {
+        return -1;
+    }
+    start = bench_flash_time_us();
+    for (; addr < end && err == FLASH_ERR_NONE; addr += width / 8) {
+        switch (width) {
+            case 8:
+                err = flash_program_byte((uint8_t*)addr, 0x5a);
+                break;
+            case 16:
+                err = flash_program_hword((uint16_t*)addr, 0x5a5a);
+                break;
+            case 32:
+                err = flash_program_word((uint32_t*)addr, 0x5a5a5a5a);
+                break;
+            default:
+                err = flash_program_dword((uint64_t*)addr, 0x5a5a5a5a5a5a5a5aULL);
+                break;
+        }
+    }
+    if (err != FLASH_ERR_NONE) {
+        return -1;
+    }
+    bench_report_flash("program", "width", width, BENCH_PROG_SIZE,
+                       bench_flash_time_us() - start);
+    return 0;
+}
+
+/* flash_write() throughput, by chunks of BENCH_WRITE_CHUNK bytes */
+static int bench_write(void)
+{
+    uint8_t buf[BENCH_WRITE_CHUNK];
+    uint64_t start;
+
+    if (flash_sector_erase(BENCH_SECTOR_128K) == 0xff) {
+        return -1;
+    }
+    memset(buf, 0x5a, sizeof(buf));
+    start = bench_flash_time_us();
+    for (uint32_t off = 0; off < BENCH_PROG_SIZE; off += sizeof(buf)) {
+        if (flash_write(BENCH_SECTOR_128K + off, buf, sizeof(buf)) != FLASH_ERR_NONE) {
+            return -1;
+        }
+    }
+    bench_report_flash("write", "chunk", BENCH_WRITE_CHUNK, BENCH_PROG_SIZE,
+                       bench_flash_time_us() - start);
+    return 0;
+}
+
+static int bench_erase(physaddr_t sector_addr)
+{
+    uint32_t size = flash_sector_size(flash_select_sector(sector_addr));
+    uint64_t start = bench_flash_time_us();
+
+    if (flash_sector_erase(sector_addr) == 0xff) {
+        return -1;
+    }
+    bench_report_flash("sector_erase", "sector_kb", size / 1024, size,
+                       bench_flash_time_us() - start);
+    return 0;
+}
+
+static int bench_copy(void)
+{
+    uint32_t size = flash_sector_size(flash_select_sector(BENCH_SECTOR_16K_SRC));
+    uint64_t start;
+
+    /* source sector content (the sector start is erased and skipped) */
+    if (flash_sector_erase(BENCH_SECTOR_16K_SRC) == 0xff) {
+        return -1;
+    }
+    for (uint32_t off = 4; off < size; off += 4) {
+        if (flash_program_word((uint32_t*)(BENCH_SECTOR_16K_SRC + off), off) != FLASH_ERR_NONE) {
+            return -1;
+        }
+    }
+    start = bench_flash_time_us();
+    if (flash_copy_sector(BENCH_SECTOR_16K_DST, BENCH_SECTOR_16K_SRC) != FLASH_ERR_NONE) {
+        return -1;
+    }
+    bench_report_flash("copy_sector", "sector_kb", size / 1024, size,
+                       bench_flash_time_us() - start);
+    return 0;
+}
+
+static int bench_read(void)
+{
+    uint8_t buffer[BENCH_READ_CHUNK];
+    uint64_t start = bench_cpu_time();
+
+    for (uint32_t loop = 0; loop < BENCH_READ_LOOPS; ++loop) {
+        for (uint32_t off = 0; off < BENCH_READ_SIZE; off += BENCH_READ_CHUNK) {
+            flash_read(buffer, BENCH_SECTOR_64K + off, BENCH_READ_CHUNK);
+        }
+    }
+    bench_report_cpu("read", "bytes", BENCH_READ_SIZE * BENCH_READ_LOOPS,
+                     bench_cpu_time() - start);
+    return 0;
+}
+
+static int bench_select_sector(void)
+{
+    volatile uint32_t sink = 0;
+    uint32_t count = 0;
+    uint64_t start = bench_cpu_time();
+
+    for (uint32_t loop = 0; loop < BENCH_LOOKUP_LOOPS; ++loop) {
+        for (physaddr_t addr = FLASH_SECTOR_0; addr < BENCH_FLASH_END;
+             addr += BENCH_LOOKUP_STRIDE) {
+            sink += flash_select_sector(addr);
+            count++;
+        }
+    }
+    bench_report_cpu("select_sector", "lookups", count,
+                     bench_cpu_time() - start);
+    return 0;
+}
+
+int flash_bench_run(void)
+{
+    int ret = 0;
+
+    flash_unlock();
+    ret |= bench_program(8);
+    ret |= bench_program(16);
+    ret |= bench_program(32);
+#if BENCH_DWORD
+# if CONFIG_USR_DRV_FLASH_BACKEND_EXTERN
+    flash_sim_set_voltage_range(FLASH_SIM_VRANGE_VPP);
+# endif
+    ret |= bench_program(64);
+# if CONFIG_USR_DRV_FLASH_BACKEND_EXTERN
+    flash_sim_set_voltage_range(FLASH_SIM_VRANGE_2V7_3V6);
+# endif
+#endif
+    ret |= bench_write();
+    ret |= bench_erase(BENCH_SECTOR_16K);
+    ret |= bench_erase(BENCH_SECTOR_64K);
+    ret |= bench_erase(BENCH_SECTOR_128K);
+    ret |= bench_copy();
+    ret |= bench_read();
+    ret |= bench_select_sector();
+    flash_lock();
+    if (ret) {
+        printf("{\"mode\":\"%s\",\"config\":\"%s\",\"error\":%d}\n",
+               BENCH_MODE, BENCH_CONFIG, flash_get_last_error());
+    }
+    return ret;
+}
+
+#if CONFIG_USR_DRV_FLASH_BACKEND_EXTERN
+int main(void)
+{
+    if (flash_sim_init() || flash_init()) {
+        return 1;
+    }
+    return flash_bench_run() ? 1 : 0;
+}
+#endif
@@ -0,0 +1,21 @@
+#ifndef FLASH_BENCH_H_
+#define FLASH_BENCH_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+
+/*
+ * Flash driver benchmarks.
+ *
+ * Run against the timed simulator (see sim/Makefile, bench target) or on
+ * target, the root Makefile bench target building libflash_bench.a, to be
+ * linked with an application calling flash_bench_run(). Results are printed
+ * as one JSON object per line.
+ *
+ * On target, the flash memory and control devices must be mapped, and the
+ * benchmark sectors (see flash_bench.c) must not hold any useful content:
+ * they are erased and reprogrammed.
+ */
+int flash_bench_run(void);
+
+#endif/*!FLASH_BENCH_H_*/
@@ -0,0 +1,107 @@
+#ifndef FLASH_BACKEND_H_
+#define FLASH_BACKEND_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include "libc/regutils.h"
+#include "libc/string.h"
+
+/*
+ * Flash register and memory access backend.
+ *
+ * All the driver accesses to the flash interface registers and to the flash
+ * memory go through these primitives:
+ * - flash_be_read_reg() / flash_be_write_reg() for the control registers
+ * - flash_be_mem_write_{8,16,32,64}() for the program stores
+ * - flash_be_mem_read() for reading the flash content
+ *
+ * By default, the backend is the target memory mapped I/O, statically
+ * inlined so that it costs nothing compared to direct accesses.
+ * When CONFIG_USR_DRV_FLASH_BACKEND_EXTERN is set (host builds), the
+ * primitives are external functions, implemented by the simulator, a fault
+ * injector or an operation recorder.
+ */
+
+#if CONFIG_USR_DRV_FLASH_BACKEND_EXTERN
+
+uint32_t flash_be_read_reg(volatile const uint32_t *reg);
+
+void flash_be_write_reg(volatile uint32_t *reg, uint32_t value);
+
+void flash_be_mem_write_8(physaddr_t addr, uint8_t value);
+
+void flash_be_mem_write_16(physaddr_t addr, uint16_t value);
+
+void flash_be_mem_write_32(physaddr_t addr, uint32_t value);
+
+void flash_be_mem_write_64(physaddr_t addr, uint64_t value);
+
+void flash_be_mem_read(void *dest, physaddr_t addr, uint32_t size);
+
+#else
+
+static inline uint32_t flash_be_read_reg(volatile const uint32_t *reg)
+{
+    return *reg;
+}
+
+static inline void flash_be_write_reg(volatile uint32_t *reg, uint32_t value)
+{
+    *reg = value;
+}
+
+static inline void flash_be_mem_write_8(physaddr_t addr, uint8_t value)
+{
+    *(volatile uint8_t*)addr = value;
+}
+
+static inline void flash_be_mem_write_16(physaddr_t addr, uint16_t value)
+{
+    *(volatile uint16_t*)addr = value;
+}
+
+static inline void flash_be_mem_write_32(physaddr_t addr, uint32_t value)
+{
+    *(volatile uint32_t*)addr = value;
+}
+
+static inline void flash_be_mem_write_64(physaddr_t addr, uint64_t value)
+{
+    *(volatile uint64_t*)addr = value;
+}
+
+static inline void flash_be_mem_read(void *dest, physaddr_t addr, uint32_t size)
+{
+    memcpy(dest, (void*)addr, size);
+}
+
+#endif
+
+/*
+ * register field helpers, equivalent to the libstd set_reg()/get_reg() ones
+ * but built on the backend primitives
+ */
+static inline void flash_be_set_reg_value(volatile uint32_t *reg, uint32_t value,
+                                          uint32_t mask, uint8_t pos)
+{
+    uint32_t tmp;
+
+    tmp = flash_be_read_reg(reg);
+    tmp &= ~mask;
+    tmp |= (value << pos) & mask;
+    flash_be_write_reg(reg, tmp);
+}
+
+static inline uint32_t flash_be_get_reg_value(volatile const uint32_t *reg,
+                                              uint32_t mask, uint8_t pos)
+{
+    return (flash_be_read_reg(reg) & mask) >> pos;
+}
+
+#define flash_set_reg(REG, VALUE, FIELD) \
+    flash_be_set_reg_value(REG, VALUE, FIELD##_Msk, FIELD##_Pos)
+
+#define flash_get_reg(REG, FIELD) \
+    flash_be_get_reg_value(REG, FIELD##_Msk, FIELD##_Pos)
+
+#endif/*!FLASH_BACKEND_H_*/
@@ -0,0 +1,129 @@
+/** @file flash_digest.c
+ * \brief Per-sector digest cache, invalidated on erase and program
+ */
+
+#include "autoconf.h"
+
+#if CONFIG_USR_DRV_FLASH_DIGEST
+
+#include "api/libflash.h"
+#include "api/flash_digest.h"
+#include "libc/stdio.h"
+#include "libc/string.h"
+#include "flash_hooks.h"
+
+#define FLASH_DIGEST_DEBUG 0
+
+/* Primitive for debug output */
+#if FLASH_DIGEST_DEBUG
+#define log_printf(...) printf(__VA_ARGS__)
+#else
+#define log_printf(...)
+#endif
+
+static const t_flash_hash_alg *digest_alg = NULL;
+static uint8_t digest_cache[FLASH_DIGEST_NB_SECTORS][FLASH_HASH_MAX_DIGEST];
+/* sectors whose cached digest is up to date */
+static uint32_t digest_valid = 0;
+
+static inline bool flash_digest_is_valid(uint8_t sector)
+{
+    return sector < FLASH_DIGEST_NB_SECTORS && flash_sector_size(sector) != 0;
+}
+
+t_flash_err flash_digest_init(const t_flash_hash_alg *alg)
+{
+    if (alg == NULL || alg->digest_size > FLASH_HASH_MAX_DIGEST) {
+        return FLASH_ERR_INVAL;
+    }
+    digest_alg = alg;
+    digest_valid = 0;
+    return FLASH_ERR_NONE;
+}
+
+/* cached digest of a sector, hashed again if dirty */
+static t_flash_err digest_get(uint8_t sector, const uint8_t **digest)
+{
+    t_flash_hash_ctx ctx;
+    t_flash_err err;
+
+    if (!(digest_valid & (1u << sector))) {
+        log_printf("digest: hashing sector %d\n", sector);
+        flash_hash_init(&ctx, digest_alg);
+        err = flash_hash_region(&ctx, flash_sector_addr(sector), flash_sector_size(sector));
+        if (err != FLASH_ERR_NONE) {
+            return err;
+        }
+        flash_hash_final(&ctx, digest_cache[sector]);
+        digest_valid |= 1u << sector;
+    }
+    *digest = digest_cache[sector];
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_digest_sector(uint8_t sector, uint8_t *digest)
+{
+    const uint8_t *cached;
+    t_flash_err err;
+
+    if (digest_alg == NULL || digest == NULL || !flash_digest_is_valid(sector)) {
+        return FLASH_ERR_INVAL;
+    }
+    if ((err = digest_get(sector, &cached)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    memcpy(digest, cached, digest_alg->digest_size);
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_digest_region(uint8_t first, uint8_t nb, uint8_t *digest)
+{
+    t_flash_hash_ctx ctx;
+    const uint8_t *cached;
+    t_flash_err err;
+
+    if (digest_alg == NULL || digest == NULL || nb == 0) {
+        return FLASH_ERR_INVAL;
+    }
+    for (uint8_t sector = first; sector < first + nb; ++sector) {
+        if (!flash_digest_is_valid(sector)) {
+            return FLASH_ERR_INVAL;
+        }
+    }
+    flash_hash_init(&ctx, digest_alg);
+    for (uint8_t sector = first; sector < first + nb; ++sector) {
+        if ((err = digest_get(sector, &cached)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        flash_hash_update(&ctx, cached, digest_alg->digest_size);
+    }
+    flash_hash_final(&ctx, digest);
+    return FLASH_ERR_NONE;
+}
+
+void flash_digest_invalidate(uint8_t sector)
+{
+    if (sector < FLASH_DIGEST_NB_SECTORS) {
+        digest_valid &= ~(1u << sector);
+    }
+}
+
+void flash_digest_sector_erase(uint8_t sector)
+{
+    flash_digest_invalidate(sector);
+}
+
+void flash_digest_bank_erase(uint8_t bank)
+{
+    digest_valid &= bank ? 0x00000fff : 0x00fff000;
+}
+
+void flash_digest_program(physaddr_t addr, uint32_t size)
+{
+    if (digest_valid == 0 || size == 0) {
+        return;
+    }
+    digest_valid &= ~flash_range_sectors(addr, size);
+}
+
+#endif
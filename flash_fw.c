@@ -0,0 +1,597 @@
+/** @file flash_fw.c
+ * \brief Flip/flop firmware image update
+ */
+
+#include "autoconf.h"
+
+#if CONFIG_USR_DRV_FLASH_FW
+
+#include "api/libflash.h"
+#include "api/flash_fw.h"
+#include "api/flash_hash.h"
+#include "libc/stdio.h"
+#include "libc/string.h"
+
+#if !CONFIG_USR_DRV_FLASH_2M
+# error "the flip/flop firmware layout requires a 2MB dual bank flash"
+#endif
+
+#define FLASH_FW_DEBUG 0
+
+/* Primitive for debug output */
+#if FLASH_FW_DEBUG
+#define log_printf(...) printf(__VA_ARGS__)
+#else
+#define log_printf(...)
+#endif
+
+typedef struct {
+    physaddr_t shr;     /* shared area, holding the firmware header */
+    physaddr_t img;     /* firmware image */
+    uint32_t img_size;
+} t_flash_fw_layout;
+
+static const t_flash_fw_layout fw_layout[2] = {
+    { FLASH_SECTOR_2,  FLASH_SECTOR_4,  FLASH_SECTOR_11_END - FLASH_SECTOR_4 + 1 },
+    { FLASH_SECTOR_14, FLASH_SECTOR_16, FLASH_SECTOR_23_END - FLASH_SECTOR_16 + 1 },
+};
+
+/* the header ends with hdr_crc and magic */
+#define FW_HDR_CRC_LEN          (sizeof(t_flash_fw_header) - 8)
+#define FW_HDR_MAGIC_OFF        (sizeof(t_flash_fw_header) - 4)
+
+/*
+ * Header words programmed when the update starts (version, size and counter)
+ * and when it completes (crc32, hdr_crc, then magic).
+ */
+#define FW_HDR_WORD_CRC32       2
+#define FW_HDR_WORD_HDR_CRC     4
+
+/*
+ * Progress checkpoints, appended after the header in the target bank
+ * shared area while streaming:
+ * - word 0: image offset, up to which the image is programmed
+ * - word 1: CRC-32 of the image up to this offset
+ * - word 2: complemented offset
+ * - word 3: FLASH_FW_CKPT_TAG, programmed last
+ * A checkpoint is written every CONFIG_USR_DRV_FLASH_FW_CKPT_INTERVAL
+ * bytes and before each image sector erase, so that the start of the
+ * sector being written always has a checkpoint.
+ */
+#define FLASH_FW_CKPT_TAG       0x46574350
+#define FW_CKPT_AREA            0x100
+#define FW_CKPT_SIZE            16
+
+typedef struct {
+    uint32_t offset;
+    uint32_t crc;
+    uint32_t noffset;
+    uint32_t tag;
+} t_flash_fw_ckpt;
+
+/* current update state */
+static bool fw_active = false;
+static t_flash_fw_bank fw_target;
+static t_flash_fw_header fw_hdr;
+static uint32_t fw_written = 0;
+static uint32_t fw_crc = 0;
+/*
+ * digests of the image read back from flash, just after each chunk is
+ * programmed: CRC-32, and the optional flash_fw_set_hash() one
+ */
+static uint32_t fw_rb_crc = 0;
+static t_flash_hash_ctx fw_hash;
+static bool fw_hash_on = false;
+static uint8_t fw_digest[FLASH_HASH_MAX_DIGEST];
+static uint8_t fw_digest_size = 0;
+/*
+ * end of the prepared (erased or skipped) part of the target image area
+ * (image offset), and whether the current sector is skipped
+ */
+static uint32_t fw_erased_end = 0;
+static bool fw_skip = false;
+/* optional per-sector image CRCs, and number of skipped sectors */
+static const uint32_t *fw_manifest = NULL;
+static uint32_t fw_manifest_len = 0;
+static uint32_t fw_nb_skipped = 0;
+/* last checkpoint offset, and next free checkpoint slot */
+static uint32_t fw_ckpt_last = 0;
+static uint32_t fw_ckpt_next = 0;
+
+static inline physaddr_t fw_img_addr(uint32_t off)
+{
+    return fw_layout[fw_target].img + off;
+}
+
+static inline physaddr_t fw_ckpt_addr(uint32_t slot)
+{
+    return fw_layout[fw_target].shr + FW_CKPT_AREA + slot * FW_CKPT_SIZE;
+}
+
+static inline uint32_t fw_ckpt_nb_slots(void)
+{
+    return (flash_sector_size(flash_select_sector(fw_layout[fw_target].shr)) -
+            FW_CKPT_AREA) / FW_CKPT_SIZE;
+}
+
+static inline uint32_t fw_header_crc(const t_flash_fw_header *hdr)
+{
+    return flash_crc32(0, (const uint8_t*)hdr, FW_HDR_CRC_LEN);
+}
+
+static bool fw_read_header(t_flash_fw_bank bank, t_flash_fw_header *hdr)
+{
+    if (flash_read((uint8_t*)hdr, fw_layout[bank].shr, sizeof(*hdr)) != FLASH_ERR_NONE) {
+        return false;
+    }
+    return hdr->magic == FLASH_FW_MAGIC &&
+           hdr->hdr_crc == fw_header_crc(hdr) &&
+           hdr->size <= fw_layout[bank].img_size;
+}
+
+static t_flash_err fw_write_hdr_word(uint8_t word, uint32_t value)
+{
+    return flash_write(fw_layout[fw_target].shr + 4 * word, (uint8_t*)&value,
+                       sizeof(value));
+}
+
+t_flash_err flash_fw_get_active(t_flash_fw_bank *bank, t_flash_fw_header *hdr)
+{
+    t_flash_fw_header flip, flop;
+    bool flip_ok, flop_ok;
+
+    if (bank == NULL) {
+        return FLASH_ERR_INVAL;
+    }
+    flip_ok = fw_read_header(FLASH_FW_FLIP, &flip);
+    flop_ok = fw_read_header(FLASH_FW_FLOP, &flop);
+    if (flop_ok && (!flip_ok || flop.counter > flip.counter)) {
+        *bank = FLASH_FW_FLOP;
+        if (hdr != NULL) {
+            *hdr = flop;
+        }
+        return FLASH_ERR_NONE;
+    }
+    *bank = FLASH_FW_FLIP;
+    if (!flip_ok) {
+        return FLASH_ERR_NOENT;
+    }
+    if (hdr != NULL) {
+        *hdr = flip;
+    }
+    return FLASH_ERR_NONE;
+}
+
+physaddr_t flash_fw_get_image(t_flash_fw_bank bank)
+{
+    return fw_layout[bank == FLASH_FW_FLOP ? FLASH_FW_FLOP : FLASH_FW_FLIP].img;
+}
+
+t_flash_fw_bank flash_fw_get_target(void)
+{
+    return fw_target;
+}
+
+/* select the target bank, and the counter of its header */
+static t_flash_err fw_select_target(uint32_t *counter)
+{
+    t_flash_fw_bank active;
+    t_flash_fw_header hdr;
+    t_flash_err err;
+
+    err = flash_fw_get_active(&active, &hdr);
+    if (err == FLASH_ERR_NOENT) {
+        hdr.counter = 0;
+    } else if (err != FLASH_ERR_NONE) {
+        return err;
+    }
+    fw_target = (active == FLASH_FW_FLIP) ? FLASH_FW_FLOP : FLASH_FW_FLIP;
+    *counter = hdr.counter + 1;
+    return FLASH_ERR_NONE;
+}
+
+static bool fw_is_blank(physaddr_t addr, uint32_t size)
+{
+    uint32_t buf[16];
+    uint32_t chunk;
+
+    while (size > 0) {
+        chunk = size < sizeof(buf) ? size : sizeof(buf);
+        if (flash_read((uint8_t*)buf, addr, chunk) != FLASH_ERR_NONE) {
+            return false;
+        }
+        for (uint32_t i = 0; i < chunk; ++i) {
+            if (((uint8_t*)buf)[i] != 0xff) {
+                return false;
+            }
+        }
+        addr += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+/* update crc with the image content of [from, to[ */
+static t_flash_err fw_crc_range(uint32_t *crc, uint32_t from, uint32_t to)
+{
+    uint8_t buf[64];
+    uint32_t chunk;
+    t_flash_err err;
+
+    for (; from < to; from += chunk) {
+        chunk = (to - from) < sizeof(buf) ? (to - from) : sizeof(buf);
+        if ((err = flash_read(buf, fw_img_addr(from), chunk)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        *crc = flash_crc32(*crc, buf, chunk);
+    }
+    return FLASH_ERR_NONE;
+}
+
+/* compare the flash content at the given image offset with data */
+static bool fw_is_same(uint32_t off, const uint8_t *data, uint32_t size)
+{
+    uint8_t buf[64];
+    uint32_t chunk;
+
+    for (; size > 0; off += chunk, data += chunk, size -= chunk) {
+        chunk = size < sizeof(buf) ? size : sizeof(buf);
+        if (flash_read(buf, fw_img_addr(off), chunk) != FLASH_ERR_NONE ||
+            memcmp(buf, data, chunk) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* read back a programmed chunk, for the image digests */
+static t_flash_err fw_readback(uint32_t off, uint32_t size)
+{
+    uint8_t buf[64];
+    uint32_t chunk;
+    t_flash_err err;
+
+    for (; size > 0; off += chunk, size -= chunk) {
+        chunk = size < sizeof(buf) ? size : sizeof(buf);
+        if ((err = flash_read(buf, fw_img_addr(off), chunk)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        fw_rb_crc = flash_crc32(fw_rb_crc, buf, chunk);
+        if (fw_hash_on) {
+            flash_hash_update(&fw_hash, buf, chunk);
+        }
+    }
+    return FLASH_ERR_NONE;
+}
+
+static t_flash_err fw_checkpoint(void)
+{
+    t_flash_fw_ckpt ckpt = { fw_written, fw_crc, ~fw_written, 0xffffffff };
+    t_flash_err err;
+
+    if (fw_written == fw_ckpt_last) {
+        return FLASH_ERR_NONE;
+    }
+    if (fw_ckpt_next >= fw_ckpt_nb_slots()) {
+        /* out of slots: a resumed update restarts from the last one */
+        return FLASH_ERR_NONE;
+    }
+    /* the slot is consumed, even if partially written */
+    err = flash_write(fw_ckpt_addr(fw_ckpt_next++), (uint8_t*)&ckpt, FW_CKPT_SIZE - 4);
+    if (err == FLASH_ERR_NONE) {
+        ckpt.tag = FLASH_FW_CKPT_TAG;
+        err = flash_write(fw_ckpt_addr(fw_ckpt_next - 1) + FW_CKPT_SIZE - 4,
+                          (uint8_t*)&ckpt.tag, 4);
+    }
+    if (err == FLASH_ERR_NONE) {
+        fw_ckpt_last = fw_written;
+    }
+    return err;
+}
+
+/*
+ * Prepare the next image sector, once the previous ones are checkpointed.
+ * The sector is kept as is when its content is already the expected one,
+ * either given by the manifest, or by the data chunk when it covers the
+ * whole sector. Otherwise, it is erased.
+ */
+static t_flash_err fw_next_sector(const uint8_t *data, uint32_t len)
+{
+    physaddr_t addr = fw_img_addr(fw_erased_end);
+    uint8_t sector = flash_select_sector(addr);
+    uint8_t idx = sector - flash_select_sector(fw_layout[fw_target].img);
+    uint32_t sector_size = flash_sector_size(sector);
+    uint32_t end, crc = 0;
+    t_flash_err err;
+
+    if ((err = fw_checkpoint()) != FLASH_ERR_NONE) {
+        return err;
+    }
+    /* image part held by the sector */
+    end = (fw_hdr.size - fw_erased_end) < sector_size ? (fw_hdr.size - fw_erased_end) : sector_size;
+    fw_skip = false;
+    if (fw_manifest != NULL && idx < fw_manifest_len) {
+        if ((err = fw_crc_range(&crc, fw_erased_end, fw_erased_end + end)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        fw_skip = crc == fw_manifest[idx];
+    } else if (len >= end) {
+        fw_skip = fw_is_same(fw_erased_end, data, end);
+    }
+    if (fw_skip) {
+        log_printf("fw: sector %d unchanged\n", sector);
+        fw_nb_skipped++;
+    } else {
+        log_printf("fw: erasing sector %d\n", sector);
+        if (flash_sector_erase(addr) == 0xff) {
+            return flash_get_last_error();
+        }
+    }
+    fw_erased_end += sector_size;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_fw_begin(uint32_t size, uint32_t version)
+{
+    uint32_t counter;
+    t_flash_err err;
+
+    fw_active = false;
+    if ((err = fw_select_target(&counter)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    if (size == 0 || size > fw_layout[fw_target].img_size) {
+        return FLASH_ERR_INVAL;
+    }
+    /* invalidate the target bank header and checkpoints */
+    if (flash_sector_erase(fw_layout[fw_target].shr) == 0xff) {
+        return flash_get_last_error();
+    }
+    memset(&fw_hdr, 0xff, sizeof(fw_hdr));
+    fw_hdr.version = version;
+    fw_hdr.size = size;
+    fw_hdr.counter = counter;
+    err = flash_write(fw_layout[fw_target].shr, (uint8_t*)&fw_hdr, FW_HDR_CRC_LEN);
+    if (err != FLASH_ERR_NONE) {
+        return err;
+    }
+    fw_written = 0;
+    fw_crc = 0;
+    fw_rb_crc = 0;
+    fw_hash_on = false;
+    fw_digest_size = 0;
+    fw_erased_end = 0;
+    fw_skip = false;
+    fw_manifest = NULL;
+    fw_nb_skipped = 0;
+    fw_ckpt_last = 0;
+    fw_ckpt_next = 0;
+    fw_active = true;
+    log_printf("fw: updating bank %d, %d bytes\n", fw_target, size);
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_fw_resume(uint32_t size, uint32_t version, uint32_t *offset)
+{
+    t_flash_fw_header hdr;
+    t_flash_fw_ckpt ckpt;
+    uint32_t counter;
+    uint32_t sector_start, sector_end;
+    /* last checkpoint, and last one at the start of its sector */
+    uint32_t last = 0, last_crc = 0;
+    uint32_t base = 0, base_crc = 0;
+    uint32_t slot, crc;
+    uint8_t sector;
+    t_flash_err err;
+
+    fw_active = false;
+    if (offset == NULL) {
+        return FLASH_ERR_INVAL;
+    }
+    if ((err = fw_select_target(&counter)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    /*
+     * An update of the same image must have been started, not completed.
+     * The magic may be partially programmed, by a power loss at the very
+     * end of flash_fw_finish(): it is programmed again.
+     */
+    if ((err = flash_read((uint8_t*)&hdr, fw_layout[fw_target].shr, sizeof(hdr))) != FLASH_ERR_NONE) {
+        return err;
+    }
+    if (hdr.version != version || hdr.size != size || hdr.counter != counter ||
+        size == 0 || size > fw_layout[fw_target].img_size ||
+        (hdr.magic & FLASH_FW_MAGIC) != FLASH_FW_MAGIC) {
+        return FLASH_ERR_NOENT;
+    }
+    /*
+     * Checkpoints are in chronological order (offsets decrease when a
+     * sector is rewritten): the last one gives the resume point, the last
+     * one at a sector start gives the start of the sector being written.
+     */
+    for (slot = 0; slot < fw_ckpt_nb_slots(); ++slot) {
+        if ((err = flash_read((uint8_t*)&ckpt, fw_ckpt_addr(slot), sizeof(ckpt))) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (ckpt.offset == 0xffffffff && ckpt.crc == 0xffffffff &&
+            ckpt.noffset == 0xffffffff && ckpt.tag == 0xffffffff) {
+            break;
+        }
+        if (ckpt.tag != FLASH_FW_CKPT_TAG || ckpt.offset != ~ckpt.noffset ||
+            ckpt.offset > size) {
+            /* interrupted checkpoint */
+            continue;
+        }
+        last = ckpt.offset;
+        last_crc = ckpt.crc;
+        sector = flash_select_sector(fw_img_addr(last));
+        if (last < size && fw_img_addr(last) == flash_sector_addr(sector)) {
+            base = last;
+            base_crc = last_crc;
+        }
+    }
+    fw_ckpt_next = slot;
+    fw_hdr = hdr;
+    fw_skip = false;
+    fw_manifest = NULL;
+    fw_nb_skipped = 0;
+    fw_written = last;
+    fw_crc = last_crc;
+    fw_ckpt_last = last;
+    if (last < size) {
+        /*
+         * Only the sector being written is checked, against the checkpoint
+         * CRC. Past the last checkpoint, the sector may hold a part of the
+         * image programmed before the interruption: the same data is
+         * programmed again over it, which leaves the programmed bits
+         * unchanged. A sector whose erase may have been interrupted (no
+         * checkpoint after its start) must be blank.
+         */
+        sector = flash_select_sector(fw_img_addr(last));
+        sector_start = flash_sector_addr(sector) - fw_layout[fw_target].img;
+        sector_end = sector_start + flash_sector_size(sector);
+        if (base != sector_start) {
+            /* no checkpoint at the sector start, restart from scratch */
+            return FLASH_ERR_NOENT;
+        }
+        crc = base_crc;
+        if ((err = fw_crc_range(&crc, base, last)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (crc != last_crc ||
+            (last == base && !fw_is_blank(fw_img_addr(base), sector_end - base))) {
+            /* rewrite the sector, erased again by the next write */
+            log_printf("fw: rewriting sector %d\n", sector);
+            fw_written = base;
+            fw_crc = base_crc;
+            fw_erased_end = base;
+        } else {
+            fw_erased_end = sector_end;
+        }
+    } else {
+        fw_erased_end = last;
+    }
+    /* the programmed part is checked against the checkpoint CRC */
+    fw_rb_crc = fw_crc;
+    fw_hash_on = false;
+    fw_digest_size = 0;
+    fw_active = true;
+    *offset = fw_written;
+    log_printf("fw: resuming bank %d update at %x\n", fw_target, fw_written);
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_fw_write(const uint8_t *data, uint32_t len)
+{
+    uint32_t chunk;
+    t_flash_err err;
+
+    if (!fw_active || data == NULL || len > fw_hdr.size - fw_written) {
+        return FLASH_ERR_INVAL;
+    }
+    while (len > 0) {
+        if (fw_written == fw_erased_end &&
+            (err = fw_next_sector(data, len)) != FLASH_ERR_NONE) {
+            goto err;
+        }
+        chunk = (fw_erased_end - fw_written) < len ? (fw_erased_end - fw_written) : len;
+        if (!fw_skip) {
+            err = flash_write(fw_img_addr(fw_written), data, chunk);
+            if (err != FLASH_ERR_NONE) {
+                goto err;
+            }
+        }
+        fw_crc = flash_crc32(fw_crc, data, chunk);
+        if ((err = fw_readback(fw_written, chunk)) != FLASH_ERR_NONE) {
+            goto err;
+        }
+        fw_written += chunk;
+        data += chunk;
+        len -= chunk;
+        if (fw_written - fw_ckpt_last >= CONFIG_USR_DRV_FLASH_FW_CKPT_INTERVAL &&
+            (err = fw_checkpoint()) != FLASH_ERR_NONE) {
+            goto err;
+        }
+    }
+    return FLASH_ERR_NONE;
+err:
+    /* the update must be resumed */
+    fw_active = false;
+    return err;
+}
+
+t_flash_err flash_fw_set_manifest(const uint32_t *sector_crc, uint32_t nb)
+{
+    if (!fw_active || (sector_crc == NULL && nb != 0)) {
+        return FLASH_ERR_INVAL;
+    }
+    fw_manifest = sector_crc;
+    fw_manifest_len = nb;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_fw_set_hash(const t_flash_hash_alg *alg)
+{
+    t_flash_err err;
+
+    if (!fw_active || alg == NULL || alg->digest_size > FLASH_HASH_MAX_DIGEST) {
+        return FLASH_ERR_INVAL;
+    }
+    flash_hash_init(&fw_hash, alg);
+    /* part already programmed by a resumed update */
+    if ((err = flash_hash_region(&fw_hash, fw_img_addr(0), fw_written)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    fw_hash_on = true;
+    return FLASH_ERR_NONE;
+}
+
+uint8_t flash_fw_get_digest(uint8_t *digest)
+{
+    if (digest == NULL) {
+        return 0;
+    }
+    memcpy(digest, fw_digest, fw_digest_size);
+    return fw_digest_size;
+}
+
+uint32_t flash_fw_get_skipped(void)
+{
+    return fw_nb_skipped;
+}
+
+t_flash_err flash_fw_finish(uint32_t crc32)
+{
+    uint32_t magic = FLASH_FW_MAGIC;
+    t_flash_err err;
+
+    if (!fw_active || fw_written != fw_hdr.size) {
+        return FLASH_ERR_INVAL;
+    }
+    fw_active = false;
+    if (fw_crc != crc32) {
+        log_printf("fw: streamed image CRC mismatch\n");
+        return FLASH_ERR_VERIFY;
+    }
+    /* the programmed image, read back while streaming */
+    if (fw_rb_crc != crc32) {
+        log_printf("fw: programmed image CRC mismatch\n");
+        return FLASH_ERR_VERIFY;
+    }
+    if (fw_hash_on) {
+        flash_hash_final(&fw_hash, fw_digest);
+        fw_digest_size = fw_hash.alg->digest_size;
+        fw_hash_on = false;
+    }
+    fw_hdr.crc32 = crc32;
+    fw_hdr.hdr_crc = fw_header_crc(&fw_hdr);
+    if ((err = fw_write_hdr_word(FW_HDR_WORD_CRC32, fw_hdr.crc32)) != FLASH_ERR_NONE ||
+        (err = fw_write_hdr_word(FW_HDR_WORD_HDR_CRC, fw_hdr.hdr_crc)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    /* switch point: the target bank becomes the active one */
+    return flash_write(fw_layout[fw_target].shr + FW_HDR_MAGIC_OFF,
+                       (uint8_t*)&magic, sizeof(magic));
+}
+
+#endif
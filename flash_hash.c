@@ -0,0 +1,286 @@
+/** @file flash_hash.c
+ * \brief Digest primitives for the flash content integrity checks
+ */
+
+#include "autoconf.h"
+#include "api/libflash.h"
+#include "api/flash_hash.h"
+#include "libc/string.h"
+
+/* CRC-32 lookup table, reflected polynomial 0xEDB88320 */
+static const uint32_t crc32_table[256] = {
+    0x00000000, 0x77073096, 0xee0e612c, 0x990951ba,
+    0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
+    0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
+    0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
+    0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de,
+    0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
+    0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec,
+    0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
+    0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
+    0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
+    0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940,
+    0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
+    0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116,
+    0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
+    0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
+    0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
+    0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a,
+    0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
+    0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818,
+    0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
+    0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
+    0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
+    0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c,
+    0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
+    0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2,
+    0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
+    0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
+    0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
+    0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086,
+    0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+    0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4,
+    0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
+    0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
+    0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
+    0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8,
+    0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
+    0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe,
+    0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
+    0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
+    0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
+    0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252,
+    0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
+    0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60,
+    0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
+    0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
+    0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
+    0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04,
+    0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
+    0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a,
+    0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
+    0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
+    0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
+    0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e,
+    0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
+    0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c,
+    0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
+    0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
+    0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
+    0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0,
+    0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+    0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6,
+    0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
+    0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
+    0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d,
+};
+
+uint32_t flash_crc32(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc = crc32_table[(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/*
+ * CRC-32 hash algorithm
+ */
+
+static void hash_crc32_init(t_flash_hash_ctx *ctx)
+{
+    ctx->u.crc = 0;
+}
+
+static void hash_crc32_update(t_flash_hash_ctx *ctx, const uint8_t *buf, uint32_t len)
+{
+    ctx->u.crc = flash_crc32(ctx->u.crc, buf, len);
+}
+
+static void hash_crc32_final(t_flash_hash_ctx *ctx, uint8_t *digest)
+{
+    for (uint8_t i = 0; i < 4; ++i) {
+        digest[i] = (uint8_t)(ctx->u.crc >> (8 * i));
+    }
+}
+
+const t_flash_hash_alg flash_hash_crc32 = {
+    .digest_size = 4,
+    .init = hash_crc32_init,
+    .update = hash_crc32_update,
+    .final = hash_crc32_final,
+};
+
+/*
+ * SHA-256 hash algorithm (FIPS 180-4)
+ */
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROTR(x, n)              (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_block(t_flash_sha256_ctx *sha, const uint8_t *block)
+{
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, h, t1, t2;
+    uint8_t i;
+
+    for (i = 0; i < 16; ++i) {
+        w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) |
+               ((uint32_t)block[4 * i + 2] << 8) | (uint32_t)block[4 * i + 3];
+    }
+    for (i = 16; i < 64; ++i) {
+        w[i] = w[i - 16] + w[i - 7] +
+               (ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3)) +
+               (ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10));
+    }
+    a = sha->state[0];
+    b = sha->state[1];
+    c = sha->state[2];
+    d = sha->state[3];
+    e = sha->state[4];
+    f = sha->state[5];
+    g = sha->state[6];
+    h = sha->state[7];
+    for (i = 0; i < 64; ++i) {
+        t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) +
+             sha256_k[i] + w[i];
+        t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    sha->state[0] += a;
+    sha->state[1] += b;
+    sha->state[2] += c;
+    sha->state[3] += d;
+    sha->state[4] += e;
+    sha->state[5] += f;
+    sha->state[6] += g;
+    sha->state[7] += h;
+}
+
+static void hash_sha256_init(t_flash_hash_ctx *ctx)
+{
+    static const uint32_t iv[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    memcpy(ctx->u.sha256.state, iv, sizeof(iv));
+    ctx->u.sha256.len_lo = 0;
+    ctx->u.sha256.len_hi = 0;
+}
+
+static void hash_sha256_update(t_flash_hash_ctx *ctx, const uint8_t *buf, uint32_t len)
+{
+    t_flash_sha256_ctx *sha = &ctx->u.sha256;
+    uint32_t fill = sha->len_lo & 63;
+    uint32_t chunk;
+
+    if (sha->len_lo + len < sha->len_lo) {
+        sha->len_hi++;
+    }
+    sha->len_lo += len;
+    while (len > 0) {
+        if (fill == 0 && len >= 64) {
+            sha256_block(sha, buf);
+            chunk = 64;
+        } else {
+            chunk = (64 - fill) < len ? (64 - fill) : len;
+            memcpy(&sha->block[fill], buf, chunk);
+            fill += chunk;
+            if (fill == 64) {
+                sha256_block(sha, sha->block);
+                fill = 0;
+            }
+        }
+        buf += chunk;
+        len -= chunk;
+    }
+}
+
+static void hash_sha256_final(t_flash_hash_ctx *ctx, uint8_t *digest)
+{
+    t_flash_sha256_ctx *sha = &ctx->u.sha256;
+    uint32_t fill = sha->len_lo & 63;
+    uint32_t bits_hi = (sha->len_hi << 3) | (sha->len_lo >> 29);
+    uint32_t bits_lo = sha->len_lo << 3;
+    uint8_t i;
+
+    sha->block[fill++] = 0x80;
+    if (fill > 56) {
+        memset(&sha->block[fill], 0, 64 - fill);
+        sha256_block(sha, sha->block);
+        fill = 0;
+    }
+    memset(&sha->block[fill], 0, 56 - fill);
+    for (i = 0; i < 4; ++i) {
+        sha->block[56 + i] = (uint8_t)(bits_hi >> (24 - 8 * i));
+        sha->block[60 + i] = (uint8_t)(bits_lo >> (24 - 8 * i));
+    }
+    sha256_block(sha, sha->block);
+    for (i = 0; i < 32; ++i) {
+        digest[i] = (uint8_t)(sha->state[i / 4] >> (24 - 8 * (i % 4)));
+    }
+}
+
+const t_flash_hash_alg flash_hash_sha256 = {
+    .digest_size = 32,
+    .init = hash_sha256_init,
+    .update = hash_sha256_update,
+    .final = hash_sha256_final,
+};
+
+/*
+ * Generic API
+ */
+
+void flash_hash_init(t_flash_hash_ctx *ctx, const t_flash_hash_alg *alg)
+{
+    ctx->alg = alg;
+    alg->init(ctx);
+}
+
+void flash_hash_update(t_flash_hash_ctx *ctx, const uint8_t *buf, uint32_t len)
+{
+    ctx->alg->update(ctx, buf, len);
+}
+
+void flash_hash_final(t_flash_hash_ctx *ctx, uint8_t *digest)
+{
+    ctx->alg->final(ctx, digest);
+}
+
+t_flash_err flash_hash_region(t_flash_hash_ctx *ctx, physaddr_t addr, uint32_t size)
+{
+    uint8_t buf[64];
+    uint32_t chunk;
+    t_flash_err err;
+
+    while (size > 0) {
+        chunk = size < sizeof(buf) ? size : sizeof(buf);
+        if ((err = flash_read(buf, addr, chunk)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        ctx->alg->update(ctx, buf, chunk);
+        addr += chunk;
+        size -= chunk;
+    }
+    return FLASH_ERR_NONE;
+}
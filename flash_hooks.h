@@ -0,0 +1,85 @@
+#ifndef FLASH_HOOKS_H_
+#define FLASH_HOOKS_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+
+/*
+ * Driver internal notifications of the flash content changes, for the
+ * optional modules keeping state about the flash sectors. Dispatch is
+ * resolved at compile time: with no optional module enabled, these hooks
+ * are empty.
+ */
+
+#if CONFIG_USR_DRV_FLASH_WEAR
+void flash_wear_sector_erased(uint8_t sector);
+void flash_wear_bank_erased(uint8_t bank);
+#endif
+
+#if CONFIG_USR_DRV_FLASH_DIGEST
+void flash_digest_sector_erase(uint8_t sector);
+void flash_digest_bank_erase(uint8_t bank);
+void flash_digest_program(physaddr_t addr, uint32_t size);
+#endif
+
+#if CONFIG_USR_DRV_FLASH_MERKLE
+void flash_merkle_sector_erase(uint8_t sector);
+void flash_merkle_bank_erase(uint8_t bank);
+void flash_merkle_program(physaddr_t addr, uint32_t size);
+#endif
+
+/*
+ * a sector (0-23, bank 2 sectors being 12-23) is about to be erased. Called
+ * before the erase is started: a failed or interrupted erase may already
+ * have modified the sector.
+ */
+static inline void flash_hook_sector_erase(uint8_t sector __attribute__((unused)))
+{
+#if CONFIG_USR_DRV_FLASH_DIGEST
+    flash_digest_sector_erase(sector);
+#endif
+#if CONFIG_USR_DRV_FLASH_MERKLE
+    flash_merkle_sector_erase(sector);
+#endif
+}
+
+/* a sector has been successfully erased */
+static inline void flash_hook_sector_erased(uint8_t sector __attribute__((unused)))
+{
+#if CONFIG_USR_DRV_FLASH_WEAR
+    flash_wear_sector_erased(sector);
+#endif
+}
+
+/* a whole bank (0 or 1) is about to be erased */
+static inline void flash_hook_bank_erase(uint8_t bank __attribute__((unused)))
+{
+#if CONFIG_USR_DRV_FLASH_DIGEST
+    flash_digest_bank_erase(bank);
+#endif
+#if CONFIG_USR_DRV_FLASH_MERKLE
+    flash_merkle_bank_erase(bank);
+#endif
+}
+
+/* a whole bank has been successfully erased */
+static inline void flash_hook_bank_erased(uint8_t bank __attribute__((unused)))
+{
+#if CONFIG_USR_DRV_FLASH_WEAR
+    flash_wear_bank_erased(bank);
+#endif
+}
+
+/* the range [addr, addr + size[ is about to be programmed */
+static inline void flash_hook_program(physaddr_t addr __attribute__((unused)),
+                                      uint32_t size __attribute__((unused)))
+{
+#if CONFIG_USR_DRV_FLASH_DIGEST
+    flash_digest_program(addr, size);
+#endif
+#if CONFIG_USR_DRV_FLASH_MERKLE
+    flash_merkle_program(addr, size);
+#endif
+}
+
+#endif/*!FLASH_HOOKS_H_*/
@@ -0,0 +1,504 @@
+/** @file flash_kv.c
+ * \brief Log-structured key/value store (EEPROM emulation)
+ */
+
+#include "autoconf.h"
+
+#if CONFIG_USR_DRV_FLASH_KV
+
+#include "api/libflash.h"
+#include "api/flash_kv.h"
+#include "api/flash_hash.h"
+#include "libc/stdio.h"
+#include "libc/string.h"
+
+#define FLASH_KV_DEBUG 0
+
+/* Primitive for debug output */
+#if FLASH_KV_DEBUG
+#define log_printf(...) printf(__VA_ARGS__)
+#else
+#define log_printf(...)
+#endif
+
+/*
+ * Sector layout:
+ * - header: magic, sequence number, complemented sequence number. The
+ *   magic is programmed last, the sector is part of the store only once
+ *   its header is complete. The newest sector has the highest sequence.
+ * - records, word aligned, up to the end of the sector
+ *
+ * Record layout:
+ * - header word: key (bits 0-15), value length (bits 16-23), complemented
+ *   value length (bits 24-31). A zero length record deletes the key.
+ * - CRC-32 of the header word and of the value
+ * - value, padded with 0xff up to the next word
+ * The value and the CRC are programmed first and the header word last. A
+ * record interrupted by a power loss is detected by its CRC, or by
+ * programmed words after the last record, and closes the sector.
+ *
+ * The live records (the last record of each key), with room for one more
+ * record and for a deletion, always fit in one sector: the valid records of
+ * the oldest sector then always fit in the spare sector, and the collection
+ * always makes room for the next record.
+ */
+#define FLASH_KV_MAGIC          0x4B565332
+#define FLASH_KV_HDR_SIZE       12
+#define FLASH_KV_REC_MAX        KV_REC_SIZE(FLASH_KV_MAX_VALUE)
+
+#define KV_REC_KEY(hdr)         ((hdr) & 0xffff)
+#define KV_REC_LEN(hdr)         (((hdr) >> 16) & 0xff)
+#define KV_REC_SIZE(len)        (8 + (((len) + 3) & ~3u))
+#define KV_REC_IS_VALID(hdr)    ((((hdr) >> 24) ^ KV_REC_LEN(hdr)) == 0xff)
+
+typedef struct {
+    uint8_t num;
+    bool used;      /* holds a valid store header */
+    uint32_t seq;
+} flash_kv_sector_t;
+
+static flash_kv_sector_t kv_sectors[FLASH_KV_MAX_SECTORS];
+static uint8_t kv_nb_sectors = 0;
+static uint32_t kv_sector_size = 0;
+/* head sector (index in kv_sectors) and offset of its next record */
+static uint8_t kv_head = 0;
+static uint32_t kv_head_off = 0;
+/* address of the last record of each key, 0 if not set */
+static physaddr_t kv_index[CONFIG_USR_DRV_FLASH_KV_MAX_KEYS];
+/* total size of the live records */
+static uint32_t kv_live = 0;
+
+static inline physaddr_t kv_addr(uint8_t idx, uint32_t off)
+{
+    return flash_sector_addr(kv_sectors[idx].num) + off;
+}
+
+static inline uint32_t kv_rec_header(uint16_t key, uint8_t len)
+{
+    return key | ((uint32_t)len << 16) | ((uint32_t)(uint8_t)~len << 24);
+}
+
+static uint32_t kv_rec_crc(uint32_t hdr, const uint8_t *value)
+{
+    return flash_crc32(flash_crc32(0, (const uint8_t*)&hdr, 4), value,
+                       KV_REC_LEN(hdr));
+}
+
+/* size of the live record of a key, 0 if not set */
+static t_flash_err kv_live_size(uint16_t key, uint32_t *size)
+{
+    uint32_t hdr;
+    t_flash_err err;
+
+    *size = 0;
+    if (kv_index[key] == 0) {
+        return FLASH_ERR_NONE;
+    }
+    if ((err = flash_read((uint8_t*)&hdr, kv_index[key], 4)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    *size = KV_REC_SIZE(KV_REC_LEN(hdr));
+    return FLASH_ERR_NONE;
+}
+
+static bool kv_is_blank(physaddr_t addr, uint32_t size)
+{
+    uint32_t buf[16];
+    uint32_t chunk;
+
+    while (size > 0) {
+        chunk = size < sizeof(buf) ? size : sizeof(buf);
+        if (flash_read((uint8_t*)buf, addr, chunk) != FLASH_ERR_NONE) {
+            return false;
+        }
+        for (uint32_t i = 0; i < chunk; ++i) {
+            if (((uint8_t*)buf)[i] != 0xff) {
+                return false;
+            }
+        }
+        addr += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+static t_flash_err kv_erase(uint8_t idx)
+{
+    kv_sectors[idx].used = false;
+    if (flash_sector_erase(kv_addr(idx, 0)) == 0xff) {
+        return flash_get_last_error();
+    }
+    return FLASH_ERR_NONE;
+}
+
+static t_flash_err kv_format(uint8_t idx, uint32_t seq)
+{
+    uint32_t hdr[3] = { FLASH_KV_MAGIC, seq, ~seq };
+    t_flash_err err;
+
+    err = flash_write(kv_addr(idx, 4), (uint8_t*)&hdr[1], 8);
+    if (err == FLASH_ERR_NONE) {
+        err = flash_write(kv_addr(idx, 0), (uint8_t*)&hdr[0], 4);
+    }
+    if (err != FLASH_ERR_NONE) {
+        return err;
+    }
+    kv_sectors[idx].used = true;
+    kv_sectors[idx].seq = seq;
+    return FLASH_ERR_NONE;
+}
+
+/* write a record at the head, which must have room for it */
+static t_flash_err kv_write_record(uint32_t hdr, const uint8_t *value)
+{
+    physaddr_t addr = kv_addr(kv_head, kv_head_off);
+    uint8_t len = KV_REC_LEN(hdr);
+    uint8_t tail[4] = { 0xff, 0xff, 0xff, 0xff };
+    uint8_t aligned = len & ~3;
+    uint32_t crc = kv_rec_crc(hdr, value);
+    t_flash_err err;
+
+    /* the record slot is consumed, even if partially written */
+    kv_head_off += KV_REC_SIZE(len);
+    err = flash_write(addr + 8, value, aligned);
+    if (err == FLASH_ERR_NONE && aligned < len) {
+        memcpy(tail, value + aligned, len - aligned);
+        err = flash_write(addr + 8 + aligned, tail, sizeof(tail));
+    }
+    if (err == FLASH_ERR_NONE) {
+        err = flash_write(addr + 4, (uint8_t*)&crc, 4);
+    }
+    if (err == FLASH_ERR_NONE) {
+        err = flash_write(addr, (uint8_t*)&hdr, 4);
+    }
+    if (err != FLASH_ERR_NONE) {
+        return err;
+    }
+    if (KV_REC_KEY(hdr) < CONFIG_USR_DRV_FLASH_KV_MAX_KEYS) {
+        kv_index[KV_REC_KEY(hdr)] = len ? addr : 0;
+    }
+    return FLASH_ERR_NONE;
+}
+
+/* copy a record of another sector at the head */
+static t_flash_err kv_copy_record(physaddr_t src)
+{
+    uint8_t value[FLASH_KV_MAX_VALUE];
+    uint32_t hdr;
+    t_flash_err err;
+
+    if ((err = flash_read((uint8_t*)&hdr, src, 4)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    if (kv_head_off + KV_REC_SIZE(KV_REC_LEN(hdr)) > kv_sector_size) {
+        return FLASH_ERR_NOSPACE;
+    }
+    if ((err = flash_read(value, src + 8, KV_REC_LEN(hdr))) != FLASH_ERR_NONE) {
+        return err;
+    }
+    return kv_write_record(hdr, value);
+}
+
+static inline bool kv_sector_contains(uint8_t idx, physaddr_t addr)
+{
+    physaddr_t start = kv_addr(idx, 0);
+
+    return addr >= start && addr < start + kv_sector_size;
+}
+
+static uint8_t kv_oldest(void)
+{
+    uint8_t oldest = kv_head;
+
+    for (uint8_t i = 0; i < kv_nb_sectors; ++i) {
+        if (kv_sectors[i].used && kv_sectors[i].seq < kv_sectors[oldest].seq) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+/*
+ * When no spare sector is left, move the valid records of the oldest
+ * sector to the head, and erase it.
+ */
+static t_flash_err kv_collect(void)
+{
+    uint8_t oldest;
+    t_flash_err err;
+
+    for (uint8_t i = 0; i < kv_nb_sectors; ++i) {
+        if (!kv_sectors[i].used) {
+            return FLASH_ERR_NONE;
+        }
+    }
+    oldest = kv_oldest();
+    log_printf("kv: collecting sector %d\n", kv_sectors[oldest].num);
+    for (uint16_t key = 0; key < CONFIG_USR_DRV_FLASH_KV_MAX_KEYS; ++key) {
+        if (kv_index[key] == 0 || !kv_sector_contains(oldest, kv_index[key])) {
+            continue;
+        }
+        if ((err = kv_copy_record(kv_index[key])) != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    return kv_erase(oldest);
+}
+
+/* the head sector is full: switch to the spare sector */
+static t_flash_err kv_advance(void)
+{
+    uint8_t spare = kv_nb_sectors;
+    t_flash_err err;
+
+    for (uint8_t i = 0; i < kv_nb_sectors; ++i) {
+        if (!kv_sectors[i].used) {
+            spare = i;
+            break;
+        }
+    }
+    if (spare == kv_nb_sectors) {
+        return FLASH_ERR_NOSPACE;
+    }
+    if ((err = kv_format(spare, kv_sectors[kv_head].seq + 1)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    kv_head = spare;
+    kv_head_off = FLASH_KV_HDR_SIZE;
+    return kv_collect();
+}
+
+/*
+ * Replay the records of a sector into the index. Gives the offset of the
+ * first free record, or the sector size if the sector is full or torn (a
+ * record interrupted by a power loss) and must not be appended anymore.
+ */
+static t_flash_err kv_replay(uint8_t idx, uint32_t *free_off, bool *torn)
+{
+    uint8_t value[FLASH_KV_MAX_VALUE];
+    uint32_t off = FLASH_KV_HDR_SIZE;
+    uint32_t hdr;
+    uint32_t crc;
+    uint32_t size;
+    uint8_t len;
+    t_flash_err err;
+
+    *free_off = kv_sector_size;
+    while (off + 4 <= kv_sector_size) {
+        if ((err = flash_read((uint8_t*)&hdr, kv_addr(idx, off), 4)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (hdr == 0xffffffff) {
+            /* end of the records, after which everything must be erased */
+            size = kv_sector_size - off;
+            if (size > FLASH_KV_REC_MAX) {
+                size = FLASH_KV_REC_MAX;
+            }
+            if (kv_is_blank(kv_addr(idx, off), size)) {
+                *free_off = off;
+            } else {
+                *torn = true;
+            }
+            return FLASH_ERR_NONE;
+        }
+        len = KV_REC_LEN(hdr);
+        if (!KV_REC_IS_VALID(hdr) || off + KV_REC_SIZE(len) > kv_sector_size) {
+            *torn = true;
+            break;
+        }
+        if ((err = flash_read((uint8_t*)&crc, kv_addr(idx, off + 4), 4)) != FLASH_ERR_NONE ||
+            (err = flash_read(value, kv_addr(idx, off + 8), len)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (kv_rec_crc(hdr, value) != crc) {
+            log_printf("kv: corrupted record at %x\n", kv_addr(idx, off));
+            *torn = true;
+            break;
+        }
+        if (KV_REC_KEY(hdr) < CONFIG_USR_DRV_FLASH_KV_MAX_KEYS) {
+            kv_index[KV_REC_KEY(hdr)] = len ? kv_addr(idx, off) : 0;
+        }
+        off += KV_REC_SIZE(len);
+    }
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_kv_init(const uint8_t *sectors, uint8_t nb_sectors)
+{
+    uint32_t hdr[3];
+    uint8_t order[FLASH_KV_MAX_SECTORS];
+    uint8_t nb_used;
+    uint8_t tmp;
+    uint32_t off = 0;
+    uint32_t size;
+    bool torn = false;
+    t_flash_err err;
+
+    if (sectors == NULL || nb_sectors < 2 || nb_sectors > FLASH_KV_MAX_SECTORS) {
+        return FLASH_ERR_INVAL;
+    }
+    kv_sector_size = flash_sector_size(sectors[0]);
+    for (uint8_t i = 0; i < nb_sectors; ++i) {
+        if (flash_sector_size(sectors[i]) == 0 ||
+            flash_sector_size(sectors[i]) != kv_sector_size) {
+            return FLASH_ERR_INVAL;
+        }
+        for (uint8_t j = 0; j < i; ++j) {
+            if (sectors[j] == sectors[i]) {
+                return FLASH_ERR_INVAL;
+            }
+        }
+        kv_sectors[i].num = sectors[i];
+    }
+    kv_nb_sectors = nb_sectors;
+mount:
+    memset(kv_index, 0, sizeof(kv_index));
+    nb_used = 0;
+
+    /* find the store sectors, erase the others if needed */
+    for (uint8_t i = 0; i < nb_sectors; ++i) {
+        if ((err = flash_read((uint8_t*)hdr, kv_addr(i, 0), sizeof(hdr))) != FLASH_ERR_NONE) {
+            return err;
+        }
+        kv_sectors[i].used = hdr[0] == FLASH_KV_MAGIC && hdr[1] == ~hdr[2];
+        kv_sectors[i].seq = hdr[1];
+        if (kv_sectors[i].used) {
+            order[nb_used++] = i;
+        } else if (!kv_is_blank(kv_addr(i, 0), kv_sector_size)) {
+            /* interrupted format or erase */
+            if ((err = kv_erase(i)) != FLASH_ERR_NONE) {
+                return err;
+            }
+        }
+    }
+    if (nb_used == 0) {
+        kv_head = 0;
+        kv_head_off = FLASH_KV_HDR_SIZE;
+        return kv_format(0, 1);
+    }
+    /* replay from the oldest sector to the newest */
+    for (uint8_t i = 1; i < nb_used; ++i) {
+        for (uint8_t j = i; j > 0 && kv_sectors[order[j]].seq < kv_sectors[order[j - 1]].seq; --j) {
+            tmp = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = tmp;
+        }
+    }
+    for (uint8_t i = 0; i < nb_used; ++i) {
+        torn = false;
+        if ((err = kv_replay(order[i], &off, &torn)) != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    kv_head = order[nb_used - 1];
+    kv_head_off = off;
+    if (nb_used == nb_sectors && torn) {
+        /*
+         * Collection interrupted while moving the records: the head only
+         * holds copies of records still in the oldest sector. Drop it, the
+         * collection is done again at the next append.
+         */
+        log_printf("kv: dropping interrupted collection\n");
+        if ((err = kv_erase(kv_head)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        goto mount;
+    }
+    kv_live = 0;
+    for (uint16_t key = 0; key < CONFIG_USR_DRV_FLASH_KV_MAX_KEYS; ++key) {
+        if ((err = kv_live_size(key, &size)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        kv_live += size;
+    }
+    /* complete an interrupted collection */
+    return kv_collect();
+}
+
+t_flash_err flash_kv_get(uint16_t key, void *buf, uint16_t *len)
+{
+    uint32_t hdr;
+    t_flash_err err;
+
+    if (key >= CONFIG_USR_DRV_FLASH_KV_MAX_KEYS || buf == NULL || len == NULL) {
+        return FLASH_ERR_INVAL;
+    }
+    if (kv_index[key] == 0) {
+        return FLASH_ERR_NOENT;
+    }
+    if ((err = flash_read((uint8_t*)&hdr, kv_index[key], 4)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    if (*len < KV_REC_LEN(hdr)) {
+        return FLASH_ERR_INVAL;
+    }
+    *len = KV_REC_LEN(hdr);
+    return flash_read(buf, kv_index[key] + 8, *len);
+}
+
+static t_flash_err kv_append(uint16_t key, const uint8_t *value, uint8_t len)
+{
+    uint32_t old_size;
+    uint32_t hdr;
+    t_flash_err err;
+
+    if (kv_nb_sectors == 0) {
+        return FLASH_ERR_INVAL;
+    }
+    if ((err = kv_live_size(key, &old_size)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    /*
+     * Keep the live records, the replaced one included, within a sector
+     * with room for a deletion, so that the next collection always fits.
+     * A deletion only relies on the room kept for it.
+     */
+    if (len != 0 &&
+        kv_live + KV_REC_SIZE(len) + KV_REC_SIZE(0) > kv_sector_size - FLASH_KV_HDR_SIZE) {
+        return FLASH_ERR_NOSPACE;
+    }
+    if (kv_head_off + KV_REC_SIZE(len) > kv_sector_size) {
+        if ((err = kv_advance()) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (kv_head_off + KV_REC_SIZE(len) > kv_sector_size) {
+            return FLASH_ERR_NOSPACE;
+        }
+    }
+    hdr = kv_rec_header(key, len);
+    if ((err = kv_write_record(hdr, value)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    kv_live = kv_live - old_size + (len ? KV_REC_SIZE(len) : 0);
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_kv_set(uint16_t key, const void *value, uint16_t len)
+{
+    uint8_t cur[FLASH_KV_MAX_VALUE];
+    uint16_t cur_len = sizeof(cur);
+
+    if (key >= CONFIG_USR_DRV_FLASH_KV_MAX_KEYS || value == NULL ||
+        len == 0 || len > FLASH_KV_MAX_VALUE) {
+        return FLASH_ERR_INVAL;
+    }
+    /* unchanged value: nothing to write */
+    if (flash_kv_get(key, cur, &cur_len) == FLASH_ERR_NONE &&
+        cur_len == len && memcmp(cur, value, len) == 0) {
+        return FLASH_ERR_NONE;
+    }
+    return kv_append(key, value, (uint8_t)len);
+}
+
+t_flash_err flash_kv_delete(uint16_t key)
+{
+    if (key >= CONFIG_USR_DRV_FLASH_KV_MAX_KEYS) {
+        return FLASH_ERR_INVAL;
+    }
+    if (kv_index[key] == 0) {
+        return FLASH_ERR_NOENT;
+    }
+    return kv_append(key, NULL, 0);
+}
+
+#endif
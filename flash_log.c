@@ -0,0 +1,325 @@
+/** @file flash_log.c
+ * \brief Append-only circular log
+ */
+
+#include "autoconf.h"
+
+#if CONFIG_USR_DRV_FLASH_LOG
+
+#include "api/libflash.h"
+#include "api/flash_log.h"
+#include "libc/stdio.h"
+#include "libc/string.h"
+
+#define FLASH_LOG_DEBUG 0
+
+/* Primitive for debug output */
+#if FLASH_LOG_DEBUG
+#define log_printf(...) printf(__VA_ARGS__)
+#else
+#define log_printf(...)
+#endif
+
+/*
+ * Sector header, in the first slot: magic, sequence number, complemented
+ * sequence number. The magic is programmed last, and cleared before the
+ * sector is erased.
+ *
+ * Record slot: header word (length in bits 0-15, complemented length in
+ * bits 16-31), then the record. The record is programmed first and the
+ * header word last, so that the slot is seen written only once complete.
+ * A record interrupted by a power loss has an invalid header, or leaves a
+ * programmed slot with an erased header, which is skipped.
+ */
+#define FLASH_LOG_MAGIC         0x4C4F4731
+
+#define LOG_REC_HDR(len)        ((uint32_t)(len) | ((uint32_t)(uint16_t)~(len) << 16))
+#define LOG_REC_LEN(hdr)        ((hdr) & 0xffff)
+
+static uint8_t log_first_sector = 0;
+static uint8_t log_nb_sectors = 0;
+static uint32_t log_sector_size = 0;
+static uint16_t log_slot_size = 0;
+static uint32_t log_nb_slots = 0;
+/* head sector (index in the ring), its sequence number and next slot */
+static uint8_t log_head = 0;
+static uint32_t log_head_seq = 0;
+static uint32_t log_head_slot = 0;
+/* number of sectors holding records, from the oldest to the head */
+static uint8_t log_nb_used = 0;
+
+static inline physaddr_t log_addr(uint8_t idx, uint32_t slot)
+{
+    return flash_sector_addr(log_first_sector + idx) + slot * log_slot_size;
+}
+
+static inline t_flash_err log_read_word(physaddr_t addr, uint32_t *word)
+{
+    return flash_read((uint8_t*)word, addr, sizeof(*word));
+}
+
+static bool log_is_blank(physaddr_t addr, uint32_t size)
+{
+    uint32_t buf[16];
+    uint32_t chunk;
+
+    while (size > 0) {
+        chunk = size < sizeof(buf) ? size : sizeof(buf);
+        if (flash_read((uint8_t*)buf, addr, chunk) != FLASH_ERR_NONE) {
+            return false;
+        }
+        for (uint32_t i = 0; i < chunk; ++i) {
+            if (((uint8_t*)buf)[i] != 0xff) {
+                return false;
+            }
+        }
+        addr += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+/* read a sector header, valid is false if the sector doesn't hold records */
+static t_flash_err log_read_header(uint8_t idx, uint32_t *seq, bool *valid)
+{
+    uint32_t hdr[3];
+    t_flash_err err;
+
+    if ((err = flash_read((uint8_t*)hdr, log_addr(idx, 0), sizeof(hdr))) != FLASH_ERR_NONE) {
+        return err;
+    }
+    *seq = hdr[1];
+    *valid = hdr[0] == FLASH_LOG_MAGIC && hdr[1] == ~hdr[2];
+    return FLASH_ERR_NONE;
+}
+
+/*
+ * Erase a sector, clearing its magic first: an erase interrupted by a power
+ * loss leaves an invalid header, and not a possibly intact one in front of
+ * partially erased records.
+ */
+static t_flash_err log_erase(uint8_t idx)
+{
+    uint32_t zero = 0;
+    t_flash_err err;
+
+    if ((err = flash_write(log_addr(idx, 0), (uint8_t*)&zero, 4)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    if (flash_sector_erase(log_addr(idx, 0)) == 0xff) {
+        return flash_get_last_error();
+    }
+    return FLASH_ERR_NONE;
+}
+
+/* erase (if needed) and format a sector as the new head */
+static t_flash_err log_format(uint8_t idx, uint32_t seq, bool erase)
+{
+    uint32_t hdr[3] = { FLASH_LOG_MAGIC, seq, ~seq };
+    t_flash_err err;
+
+    if (erase || !log_is_blank(log_addr(idx, 0), log_sector_size)) {
+        if ((err = log_erase(idx)) != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    err = flash_write(log_addr(idx, 0) + 4, (uint8_t*)&hdr[1], 8);
+    if (err == FLASH_ERR_NONE) {
+        err = flash_write(log_addr(idx, 0), (uint8_t*)&hdr[0], 4);
+    }
+    if (err != FLASH_ERR_NONE) {
+        return err;
+    }
+    log_head = idx;
+    log_head_seq = seq;
+    log_head_slot = 1;
+    return FLASH_ERR_NONE;
+}
+
+/*
+ * Binary search of the first slot of the head sector with an erased
+ * header. Slots are written in order, so that written headers come first.
+ */
+static t_flash_err log_find_tail(uint32_t *tail)
+{
+    uint32_t lo = 1;
+    uint32_t hi = log_nb_slots;
+    uint32_t mid, word;
+    t_flash_err err;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if ((err = log_read_word(log_addr(log_head, mid), &word)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (word != 0xffffffff) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    /* skip a slot whose record was interrupted before its header */
+    while (lo < log_nb_slots && !log_is_blank(log_addr(log_head, lo), log_slot_size)) {
+        lo++;
+    }
+    *tail = lo;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_log_init(uint8_t first_sector, uint8_t nb_sectors,
+                           uint16_t slot_size)
+{
+    uint32_t seq;
+    uint32_t min_seq = 0;
+    bool found = false;
+    bool valid;
+    t_flash_err err;
+
+    if (nb_sectors < 2 || slot_size < 16 || slot_size > FLASH_LOG_MAX_SLOT ||
+        (slot_size & 3)) {
+        return FLASH_ERR_INVAL;
+    }
+    log_sector_size = flash_sector_size(first_sector);
+    for (uint8_t i = 0; i < nb_sectors; ++i) {
+        if (flash_sector_size(first_sector + i) == 0 ||
+            flash_sector_size(first_sector + i) != log_sector_size) {
+            return FLASH_ERR_INVAL;
+        }
+    }
+    log_first_sector = first_sector;
+    log_nb_sectors = nb_sectors;
+    log_slot_size = slot_size;
+    log_nb_slots = log_sector_size / slot_size;
+
+    /* the head is the sector with the highest sequence number */
+    for (uint8_t i = 0; i < nb_sectors; ++i) {
+        if ((err = log_read_header(i, &seq, &valid)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (!valid) {
+            continue;
+        }
+        if (!found || seq > log_head_seq) {
+            log_head = i;
+            log_head_seq = seq;
+        }
+        if (!found || seq < min_seq) {
+            min_seq = seq;
+        }
+        found = true;
+    }
+    if (!found) {
+        log_nb_used = 1;
+        return log_format(0, 1, false);
+    }
+    log_nb_used = (uint8_t)(log_head_seq - min_seq + 1);
+    if ((err = log_find_tail(&log_head_slot)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    log_printf("log: head sector %d, slot %d\n", first_sector + log_head, log_head_slot);
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_log_append(const void *rec, uint16_t len)
+{
+    uint32_t hdr = LOG_REC_HDR(len);
+    uint8_t next;
+    physaddr_t addr;
+    t_flash_err err;
+
+    if (log_nb_sectors == 0 || rec == NULL || len == 0 || len > log_slot_size - 4) {
+        return FLASH_ERR_INVAL;
+    }
+    if (log_head_slot >= log_nb_slots) {
+        /* switch to the next sector, dropping its records if any */
+        next = (log_head + 1) % log_nb_sectors;
+        if (log_nb_used == log_nb_sectors) {
+            log_nb_used--;
+            err = log_format(next, log_head_seq + 1, true);
+        } else {
+            err = log_format(next, log_head_seq + 1, false);
+        }
+        if (err != FLASH_ERR_NONE) {
+            return err;
+        }
+        log_nb_used++;
+    }
+    addr = log_addr(log_head, log_head_slot);
+    /* the slot is consumed, even if partially written */
+    log_head_slot++;
+    err = flash_write(addr + 4, rec, len);
+    if (err == FLASH_ERR_NONE) {
+        err = flash_write(addr, (uint8_t*)&hdr, 4);
+    }
+    return err;
+}
+
+uint32_t flash_log_first(void)
+{
+    return (log_head_seq - log_nb_used + 1) * log_nb_slots + 1;
+}
+
+uint32_t flash_log_end(void)
+{
+    return log_head_seq * log_nb_slots + log_head_slot;
+}
+
+t_flash_err flash_log_iterate(uint32_t from, uint32_t to, t_flash_log_cb cb,
+                              void *ctx)
+{
+    uint8_t rec[FLASH_LOG_MAX_SLOT];
+    uint32_t seq, slot, hdr;
+    uint8_t idx;
+    t_flash_err err;
+
+    if (log_nb_sectors == 0 || cb == NULL) {
+        return FLASH_ERR_INVAL;
+    }
+    if (from < flash_log_first()) {
+        from = flash_log_first();
+    }
+    if (to > flash_log_end()) {
+        to = flash_log_end();
+    }
+    for (uint32_t pos = from; pos < to; ++pos) {
+        seq = pos / log_nb_slots;
+        slot = pos % log_nb_slots;
+        if (slot == 0) {
+            /* sector header */
+            continue;
+        }
+        idx = (uint8_t)((log_head + log_nb_sectors - (log_head_seq - seq)) % log_nb_sectors);
+        if ((err = log_read_word(log_addr(idx, slot), &hdr)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (hdr != LOG_REC_HDR(LOG_REC_LEN(hdr)) ||
+            LOG_REC_LEN(hdr) > log_slot_size - 4u) {
+            /* interrupted or empty slot */
+            continue;
+        }
+        if ((err = flash_read(rec, log_addr(idx, slot) + 4, LOG_REC_LEN(hdr))) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (!cb(pos, rec, LOG_REC_LEN(hdr), ctx)) {
+            break;
+        }
+    }
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_log_truncate(void)
+{
+    uint8_t oldest;
+
+    if (log_nb_sectors == 0) {
+        return FLASH_ERR_INVAL;
+    }
+    if (log_nb_used <= 1) {
+        return FLASH_ERR_NOENT;
+    }
+    oldest = (uint8_t)((log_head + log_nb_sectors - (log_nb_used - 1)) % log_nb_sectors);
+    log_nb_used--;
+    return log_erase(oldest);
+}
+
+#endif
@@ -0,0 +1,362 @@
+/** @file flash_lz4.c
+ * \brief Streaming LZ4 frame decompression into the inactive bank
+ */
+
+#include "autoconf.h"
+
+#if CONFIG_USR_DRV_FLASH_LZ4
+
+#include "api/libflash.h"
+#include "api/flash_fw.h"
+#include "api/flash_lz4.h"
+#include "libc/stdio.h"
+#include "libc/string.h"
+
+#define FLASH_LZ4_DEBUG 0
+
+/* Primitive for debug output */
+#if FLASH_LZ4_DEBUG
+#define log_printf(...) printf(__VA_ARGS__)
+#else
+#define log_printf(...)
+#endif
+
+#define LZ4_FRAME_MAGIC         0x184D2204
+
+/* frame descriptor FLG byte */
+#define LZ4_FLG_VERSION_MSK     0xc0
+#define LZ4_FLG_VERSION         0x40
+#define LZ4_FLG_BLOCK_CRC       0x10
+#define LZ4_FLG_CONTENT_SIZE    0x08
+#define LZ4_FLG_CONTENT_CRC     0x04
+#define LZ4_FLG_DICT_ID         0x01
+
+#define LZ4_BLOCK_RAW           0x80000000
+#define LZ4_MIN_MATCH           4
+
+typedef enum {
+    /* frame fields */
+    LZ4_ST_MAGIC,
+    LZ4_ST_DESC,
+    LZ4_ST_DESC_EXT,    /* optional content size, header checksum */
+    LZ4_ST_BLOCK_SIZE,
+    LZ4_ST_BLOCK_CRC,
+    LZ4_ST_CONTENT_CRC,
+    LZ4_ST_DONE,
+    /* block content */
+    LZ4_ST_RAW,
+    LZ4_ST_TOKEN,
+    LZ4_ST_LIT_LEN,
+    LZ4_ST_LITERALS,
+    LZ4_ST_OFFSET,
+    LZ4_ST_MATCH_LEN,
+    LZ4_ST_ERROR,
+} t_lz4_state;
+
+static t_lz4_state lz4_state = LZ4_ST_ERROR;
+static uint8_t lz4_flg = 0;
+/* fixed size field being received (only the first 4 bytes are kept) */
+static uint8_t lz4_field[4];
+static uint32_t lz4_field_len = 0;
+static uint32_t lz4_field_need = 0;
+/* remaining bytes of the current block, and of the current literal run */
+static uint32_t lz4_block_remain = 0;
+static uint32_t lz4_remain = 0;
+static uint32_t lz4_match_len = 0;
+static uint32_t lz4_offset = 0;
+/* decompressed image: target area, total size, not yet programmed part */
+static physaddr_t lz4_img = 0;
+static uint32_t lz4_out_total = 0;
+static uint8_t lz4_buf[FLASH_LZ4_BUF_SIZE];
+static uint32_t lz4_buf_len = 0;
+
+static inline bool lz4_in_block(void)
+{
+    return lz4_state >= LZ4_ST_RAW && lz4_state < LZ4_ST_ERROR;
+}
+
+static inline void lz4_expect(t_lz4_state state, uint32_t size)
+{
+    lz4_state = state;
+    lz4_field_len = 0;
+    lz4_field_need = size;
+}
+
+static inline uint32_t lz4_get_word(void)
+{
+    return (uint32_t)lz4_field[0] | ((uint32_t)lz4_field[1] << 8) |
+           ((uint32_t)lz4_field[2] << 16) | ((uint32_t)lz4_field[3] << 24);
+}
+
+static t_flash_err lz4_flush(void)
+{
+    t_flash_err err;
+
+    if (lz4_buf_len == 0) {
+        return FLASH_ERR_NONE;
+    }
+    err = flash_fw_write(lz4_buf, lz4_buf_len);
+    lz4_buf_len = 0;
+    return err;
+}
+
+/* room in the output buffer, flushed if full */
+static t_flash_err lz4_out_room(uint32_t *room)
+{
+    t_flash_err err;
+
+    if (lz4_buf_len == sizeof(lz4_buf) &&
+        (err = lz4_flush()) != FLASH_ERR_NONE) {
+        return err;
+    }
+    *room = sizeof(lz4_buf) - lz4_buf_len;
+    return FLASH_ERR_NONE;
+}
+
+static t_flash_err lz4_out(const uint8_t *data, uint32_t len)
+{
+    uint32_t chunk;
+    t_flash_err err;
+
+    while (len > 0) {
+        if ((err = lz4_out_room(&chunk)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        chunk = len < chunk ? len : chunk;
+        memcpy(&lz4_buf[lz4_buf_len], data, chunk);
+        lz4_buf_len += chunk;
+        lz4_out_total += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    return FLASH_ERR_NONE;
+}
+
+/*
+ * Copy a match, from the output buffer or from the programmed image. Each
+ * step copies at most offset bytes, so that source and destination don't
+ * overlap.
+ */
+static t_flash_err lz4_match(void)
+{
+    uint32_t len = lz4_match_len + LZ4_MIN_MATCH;
+    uint32_t src, programmed, chunk;
+    t_flash_err err;
+
+    if (lz4_offset == 0 || lz4_offset > lz4_out_total) {
+        return FLASH_ERR_INVAL;
+    }
+    src = lz4_out_total - lz4_offset;
+    while (len > 0) {
+        if ((err = lz4_out_room(&chunk)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        chunk = len < chunk ? len : chunk;
+        chunk = lz4_offset < chunk ? lz4_offset : chunk;
+        programmed = lz4_out_total - lz4_buf_len;
+        if (src < programmed) {
+            chunk = (programmed - src) < chunk ? (programmed - src) : chunk;
+            err = flash_read(&lz4_buf[lz4_buf_len], lz4_img + src, chunk);
+            if (err != FLASH_ERR_NONE) {
+                return err;
+            }
+        } else {
+            memcpy(&lz4_buf[lz4_buf_len], &lz4_buf[src - programmed], chunk);
+        }
+        lz4_buf_len += chunk;
+        lz4_out_total += chunk;
+        src += chunk;
+        len -= chunk;
+    }
+    return FLASH_ERR_NONE;
+}
+
+/* end of a block content */
+static void lz4_block_end(void)
+{
+    if (lz4_flg & LZ4_FLG_BLOCK_CRC) {
+        lz4_expect(LZ4_ST_BLOCK_CRC, 4);
+    } else {
+        lz4_expect(LZ4_ST_BLOCK_SIZE, 4);
+    }
+}
+
+/* a fixed size field is received */
+static t_flash_err lz4_field_done(void)
+{
+    uint32_t word = lz4_get_word();
+
+    switch (lz4_state) {
+        case LZ4_ST_MAGIC:
+            if (word != LZ4_FRAME_MAGIC) {
+                log_printf("lz4: bad frame magic %x\n", word);
+                return FLASH_ERR_INVAL;
+            }
+            lz4_expect(LZ4_ST_DESC, 2);
+            break;
+        case LZ4_ST_DESC:
+            lz4_flg = lz4_field[0];
+            if ((lz4_flg & LZ4_FLG_VERSION_MSK) != LZ4_FLG_VERSION ||
+                (lz4_flg & LZ4_FLG_DICT_ID)) {
+                return FLASH_ERR_INVAL;
+            }
+            /* the block maximum size doesn't matter, blocks being streamed */
+            lz4_expect(LZ4_ST_DESC_EXT, (lz4_flg & LZ4_FLG_CONTENT_SIZE) ? 9 : 1);
+            break;
+        case LZ4_ST_DESC_EXT:
+        case LZ4_ST_BLOCK_CRC:
+            lz4_expect(LZ4_ST_BLOCK_SIZE, 4);
+            break;
+        case LZ4_ST_BLOCK_SIZE:
+            if (word == 0) {
+                /* end mark */
+                if (lz4_flg & LZ4_FLG_CONTENT_CRC) {
+                    lz4_expect(LZ4_ST_CONTENT_CRC, 4);
+                } else {
+                    lz4_state = LZ4_ST_DONE;
+                }
+                break;
+            }
+            lz4_block_remain = word & ~LZ4_BLOCK_RAW;
+            if (word & LZ4_BLOCK_RAW) {
+                lz4_remain = lz4_block_remain;
+                lz4_state = LZ4_ST_RAW;
+            } else {
+                lz4_state = LZ4_ST_TOKEN;
+            }
+            break;
+        case LZ4_ST_CONTENT_CRC:
+            lz4_state = LZ4_ST_DONE;
+            break;
+        case LZ4_ST_OFFSET:
+            lz4_offset = word & 0xffff;
+            if (lz4_match_len == 15) {
+                lz4_state = LZ4_ST_MATCH_LEN;
+                break;
+            }
+            lz4_state = LZ4_ST_TOKEN;
+            return lz4_match();
+        default:
+            return FLASH_ERR_INVAL;
+    }
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_lz4_begin(void)
+{
+    lz4_img = flash_fw_get_image(flash_fw_get_target());
+    lz4_out_total = 0;
+    lz4_buf_len = 0;
+    lz4_expect(LZ4_ST_MAGIC, 4);
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_lz4_write(const uint8_t *data, uint32_t len)
+{
+    uint32_t avail, chunk;
+    uint8_t byte;
+    bool in_block;
+    t_flash_err err = FLASH_ERR_NONE;
+
+    if (data == NULL || lz4_state == LZ4_ST_ERROR) {
+        return FLASH_ERR_INVAL;
+    }
+    while (len > 0 && err == FLASH_ERR_NONE) {
+        avail = len;
+        in_block = lz4_in_block();
+        if (in_block) {
+            if (lz4_block_remain == 0) {
+                /* the last sequence of a block has no match */
+                err = FLASH_ERR_INVAL;
+                break;
+            }
+            avail = lz4_block_remain < avail ? lz4_block_remain : avail;
+        }
+        switch (lz4_state) {
+            case LZ4_ST_DONE:
+                /* concatenated frame */
+                lz4_expect(LZ4_ST_MAGIC, 4);
+                continue;
+            case LZ4_ST_TOKEN:
+                byte = *data;
+                chunk = 1;
+                lz4_remain = byte >> 4;
+                lz4_match_len = byte & 0xf;
+                if (lz4_remain == 15) {
+                    lz4_state = LZ4_ST_LIT_LEN;
+                } else if (lz4_remain) {
+                    lz4_state = LZ4_ST_LITERALS;
+                } else {
+                    lz4_expect(LZ4_ST_OFFSET, 2);
+                }
+                break;
+            case LZ4_ST_LIT_LEN:
+            case LZ4_ST_MATCH_LEN:
+                byte = *data;
+                chunk = 1;
+                if (lz4_state == LZ4_ST_LIT_LEN) {
+                    lz4_remain += byte;
+                    if (byte != 255) {
+                        lz4_state = LZ4_ST_LITERALS;
+                    }
+                } else {
+                    lz4_match_len += byte;
+                    if (byte != 255) {
+                        lz4_state = LZ4_ST_TOKEN;
+                        err = lz4_match();
+                    }
+                }
+                break;
+            case LZ4_ST_RAW:
+            case LZ4_ST_LITERALS:
+                chunk = lz4_remain < avail ? lz4_remain : avail;
+                err = lz4_out(data, chunk);
+                lz4_remain -= chunk;
+                if (lz4_remain == 0 && lz4_state == LZ4_ST_LITERALS) {
+                    lz4_expect(LZ4_ST_OFFSET, 2);
+                }
+                break;
+            default:
+                /* fixed size fields */
+                chunk = lz4_field_need - lz4_field_len;
+                chunk = avail < chunk ? avail : chunk;
+                for (uint32_t i = 0; i < chunk; ++i, ++lz4_field_len) {
+                    if (lz4_field_len < sizeof(lz4_field)) {
+                        lz4_field[lz4_field_len] = data[i];
+                    }
+                }
+                if (lz4_field_len == lz4_field_need) {
+                    err = lz4_field_done();
+                }
+                break;
+        }
+        if (in_block) {
+            lz4_block_remain -= chunk;
+            if (lz4_block_remain == 0 &&
+                (lz4_state == LZ4_ST_RAW || (lz4_state == LZ4_ST_OFFSET &&
+                                             lz4_field_len == 0))) {
+                /* block ending with its last literals */
+                lz4_block_end();
+            }
+        }
+        data += chunk;
+        len -= chunk;
+    }
+    if (err != FLASH_ERR_NONE) {
+        /* the decompression must be restarted */
+        lz4_state = LZ4_ST_ERROR;
+    }
+    return err;
+}
+
+t_flash_err flash_lz4_finish(void)
+{
+    if (lz4_state != LZ4_ST_DONE) {
+        lz4_state = LZ4_ST_ERROR;
+        return FLASH_ERR_INVAL;
+    }
+    lz4_state = LZ4_ST_ERROR;
+    return lz4_flush();
+}
+
+#endif
@@ -0,0 +1,382 @@
+/** @file flash_merkle.c
+ * \brief Merkle tree integrity index over a flash region
+ */
+
+#include "autoconf.h"
+
+#if CONFIG_USR_DRV_FLASH_MERKLE
+
+#include "api/libflash.h"
+#include "api/flash_hash.h"
+#include "api/flash_merkle.h"
+#include "libc/stdio.h"
+#include "libc/string.h"
+#include "flash_hooks.h"
+
+#define FLASH_MERKLE_DEBUG 0
+
+/* Primitive for debug output */
+#if FLASH_MERKLE_DEBUG
+#define log_printf(...) printf(__VA_ARGS__)
+#else
+#define log_printf(...)
+#endif
+
+/*
+ * Metadata sector layout:
+ * - header: magic, sequence number, complemented sequence number, region
+ *   base, region number of blocks. The magic is programmed last. The next
+ *   word, left erased, is the dirty marker: it is programmed before the
+ *   region is first modified after the tree has been stored, so that a
+ *   reset before the next update is detected and the tree built again.
+ * - nodes, in heap order: node 1 is the root, node i has children 2i and
+ *   2i+1, the leaves being nodes [n, 2n[ (n: number of blocks, rounded up
+ *   to a power of 2). Leaves past the region are zero.
+ */
+#define FLASH_MERKLE_MAGIC      0x4D524B31
+#define MERKLE_HDR_SIZE         32
+#define MERKLE_DIRTY_OFFSET     20
+#define MERKLE_DIRTY            0x00000000
+#define MERKLE_LEAF_PREFIX      0x00
+#define MERKLE_NODE_PREFIX      0x01
+
+#define MERKLE_MAX_NODES        (2 * FLASH_MERKLE_MAX_BLOCKS)
+
+static t_flash_merkle_conf merkle_conf;
+static bool merkle_ready = false;
+/* number of leaves, current metadata sector and its sequence number */
+static uint32_t merkle_leaves = 0;
+static uint8_t merkle_cur = 0;
+static uint32_t merkle_seq = 0;
+/* modified blocks, and nodes to compute again (bitmaps) */
+static uint32_t merkle_dirty[FLASH_MERKLE_MAX_BLOCKS / 32];
+static uint32_t merkle_dirty_nodes[MERKLE_MAX_NODES / 32];
+static bool merkle_has_dirty = false;
+/* the current tree has been erased, the next one must be fully built */
+static bool merkle_lost = false;
+/* the current tree dirty marker is programmed (or there is no tree) */
+static bool merkle_marked = false;
+
+static inline bool bit_test(const uint32_t *map, uint32_t i)
+{
+    return (map[i / 32] >> (i % 32)) & 1;
+}
+
+static inline void bit_set(uint32_t *map, uint32_t i)
+{
+    map[i / 32] |= 1u << (i % 32);
+}
+
+static inline physaddr_t merkle_node_addr(uint8_t meta, uint32_t node)
+{
+    return flash_sector_addr(merkle_conf.meta[meta]) + MERKLE_HDR_SIZE +
+           (node - 1) * FLASH_MERKLE_NODE_SIZE;
+}
+
+static t_flash_err merkle_hash_leaf(uint32_t block, uint8_t *out)
+{
+    t_flash_hash_ctx ctx;
+    uint8_t prefix = MERKLE_LEAF_PREFIX;
+    t_flash_err err;
+
+    if (block >= merkle_conf.nb_blocks) {
+        memset(out, 0, FLASH_MERKLE_NODE_SIZE);
+        return FLASH_ERR_NONE;
+    }
+    flash_hash_init(&ctx, &flash_hash_sha256);
+    flash_hash_update(&ctx, &prefix, 1);
+    err = flash_hash_region(&ctx, merkle_conf.base + block * FLASH_MERKLE_BLOCK_SIZE,
+                            FLASH_MERKLE_BLOCK_SIZE);
+    if (err != FLASH_ERR_NONE) {
+        return err;
+    }
+    flash_hash_final(&ctx, out);
+    return FLASH_ERR_NONE;
+}
+
+static void merkle_hash_node(const uint8_t *left, const uint8_t *right, uint8_t *out)
+{
+    t_flash_hash_ctx ctx;
+    uint8_t prefix = MERKLE_NODE_PREFIX;
+
+    flash_hash_init(&ctx, &flash_hash_sha256);
+    flash_hash_update(&ctx, &prefix, 1);
+    flash_hash_update(&ctx, left, FLASH_MERKLE_NODE_SIZE);
+    flash_hash_update(&ctx, right, FLASH_MERKLE_NODE_SIZE);
+    flash_hash_final(&ctx, out);
+}
+
+/*
+ * read a metadata sector header, returns false if it holds no tree. A
+ * partially programmed dirty marker is dirty too.
+ */
+static bool merkle_read_header(uint8_t meta, uint32_t *seq, bool *dirty)
+{
+    uint32_t hdr[6];
+
+    if (flash_read((uint8_t*)hdr, flash_sector_addr(merkle_conf.meta[meta]),
+                   sizeof(hdr)) != FLASH_ERR_NONE) {
+        return false;
+    }
+    *seq = hdr[1];
+    *dirty = hdr[MERKLE_DIRTY_OFFSET / 4] != 0xffffffff;
+    return hdr[0] == FLASH_MERKLE_MAGIC && hdr[1] == ~hdr[2] &&
+           hdr[3] == merkle_conf.base && hdr[4] == merkle_conf.nb_blocks;
+}
+
+/*
+ * Write the tree into the other metadata sector: the dirty nodes are
+ * computed bottom-up from their children, already written, the other ones
+ * are copied from the current tree. As a flash word can't be programmed
+ * again, the whole sector is erased and all the 2n nodes are written, even
+ * for a single modified block (a log of the path deltas, appended to the
+ * current sector, would avoid it at the cost of a slower loading).
+ */
+static t_flash_err merkle_commit(bool all)
+{
+    uint8_t next = merkle_cur ^ 1;
+    uint8_t node[FLASH_MERKLE_NODE_SIZE];
+    uint8_t children[2 * FLASH_MERKLE_NODE_SIZE];
+    uint32_t hdr[5] = { FLASH_MERKLE_MAGIC, merkle_seq + 1, ~(merkle_seq + 1),
+                        merkle_conf.base, merkle_conf.nb_blocks };
+    t_flash_err err;
+
+    all = all || merkle_lost;
+    memset(merkle_dirty_nodes, 0, sizeof(merkle_dirty_nodes));
+    for (uint32_t block = 0; block < merkle_leaves; ++block) {
+        if (all || bit_test(merkle_dirty, block)) {
+            for (uint32_t i = merkle_leaves + block; i >= 1; i >>= 1) {
+                bit_set(merkle_dirty_nodes, i);
+            }
+        }
+    }
+    if (flash_sector_erase(flash_sector_addr(merkle_conf.meta[next])) == 0xff) {
+        return flash_get_last_error();
+    }
+    for (uint32_t i = 2 * merkle_leaves - 1; i >= 1; --i) {
+        if (!bit_test(merkle_dirty_nodes, i)) {
+            err = flash_read(node, merkle_node_addr(merkle_cur, i), sizeof(node));
+        } else if (i >= merkle_leaves) {
+            err = merkle_hash_leaf(i - merkle_leaves, node);
+        } else {
+            err = flash_read(children, merkle_node_addr(next, 2 * i), sizeof(children));
+            merkle_hash_node(children, children + FLASH_MERKLE_NODE_SIZE, node);
+        }
+        if (err != FLASH_ERR_NONE) {
+            return err;
+        }
+        err = flash_write(merkle_node_addr(next, i), node, sizeof(node));
+        if (err != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    err = flash_write(flash_sector_addr(merkle_conf.meta[next]) + 4,
+                      (uint8_t*)&hdr[1], sizeof(hdr) - 4);
+    if (err == FLASH_ERR_NONE) {
+        /* the new tree becomes the current one */
+        err = flash_write(flash_sector_addr(merkle_conf.meta[next]),
+                          (uint8_t*)&hdr[0], 4);
+    }
+    if (err != FLASH_ERR_NONE) {
+        return err;
+    }
+    merkle_cur = next;
+    merkle_seq++;
+    memset(merkle_dirty, 0, sizeof(merkle_dirty));
+    merkle_has_dirty = false;
+    merkle_lost = false;
+    merkle_marked = false;
+    log_printf("merkle: tree %d stored in sector %d\n", merkle_seq, merkle_conf.meta[next]);
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_merkle_init(const t_flash_merkle_conf *conf)
+{
+    uint32_t seq[2];
+    bool valid[2];
+    bool dirty[2];
+    uint32_t size;
+    physaddr_t end;
+
+    merkle_ready = false;
+    if (conf == NULL || conf->nb_blocks == 0 ||
+        conf->nb_blocks > FLASH_MERKLE_MAX_BLOCKS ||
+        (conf->base % FLASH_MERKLE_BLOCK_SIZE) != 0) {
+        return FLASH_ERR_INVAL;
+    }
+    end = conf->base + conf->nb_blocks * FLASH_MERKLE_BLOCK_SIZE;
+    if (flash_sector_size(flash_select_sector(conf->base)) == 0 ||
+        flash_sector_size(flash_select_sector(end - 1)) == 0) {
+        return FLASH_ERR_INVAL;
+    }
+    for (merkle_leaves = 1; merkle_leaves < conf->nb_blocks; merkle_leaves <<= 1) {
+        ;
+    }
+    for (uint8_t i = 0; i < 2; ++i) {
+        size = flash_sector_size(conf->meta[i]);
+        if (size < MERKLE_HDR_SIZE + 2 * merkle_leaves * FLASH_MERKLE_NODE_SIZE ||
+            (flash_sector_addr(conf->meta[i]) < end &&
+             flash_sector_addr(conf->meta[i]) + size > conf->base)) {
+            return FLASH_ERR_INVAL;
+        }
+    }
+    if (conf->meta[0] == conf->meta[1]) {
+        return FLASH_ERR_INVAL;
+    }
+    merkle_conf = *conf;
+    memset(merkle_dirty, 0, sizeof(merkle_dirty));
+    merkle_has_dirty = false;
+    merkle_lost = false;
+    merkle_marked = true;
+    merkle_ready = true;
+
+    valid[0] = merkle_read_header(0, &seq[0], &dirty[0]);
+    valid[1] = merkle_read_header(1, &seq[1], &dirty[1]);
+    if (!valid[0] && !valid[1]) {
+        log_printf("merkle: no tree, building it\n");
+        merkle_cur = 1;
+        merkle_seq = 0;
+        return flash_merkle_build();
+    }
+    merkle_cur = (valid[1] && (!valid[0] || seq[1] > seq[0])) ? 1 : 0;
+    merkle_seq = seq[merkle_cur];
+    if (dirty[merkle_cur]) {
+        /* the region has been modified since, but the blocks are unknown */
+        log_printf("merkle: tree %d is dirty, building it again\n", merkle_seq);
+        return flash_merkle_build();
+    }
+    merkle_marked = false;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_merkle_build(void)
+{
+    if (!merkle_ready) {
+        return FLASH_ERR_INVAL;
+    }
+    return merkle_commit(true);
+}
+
+t_flash_err flash_merkle_update(void)
+{
+    if (!merkle_ready) {
+        return FLASH_ERR_INVAL;
+    }
+    if (!merkle_has_dirty) {
+        return FLASH_ERR_NONE;
+    }
+    return merkle_commit(false);
+}
+
+t_flash_err flash_merkle_root(uint8_t *root)
+{
+    t_flash_err err;
+
+    if (root == NULL) {
+        return FLASH_ERR_INVAL;
+    }
+    if ((err = flash_merkle_update()) != FLASH_ERR_NONE) {
+        return err;
+    }
+    return flash_read(root, merkle_node_addr(merkle_cur, 1), FLASH_MERKLE_NODE_SIZE);
+}
+
+t_flash_err flash_merkle_verify(uint32_t block, const uint8_t *root)
+{
+    uint8_t node[FLASH_MERKLE_NODE_SIZE];
+    uint8_t sibling[FLASH_MERKLE_NODE_SIZE];
+    t_flash_err err;
+
+    if (!merkle_ready || root == NULL || block >= merkle_conf.nb_blocks) {
+        return FLASH_ERR_INVAL;
+    }
+    if ((err = merkle_hash_leaf(block, node)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    for (uint32_t i = merkle_leaves + block; i > 1; i >>= 1) {
+        err = flash_read(sibling, merkle_node_addr(merkle_cur, i ^ 1), sizeof(sibling));
+        if (err != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (i & 1) {
+            merkle_hash_node(sibling, node, node);
+        } else {
+            merkle_hash_node(node, sibling, node);
+        }
+    }
+    if (memcmp(node, root, FLASH_MERKLE_NODE_SIZE) != 0) {
+        log_printf("merkle: block %d doesn't match the root\n", block);
+        return FLASH_ERR_VERIFY;
+    }
+    return FLASH_ERR_NONE;
+}
+
+/*
+ * Program the current tree dirty marker, before the region is first
+ * modified. Called from the hooks, before the flash operation starts. The
+ * marker is outside the region, its own programming is not tracked.
+ */
+static void merkle_mark(void)
+{
+    uint32_t dirty = MERKLE_DIRTY;
+
+    if (merkle_marked) {
+        return;
+    }
+    merkle_marked = true;
+    if (flash_write(flash_sector_addr(merkle_conf.meta[merkle_cur]) + MERKLE_DIRTY_OFFSET,
+                    (uint8_t*)&dirty, sizeof(dirty)) != FLASH_ERR_NONE) {
+        log_printf("merkle: can't mark tree %d as dirty\n", merkle_seq);
+    }
+}
+
+/* mark the blocks of [addr, addr + size[ in the region as modified */
+static void merkle_touch(physaddr_t addr, uint32_t size)
+{
+    physaddr_t end = merkle_conf.base + merkle_conf.nb_blocks * FLASH_MERKLE_BLOCK_SIZE;
+
+    if (!merkle_ready || size == 0 || addr >= end || addr + size <= merkle_conf.base) {
+        return;
+    }
+    if (addr < merkle_conf.base) {
+        size -= merkle_conf.base - addr;
+        addr = merkle_conf.base;
+    }
+    if (addr + size > end) {
+        size = end - addr;
+    }
+    for (uint32_t block = (addr - merkle_conf.base) / FLASH_MERKLE_BLOCK_SIZE;
+         block <= (addr + size - 1 - merkle_conf.base) / FLASH_MERKLE_BLOCK_SIZE;
+         ++block) {
+        bit_set(merkle_dirty, block);
+    }
+    merkle_has_dirty = true;
+    merkle_mark();
+}
+
+void flash_merkle_sector_erase(uint8_t sector)
+{
+    if (merkle_ready && sector == merkle_conf.meta[merkle_cur]) {
+        /* no tree to mark anymore */
+        merkle_lost = true;
+        merkle_has_dirty = true;
+        merkle_marked = true;
+    }
+    merkle_touch(flash_sector_addr(sector), flash_sector_size(sector));
+}
+
+void flash_merkle_bank_erase(uint8_t bank)
+{
+    for (uint8_t sector = bank ? 12 : 0; sector < (bank ? 24 : 12); ++sector) {
+        if (flash_sector_size(sector) != 0) {
+            flash_merkle_sector_erase(sector);
+        }
+    }
+}
+
+void flash_merkle_program(physaddr_t addr, uint32_t size)
+{
+    merkle_touch(addr, size);
+}
+
+#endif
@@ -0,0 +1,278 @@
+/** @file flash_patch.c
+ * \brief Streaming delta patch application into the inactive bank
+ */
+
+#include "autoconf.h"
+
+#if CONFIG_USR_DRV_FLASH_PATCH
+
+#include "api/libflash.h"
+#include "api/flash_fw.h"
+#include "api/flash_patch.h"
+#include "libc/stdio.h"
+#include "libc/string.h"
+
+#define FLASH_PATCH_DEBUG 0
+
+/* Primitive for debug output */
+#if FLASH_PATCH_DEBUG
+#define log_printf(...) printf(__VA_ARGS__)
+#else
+#define log_printf(...)
+#endif
+
+#define PATCH_HDR_SIZE          20
+
+typedef enum {
+    PATCH_ST_HEADER,    /* receiving the patch header */
+    PATCH_ST_OPCODE,    /* waiting for the next operation */
+    PATCH_ST_ARGS,      /* receiving the operation arguments */
+    PATCH_ST_DATA,      /* receiving the ADD/INSERT bytes */
+    PATCH_ST_ERROR,
+} t_patch_state;
+
+static t_patch_state patch_state = PATCH_ST_ERROR;
+/* fixed size field being received (header, operation arguments) */
+static uint8_t patch_field[PATCH_HDR_SIZE];
+static uint32_t patch_field_len = 0;
+static uint32_t patch_field_need = 0;
+static uint8_t patch_op = 0;
+/* current operation base image position and remaining length */
+static uint32_t patch_old_off = 0;
+static uint32_t patch_remain = 0;
+/* base (active bank) image */
+static physaddr_t patch_old = 0;
+static uint32_t patch_old_size = 0;
+/* new image */
+static uint32_t patch_size = 0;
+static uint32_t patch_crc = 0;
+static uint32_t patch_out_total = 0;
+static uint8_t patch_buf[FLASH_PATCH_BUF_SIZE];
+static uint32_t patch_buf_len = 0;
+
+static inline uint32_t patch_get_word(uint8_t idx)
+{
+    return (uint32_t)patch_field[4 * idx] |
+           ((uint32_t)patch_field[4 * idx + 1] << 8) |
+           ((uint32_t)patch_field[4 * idx + 2] << 16) |
+           ((uint32_t)patch_field[4 * idx + 3] << 24);
+}
+
+static t_flash_err patch_flush(void)
+{
+    t_flash_err err;
+
+    if (patch_buf_len == 0) {
+        return FLASH_ERR_NONE;
+    }
+    err = flash_fw_write(patch_buf, patch_buf_len);
+    patch_buf_len = 0;
+    return err;
+}
+
+/* room in the output buffer, flushed if full */
+static t_flash_err patch_out_room(uint32_t *room)
+{
+    t_flash_err err;
+
+    if (patch_buf_len == sizeof(patch_buf) &&
+        (err = patch_flush()) != FLASH_ERR_NONE) {
+        return err;
+    }
+    *room = sizeof(patch_buf) - patch_buf_len;
+    return FLASH_ERR_NONE;
+}
+
+/* COPY: base image bytes, straight to the output buffer */
+static t_flash_err patch_copy(uint32_t off, uint32_t len)
+{
+    uint32_t chunk;
+    t_flash_err err;
+
+    while (len > 0) {
+        if ((err = patch_out_room(&chunk)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        chunk = len < chunk ? len : chunk;
+        err = flash_read(&patch_buf[patch_buf_len], patch_old + off, chunk);
+        if (err != FLASH_ERR_NONE) {
+            return err;
+        }
+        patch_buf_len += chunk;
+        off += chunk;
+        len -= chunk;
+    }
+    return FLASH_ERR_NONE;
+}
+
+/* ADD/INSERT: patch bytes, added to the base image bytes for ADD */
+static t_flash_err patch_data(const uint8_t *data, uint32_t len)
+{
+    uint32_t chunk;
+    t_flash_err err;
+
+    while (len > 0) {
+        if ((err = patch_out_room(&chunk)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        chunk = len < chunk ? len : chunk;
+        if (patch_op == FLASH_PATCH_ADD) {
+            err = flash_read(&patch_buf[patch_buf_len], patch_old + patch_old_off, chunk);
+            if (err != FLASH_ERR_NONE) {
+                return err;
+            }
+            for (uint32_t i = 0; i < chunk; ++i) {
+                patch_buf[patch_buf_len + i] += data[i];
+            }
+            patch_old_off += chunk;
+        } else {
+            memcpy(&patch_buf[patch_buf_len], data, chunk);
+        }
+        patch_buf_len += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    return FLASH_ERR_NONE;
+}
+
+static t_flash_err patch_header(void)
+{
+    t_flash_fw_bank active;
+    t_flash_fw_header hdr;
+    t_flash_err err;
+
+    if (patch_get_word(0) != FLASH_PATCH_MAGIC) {
+        return FLASH_ERR_INVAL;
+    }
+    if (flash_fw_get_active(&active, &hdr) != FLASH_ERR_NONE ||
+        hdr.crc32 != patch_get_word(4)) {
+        log_printf("patch: active image is not the patch base\n");
+        return FLASH_ERR_VERIFY;
+    }
+    patch_old = flash_fw_get_image(active);
+    patch_old_size = hdr.size;
+    patch_size = patch_get_word(1);
+    patch_crc = patch_get_word(3);
+    if ((err = flash_fw_begin(patch_size, patch_get_word(2))) != FLASH_ERR_NONE) {
+        return err;
+    }
+    log_printf("patch: %d bytes image, version %d\n", patch_size, patch_get_word(2));
+    return FLASH_ERR_NONE;
+}
+
+/* the operation arguments are received */
+static t_flash_err patch_operation(void)
+{
+    uint32_t off = 0;
+    uint32_t len;
+
+    if (patch_op == FLASH_PATCH_INSERT) {
+        len = patch_get_word(0);
+    } else {
+        off = patch_get_word(0);
+        len = patch_get_word(1);
+        if (off > patch_old_size || len > patch_old_size - off) {
+            return FLASH_ERR_INVAL;
+        }
+    }
+    if (len > patch_size - patch_out_total) {
+        return FLASH_ERR_INVAL;
+    }
+    patch_out_total += len;
+    if (patch_op == FLASH_PATCH_COPY) {
+        patch_state = PATCH_ST_OPCODE;
+        return patch_copy(off, len);
+    }
+    patch_old_off = off;
+    patch_remain = len;
+    patch_state = len ? PATCH_ST_DATA : PATCH_ST_OPCODE;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_patch_begin(void)
+{
+    patch_state = PATCH_ST_HEADER;
+    patch_field_len = 0;
+    patch_field_need = PATCH_HDR_SIZE;
+    patch_out_total = 0;
+    patch_buf_len = 0;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_patch_write(const uint8_t *data, uint32_t len)
+{
+    uint32_t chunk;
+    t_flash_err err = FLASH_ERR_NONE;
+
+    if (data == NULL || patch_state == PATCH_ST_ERROR) {
+        return FLASH_ERR_INVAL;
+    }
+    while (len > 0 && err == FLASH_ERR_NONE) {
+        switch (patch_state) {
+            case PATCH_ST_OPCODE:
+                patch_op = *data++;
+                len--;
+                if (patch_op < FLASH_PATCH_COPY || patch_op > FLASH_PATCH_INSERT) {
+                    err = FLASH_ERR_INVAL;
+                    break;
+                }
+                patch_field_len = 0;
+                patch_field_need = (patch_op == FLASH_PATCH_INSERT) ? 4 : 8;
+                patch_state = PATCH_ST_ARGS;
+                break;
+            case PATCH_ST_HEADER:
+            case PATCH_ST_ARGS:
+                chunk = patch_field_need - patch_field_len;
+                chunk = len < chunk ? len : chunk;
+                memcpy(&patch_field[patch_field_len], data, chunk);
+                patch_field_len += chunk;
+                data += chunk;
+                len -= chunk;
+                if (patch_field_len < patch_field_need) {
+                    break;
+                }
+                if (patch_state == PATCH_ST_HEADER) {
+                    err = patch_header();
+                    patch_state = PATCH_ST_OPCODE;
+                } else {
+                    err = patch_operation();
+                }
+                break;
+            case PATCH_ST_DATA:
+                chunk = len < patch_remain ? len : patch_remain;
+                err = patch_data(data, chunk);
+                data += chunk;
+                len -= chunk;
+                patch_remain -= chunk;
+                if (patch_remain == 0) {
+                    patch_state = PATCH_ST_OPCODE;
+                }
+                break;
+            default:
+                err = FLASH_ERR_INVAL;
+                break;
+        }
+    }
+    if (err != FLASH_ERR_NONE) {
+        /* the patch must be restarted */
+        patch_state = PATCH_ST_ERROR;
+    }
+    return err;
+}
+
+t_flash_err flash_patch_finish(void)
+{
+    t_flash_err err;
+
+    if (patch_state != PATCH_ST_OPCODE || patch_out_total != patch_size) {
+        patch_state = PATCH_ST_ERROR;
+        return FLASH_ERR_INVAL;
+    }
+    patch_state = PATCH_ST_ERROR;
+    if ((err = patch_flush()) != FLASH_ERR_NONE) {
+        return err;
+    }
+    return flash_fw_finish(patch_crc);
+}
+
+#endif
@@ -121,23 +121,46 @@
 #endif
 
 
+/* device electronic signature: flash size in kB, upper half word at 0x1FFF7A22 */
+#define r_CORTEX_M_FLASH_SIZE		REG_ADDR(0x1FFF7A20)
+#define FLASH_SIZE_KB_Pos		16
+#define FLASH_SIZE_KB_Msk		((uint32_t)0xFFFF << FLASH_SIZE_KB_Pos)
+
+#if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+/*
+ * Flash geometry, detected by flash_init(). Each bank starts with four 16kB
+ * sectors, one 64kB sector, then 128kB sectors. Bank 2 sectors are numbered
+ * from 12.
+ */
+typedef struct {
+    uint32_t size;          /* whole flash size */
+    uint32_t bank2;         /* bank 2 offset, 0 in single bank mode */
+    uint32_t sectors;       /* existing sectors, bit n for sector n */
+} t_flash_geometry;
+
+extern t_flash_geometry flash_geometry;
+#endif
+
 /* return true if the the address is in the flash memory */
-#if CONFIG_USR_DRV_FLASH_1M
+#if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+# define IS_IN_FLASH(addr)		(((addr) >= FLASH_SECTOR_0) && \
+					((addr) - FLASH_SECTOR_0 < flash_geometry.size))
+#elif CONFIG_USR_DRV_FLASH_1M
 # if CONFIG_USR_DRV_FLASH_DUAL_BANK
-#  define IS_IN_FLASH(addr)		(addr >= FLASH_SECTOR_0) && \
-					(addr <= FLASH_SECTOR_19_END)
+#  define IS_IN_FLASH(addr)		(((addr) >= FLASH_SECTOR_0) && \
+					((addr) <= FLASH_SECTOR_19_END))
 # else
-#  define IS_IN_FLASH(addr)		(addr >= FLASH_SECTOR_0) && \
-					(addr <= FLASH_SECTOR_11_END)
+#  define IS_IN_FLASH(addr)		(((addr) >= FLASH_SECTOR_0) && \
+					((addr) <= FLASH_SECTOR_11_END))
 # endif
 #elif CONFIG_USR_DRV_FLASH_2M
-#  define IS_IN_FLASH(addr)		(addr >= FLASH_SECTOR_0) && \
-					(addr <= FLASH_SECTOR_23_END)
+#  define IS_IN_FLASH(addr)		(((addr) >= FLASH_SECTOR_0) && \
+					((addr) <= FLASH_SECTOR_23_END))
 #else
 # error "Unkown flash size!"
 #endif
 
-#define FLASH_SECTOR_SIZE(sector)  (FLASH_SECTOR_##sector##_END-FLASH_SECTOR_##sector)
+#define FLASH_SECTOR_SIZE(sector)  (FLASH_SECTOR_##sector##_END-FLASH_SECTOR_##sector+1)
 
 /*******************  Bits definition for FLASH_ACR register  *****************/
 #define FLASH_ACR_LATENCY                    ((uint32_t)0x00000007)
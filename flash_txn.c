@@ -0,0 +1,362 @@
+/** @file flash_txn.c
+ * \brief Power-fail safe transactional update of a flash region
+ */
+
+#include "autoconf.h"
+
+#if CONFIG_USR_DRV_FLASH_TXN
+
+#include "api/libflash.h"
+#include "api/flash_txn.h"
+#include "libc/stdio.h"
+#include "libc/string.h"
+
+#define FLASH_TXN_DEBUG 0
+
+/* Primitive for debug output */
+#if FLASH_TXN_DEBUG
+#define log_printf(...) printf(__VA_ARGS__)
+#else
+#define log_printf(...)
+#endif
+
+/*
+ * The journal is made of two sectors, used in turn. Each one starts with a
+ * header (magic, sequence number and its complement, the magic being
+ * programmed last), the current journal sector being the valid one with the
+ * highest sequence number. The other one is only erased when the current
+ * one is full, all its transactions being then complete or dropped: an
+ * interrupted erase never touches the records to replay.
+ *
+ * Journal records, one per transaction, follow the header:
+ * - word 0: FLASH_TXN_BEGIN, programmed by flash_txn_begin()
+ * - word 1: bitmask of the updated region sectors, and its complement in
+ *   the upper 16 bits
+ * - word 2: commit marker (0), the commit point of the transaction
+ * - word 3: done marker (0), once the shadow sectors are copied
+ * The commit and done markers are fully programmed words, a marker
+ * interrupted by a power loss is not taken into account. A transaction
+ * starts once the previous one is complete or dropped, so that only the
+ * last record of the current journal sector is replayed.
+ */
+#define FLASH_TXN_MAGIC         0x54584A31
+#define FLASH_TXN_HDR_SIZE      16
+#define FLASH_TXN_BEGIN         0x54584E31
+#define FLASH_TXN_MARKER        0x00000000
+#define FLASH_TXN_REC_SIZE      16
+
+#define TXN_REC_BEGIN           0
+#define TXN_REC_MASK            1
+#define TXN_REC_COMMIT          2
+#define TXN_REC_DONE            3
+
+#define TXN_MASK_WORD(mask)     (((mask) & 0xffff) | ((~(mask) & 0xffff) << 16))
+#define TXN_MASK_IS_VALID(word) (((word) >> 16) == (~(word) & 0xffff))
+
+static t_flash_txn_region txn_region;
+static bool txn_ready = false;
+static bool txn_active = false;
+/* committed transaction whose copy failed, to complete before the next one */
+static bool txn_pending = false;
+/* current journal sector (index in txn_region.journal) and its sequence */
+static uint8_t txn_cur = 0;
+static uint32_t txn_seq = 0;
+/* offset of the current (or next) journal record */
+static uint32_t txn_rec_off = 0;
+/* sectors staged in the current transaction, and their write cursors */
+static uint32_t txn_mask = 0;
+static uint32_t txn_cursor[FLASH_TXN_MAX_SECTORS];
+
+static inline physaddr_t txn_journal_addr(uint32_t word)
+{
+    return flash_sector_addr(txn_region.journal[txn_cur]) + txn_rec_off + 4 * word;
+}
+
+/* read a journal sector header, valid is false if it isn't formatted */
+static t_flash_err txn_read_header(uint8_t idx, uint32_t *seq, bool *valid)
+{
+    uint32_t hdr[3];
+    t_flash_err err;
+
+    err = flash_read((uint8_t*)hdr, flash_sector_addr(txn_region.journal[idx]), sizeof(hdr));
+    if (err != FLASH_ERR_NONE) {
+        return err;
+    }
+    *seq = hdr[1];
+    *valid = hdr[0] == FLASH_TXN_MAGIC && hdr[1] == ~hdr[2];
+    return FLASH_ERR_NONE;
+}
+
+/* erase a journal sector and make it the current one */
+static t_flash_err txn_format(uint8_t idx, uint32_t seq)
+{
+    uint32_t hdr[3] = { FLASH_TXN_MAGIC, seq, ~seq };
+    physaddr_t addr = flash_sector_addr(txn_region.journal[idx]);
+    t_flash_err err;
+
+    if (flash_sector_erase(addr) == 0xff) {
+        return flash_get_last_error();
+    }
+    err = flash_write(addr + 4, (uint8_t*)&hdr[1], 8);
+    if (err == FLASH_ERR_NONE) {
+        err = flash_write(addr, (uint8_t*)&hdr[0], 4);
+    }
+    if (err != FLASH_ERR_NONE) {
+        return err;
+    }
+    txn_cur = idx;
+    txn_seq = seq;
+    txn_rec_off = FLASH_TXN_HDR_SIZE;
+    return FLASH_ERR_NONE;
+}
+
+static t_flash_err txn_mark(uint32_t word, uint32_t value)
+{
+    return flash_write(txn_journal_addr(word), (uint8_t*)&value, sizeof(value));
+}
+
+/* copy the current region content of [from, to[ into the shadow sector */
+static t_flash_err txn_fill(uint8_t idx, uint32_t from, uint32_t to)
+{
+    physaddr_t src = flash_sector_addr(txn_region.sectors[idx]);
+    physaddr_t dst = flash_sector_addr(txn_region.shadows[idx]);
+    uint8_t buf[64];
+    uint32_t chunk;
+    t_flash_err err;
+
+    while (from < to) {
+        chunk = (to - from) < sizeof(buf) ? (to - from) : sizeof(buf);
+        if ((err = flash_read(buf, src + from, chunk)) != FLASH_ERR_NONE ||
+            (err = flash_write(dst + from, buf, chunk)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        from += chunk;
+    }
+    return FLASH_ERR_NONE;
+}
+
+/* copy the shadow sectors of the committed transaction to the region */
+static t_flash_err txn_apply(uint32_t mask)
+{
+    t_flash_err err;
+
+    for (uint8_t i = 0; i < txn_region.nb_sectors; ++i) {
+        if (!(mask & (1u << i))) {
+            continue;
+        }
+        err = flash_copy_sector(flash_sector_addr(txn_region.sectors[i]),
+                                flash_sector_addr(txn_region.shadows[i]));
+        if (err != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    return txn_mark(TXN_REC_DONE, FLASH_TXN_MARKER);
+}
+
+t_flash_err flash_txn_init(const t_flash_txn_region *region)
+{
+    uint32_t journal_size;
+    uint32_t rec[4];
+    uint32_t last[4];
+    uint32_t seq[2];
+    bool valid[2];
+    uint32_t size;
+    t_flash_err err;
+
+    txn_ready = false;
+    txn_active = false;
+    txn_pending = false;
+    if (region == NULL || region->nb_sectors == 0 ||
+        region->nb_sectors > FLASH_TXN_MAX_SECTORS) {
+        return FLASH_ERR_INVAL;
+    }
+    journal_size = flash_sector_size(region->journal[0]);
+    if (journal_size == 0 || journal_size != flash_sector_size(region->journal[1]) ||
+        region->journal[0] == region->journal[1]) {
+        return FLASH_ERR_INVAL;
+    }
+    for (uint8_t i = 0; i < region->nb_sectors; ++i) {
+        size = flash_sector_size(region->sectors[i]);
+        if (size == 0 || size != flash_sector_size(region->shadows[i])) {
+            return FLASH_ERR_INVAL;
+        }
+    }
+    txn_region = *region;
+
+    for (uint8_t i = 0; i < 2; ++i) {
+        if ((err = txn_read_header(i, &seq[i], &valid[i])) != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    if (!valid[0] && !valid[1]) {
+        log_printf("txn: formatting the journal\n");
+        if ((err = txn_format(0, 1)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        txn_ready = true;
+        return FLASH_ERR_NONE;
+    }
+    txn_cur = (valid[1] && (!valid[0] || seq[1] > seq[0])) ? 1 : 0;
+    txn_seq = seq[txn_cur];
+
+    /* find the last record, the ones after it being erased */
+    memset(last, 0xff, sizeof(last));
+    for (txn_rec_off = FLASH_TXN_HDR_SIZE; txn_rec_off < journal_size;
+         txn_rec_off += FLASH_TXN_REC_SIZE) {
+        if ((err = flash_read((uint8_t*)rec, txn_journal_addr(0), sizeof(rec))) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (rec[0] == 0xffffffff && rec[1] == 0xffffffff &&
+            rec[2] == 0xffffffff && rec[3] == 0xffffffff) {
+            break;
+        }
+        memcpy(last, rec, sizeof(last));
+    }
+    if (last[TXN_REC_BEGIN] == FLASH_TXN_BEGIN &&
+        TXN_MASK_IS_VALID(last[TXN_REC_MASK]) &&
+        last[TXN_REC_COMMIT] == FLASH_TXN_MARKER &&
+        last[TXN_REC_DONE] != FLASH_TXN_MARKER) {
+        /* committed, but interrupted while copying: copy again */
+        log_printf("txn: completing interrupted transaction\n");
+        txn_rec_off -= FLASH_TXN_REC_SIZE;
+        if ((err = txn_apply(last[TXN_REC_MASK] & 0xffff)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        txn_rec_off += FLASH_TXN_REC_SIZE;
+    }
+    txn_ready = true;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_txn_begin(void)
+{
+    t_flash_err err;
+
+    if (!txn_ready || txn_active) {
+        return FLASH_ERR_INVAL;
+    }
+    if (txn_pending) {
+        if ((err = txn_apply(txn_mask)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        txn_pending = false;
+        txn_rec_off += FLASH_TXN_REC_SIZE;
+    }
+    if (txn_rec_off + FLASH_TXN_REC_SIZE > flash_sector_size(txn_region.journal[txn_cur])) {
+        /* all the previous transactions are complete or dropped */
+        if ((err = txn_format(txn_cur ^ 1, txn_seq + 1)) != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    err = txn_mark(TXN_REC_BEGIN, FLASH_TXN_BEGIN);
+    if (err != FLASH_ERR_NONE) {
+        txn_rec_off += FLASH_TXN_REC_SIZE;
+        return err;
+    }
+    txn_mask = 0;
+    txn_active = true;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_txn_write(physaddr_t addr, const uint8_t *buf, uint32_t size)
+{
+    physaddr_t start;
+    uint32_t sector_size, off, chunk;
+    uint8_t idx;
+    t_flash_err err;
+
+    if (!txn_active || buf == NULL) {
+        return FLASH_ERR_INVAL;
+    }
+    while (size > 0) {
+        for (idx = 0; idx < txn_region.nb_sectors; ++idx) {
+            start = flash_sector_addr(txn_region.sectors[idx]);
+            sector_size = flash_sector_size(txn_region.sectors[idx]);
+            if (addr >= start && addr < start + sector_size) {
+                break;
+            }
+        }
+        if (idx == txn_region.nb_sectors) {
+            /* out of the region */
+            return FLASH_ERR_INVAL;
+        }
+        if (!(txn_mask & (1u << idx))) {
+            /* first write to this sector: prepare its shadow */
+            if (flash_sector_erase(flash_sector_addr(txn_region.shadows[idx])) == 0xff) {
+                return flash_get_last_error();
+            }
+            txn_mask |= 1u << idx;
+            txn_cursor[idx] = 0;
+        }
+        off = addr - start;
+        if (off < txn_cursor[idx]) {
+            log_printf("txn: writes must be in increasing address order\n");
+            return FLASH_ERR_INVAL;
+        }
+        if ((err = txn_fill(idx, txn_cursor[idx], off)) != FLASH_ERR_NONE) {
+            return err;
+        }
+        chunk = (sector_size - off) < size ? (sector_size - off) : size;
+        err = flash_write(flash_sector_addr(txn_region.shadows[idx]) + off, buf, chunk);
+        if (err != FLASH_ERR_NONE) {
+            return err;
+        }
+        txn_cursor[idx] = off + chunk;
+        addr += chunk;
+        buf += chunk;
+        size -= chunk;
+    }
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_txn_commit(void)
+{
+    t_flash_err err;
+
+    if (!txn_active) {
+        return FLASH_ERR_INVAL;
+    }
+    /* complete the shadow sectors with the unmodified content */
+    for (uint8_t i = 0; i < txn_region.nb_sectors; ++i) {
+        if (!(txn_mask & (1u << i))) {
+            continue;
+        }
+        err = txn_fill(i, txn_cursor[i], flash_sector_size(txn_region.sectors[i]));
+        if (err != FLASH_ERR_NONE) {
+            goto err;
+        }
+    }
+    if ((err = txn_mark(TXN_REC_MASK, TXN_MASK_WORD(txn_mask))) != FLASH_ERR_NONE) {
+        goto err;
+    }
+    /* commit point */
+    if ((err = txn_mark(TXN_REC_COMMIT, FLASH_TXN_MARKER)) != FLASH_ERR_NONE) {
+        goto err;
+    }
+    txn_active = false;
+    if ((err = txn_apply(txn_mask)) != FLASH_ERR_NONE) {
+        /* committed: the copy is retried by the next flash_txn_begin() */
+        txn_pending = true;
+        return err;
+    }
+    txn_rec_off += FLASH_TXN_REC_SIZE;
+    return FLASH_ERR_NONE;
+err:
+    /* the transaction is dropped */
+    txn_active = false;
+    txn_rec_off += FLASH_TXN_REC_SIZE;
+    return err;
+}
+
+t_flash_err flash_txn_abort(void)
+{
+    if (!txn_active) {
+        return FLASH_ERR_INVAL;
+    }
+    /* an uncommitted record is ignored */
+    txn_active = false;
+    txn_rec_off += FLASH_TXN_REC_SIZE;
+    return FLASH_ERR_NONE;
+}
+
+#endif
@@ -0,0 +1,392 @@
+/** @file flash_wear.c
+ * \brief Per-sector erase counters and wear leveling sector allocator
+ *
+ * The STM32F4 flash sectors are rated for 10k erase cycles (see the
+ * datasheet flash endurance characteristics).
+ */
+
+#include "autoconf.h"
+
+#if CONFIG_USR_DRV_FLASH_WEAR
+
+#include "api/libflash.h"
+#include "api/flash_wear.h"
+#include "libc/stdio.h"
+#include "libc/string.h"
+#include "flash_hooks.h"
+
+#define FLASH_WEAR_DEBUG 0
+
+/* Primitive for debug output */
+#if FLASH_WEAR_DEBUG
+#define log_printf(...) printf(__VA_ARGS__)
+#else
+#define log_printf(...)
+#endif
+
+/*
+ * The counters are kept in two reserved sectors, used in turn. Each starts
+ * with a header: magic, sequence number, complemented sequence number, the
+ * magic being programmed last. The current sector is the valid one with the
+ * highest sequence number.
+ *
+ * Counter records, appended to the current sector after its header:
+ * - word 0: FLASH_WEAR_TAG | complemented sector number << 8 | sector number
+ * - word 1: sector erase count
+ * The count is programmed first, so that a record interrupted by a power
+ * loss has no valid tag and is skipped. A partially programmed tag has bits
+ * left to 1: the complemented sector number no longer matches, even if the
+ * magic part is complete.
+ *
+ * When the current sector is full, the counters are compacted into the
+ * other one: it is erased, one record per sector is written, then its
+ * header, with the next sequence number. Until its magic is programmed,
+ * the previous sector remains the current one, so that a power loss
+ * during the compaction loses no counter.
+ */
+#define FLASH_WEAR_MAGIC        0x57454132
+#define FLASH_WEAR_HDR_SIZE     16
+#define FLASH_WEAR_TAG          0x57450000
+#define FLASH_WEAR_TAG_MSK      0xffff0000
+#define FLASH_WEAR_RECORD_SIZE  8
+
+static inline uint32_t flash_wear_tag(uint8_t sector)
+{
+    return FLASH_WEAR_TAG | ((uint32_t)(uint8_t)~sector << 8) | sector;
+}
+
+/* sector of a record tag, -1 if the tag is invalid */
+static inline int flash_wear_tag_sector(uint32_t tag)
+{
+    if ((tag & FLASH_WEAR_TAG_MSK) != FLASH_WEAR_TAG ||
+        tag != flash_wear_tag(tag & 0xff)) {
+        return -1;
+    }
+    return (int)(tag & 0xff);
+}
+
+static const uint8_t wear_sectors[2] = {
+    CONFIG_USR_DRV_FLASH_WEAR_SECTOR,
+    CONFIG_USR_DRV_FLASH_WEAR_SECTOR2,
+};
+
+static uint32_t wear_count[FLASH_WEAR_NB_SECTORS];
+static bool wear_loaded = false;
+/*
+ * current counters sector (index in wear_sectors), its sequence number and
+ * the offset of its next free record
+ */
+static uint8_t wear_cur = 0;
+static uint32_t wear_seq = 0;
+static uint32_t wear_next = 0;
+/* set while compacting, the erase hook then only counting the erase */
+static bool wear_compacting = false;
+
+/* allocator state: pool and allocated sectors bitmasks */
+static uint32_t wear_pool = 0;
+static uint32_t wear_used = 0;
+static uint8_t wear_last = FLASH_WEAR_NB_SECTORS - 1;
+
+static inline bool flash_wear_is_valid(uint8_t sector)
+{
+    return sector < FLASH_WEAR_NB_SECTORS && flash_sector_size(sector) != 0;
+}
+
+static inline bool flash_wear_is_reserved(uint8_t sector)
+{
+    return sector == wear_sectors[0] || sector == wear_sectors[1];
+}
+
+static inline physaddr_t flash_wear_addr(uint8_t idx)
+{
+    return flash_sector_addr(wear_sectors[idx]);
+}
+
+static bool flash_wear_is_blank(physaddr_t addr, uint32_t size)
+{
+    uint32_t buf[16];
+    uint32_t chunk;
+
+    while (size > 0) {
+        chunk = size < sizeof(buf) ? size : sizeof(buf);
+        if (flash_read((uint8_t*)buf, addr, chunk) != FLASH_ERR_NONE) {
+            return false;
+        }
+        for (uint32_t i = 0; i < chunk; ++i) {
+            if (((uint8_t*)buf)[i] != 0xff) {
+                return false;
+            }
+        }
+        addr += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+t_flash_err flash_wear_init(void)
+{
+    uint32_t size = flash_sector_size(wear_sectors[0]);
+    uint32_t hdr[3];
+    uint32_t rec[2];
+    uint32_t off;
+    int sector;
+    bool found = false;
+    t_flash_err err;
+
+    if (size == 0 || flash_sector_size(wear_sectors[1]) != size ||
+        wear_sectors[0] == wear_sectors[1]) {
+        log_printf("wear: invalid counters sectors\n");
+        return FLASH_ERR_INVAL;
+    }
+    memset(wear_count, 0, sizeof(wear_count));
+    wear_compacting = false;
+    for (uint8_t i = 0; i < 2; ++i) {
+        if ((err = flash_read((uint8_t*)hdr, flash_wear_addr(i), sizeof(hdr))) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (hdr[0] == FLASH_WEAR_MAGIC && hdr[1] == ~hdr[2] &&
+            (!found || hdr[1] > wear_seq)) {
+            wear_cur = i;
+            wear_seq = hdr[1];
+            found = true;
+        }
+    }
+    if (!found) {
+        /* no counters yet: the first record compacts into the first sector */
+        wear_cur = 1;
+        wear_seq = 0;
+        wear_next = size;
+        wear_loaded = true;
+        return FLASH_ERR_NONE;
+    }
+    for (off = FLASH_WEAR_HDR_SIZE; off < size; off += FLASH_WEAR_RECORD_SIZE) {
+        if ((err = flash_read((uint8_t*)rec, flash_wear_addr(wear_cur) + off, sizeof(rec))) != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (rec[0] == 0xffffffff && rec[1] == 0xffffffff) {
+            /* end of the records */
+            break;
+        }
+        sector = flash_wear_tag_sector(rec[0]);
+        if (sector >= 0 && sector < FLASH_WEAR_NB_SECTORS) {
+            /* last record of a sector holds its current count */
+            wear_count[sector] = rec[1];
+        }
+    }
+    wear_next = off;
+    wear_loaded = true;
+    return FLASH_ERR_NONE;
+}
+
+static t_flash_err flash_wear_write_record(uint8_t sector)
+{
+    physaddr_t addr = flash_wear_addr(wear_cur) + wear_next;
+    uint32_t tag = flash_wear_tag(sector);
+    t_flash_err err;
+
+    /* the record slot is consumed, even if partially written */
+    wear_next += FLASH_WEAR_RECORD_SIZE;
+    err = flash_write(addr + 4, (uint8_t*)&wear_count[sector], 4);
+    if (err == FLASH_ERR_NONE) {
+        err = flash_write(addr, (uint8_t*)&tag, 4);
+    }
+    return err;
+}
+
+/*
+ * Write all the counters into the given sector, which must be erased, and
+ * make it the current one.
+ */
+static t_flash_err flash_wear_rewrite(uint8_t idx)
+{
+    uint32_t hdr[3] = { FLASH_WEAR_MAGIC, wear_seq + 1, ~(wear_seq + 1) };
+    physaddr_t base = flash_wear_addr(idx);
+    t_flash_err err;
+
+    wear_cur = idx;
+    wear_next = FLASH_WEAR_HDR_SIZE;
+    for (uint8_t sector = 0; sector < FLASH_WEAR_NB_SECTORS; ++sector) {
+        if (wear_count[sector] != 0 &&
+            (err = flash_wear_write_record(sector)) != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    err = flash_write(base + 4, (uint8_t*)&hdr[1], 8);
+    if (err == FLASH_ERR_NONE) {
+        err = flash_write(base, (uint8_t*)&hdr[0], 4);
+    }
+    if (err != FLASH_ERR_NONE) {
+        return err;
+    }
+    wear_seq++;
+    return FLASH_ERR_NONE;
+}
+
+/* compact the counters into the other reserved sector */
+static t_flash_err flash_wear_compact(void)
+{
+    uint8_t idx = wear_cur ^ 1;
+    uint8_t ret;
+
+    log_printf("wear: compacting counters into sector %d\n", wear_sectors[idx]);
+    if (!flash_wear_is_blank(flash_wear_addr(idx), flash_sector_size(wear_sectors[idx]))) {
+        /*
+         * Erasing the other sector calls back flash_wear_sector_erased()
+         * for it: while compacting, the hook only counts the erase, the
+         * counter being saved by the rewrite, without recursing into a
+         * compaction.
+         */
+        wear_compacting = true;
+        ret = flash_sector_erase(flash_wear_addr(idx));
+        wear_compacting = false;
+        if (ret == 0xff) {
+            return flash_get_last_error();
+        }
+    }
+    return flash_wear_rewrite(idx);
+}
+
+static t_flash_err flash_wear_append(uint8_t sector)
+{
+    uint32_t size = flash_sector_size(wear_sectors[wear_cur]);
+
+    if (wear_next + FLASH_WEAR_RECORD_SIZE > size) {
+        /* full: the compaction saves all the counters */
+        return flash_wear_compact();
+    }
+    return flash_wear_write_record(sector);
+}
+
+void flash_wear_sector_erased(uint8_t sector)
+{
+    t_flash_err err;
+
+    if (sector >= FLASH_WEAR_NB_SECTORS) {
+        return;
+    }
+    if (!wear_loaded && flash_wear_init() != FLASH_ERR_NONE) {
+        return;
+    }
+    wear_count[sector]++;
+    if (wear_compacting) {
+        return;
+    }
+    if (sector == wear_sectors[wear_cur]) {
+        /* the current counters are lost: rewrite them in place */
+        err = flash_wear_rewrite(wear_cur);
+    } else {
+        err = flash_wear_append(sector);
+    }
+    if (err != FLASH_ERR_NONE) {
+        log_printf("wear: unable to save sector %d counter\n", sector);
+    }
+}
+
+void flash_wear_bank_erased(uint8_t bank)
+{
+    uint8_t first = bank ? 12 : 0;
+    bool rewrite = false;
+
+    if (!wear_loaded && flash_wear_init() != FLASH_ERR_NONE) {
+        return;
+    }
+    for (uint8_t sector = first; sector < first + 12; ++sector) {
+        if (flash_wear_is_valid(sector)) {
+            wear_count[sector]++;
+            if (sector == wear_sectors[wear_cur]) {
+                rewrite = true;
+            }
+        }
+    }
+    if (rewrite) {
+        if (flash_wear_rewrite(wear_cur) != FLASH_ERR_NONE) {
+            log_printf("wear: unable to save the counters\n");
+        }
+        return;
+    }
+    for (uint8_t sector = first; sector < first + 12; ++sector) {
+        if (flash_wear_is_valid(sector) &&
+            flash_wear_append(sector) != FLASH_ERR_NONE) {
+            log_printf("wear: unable to save sector %d counter\n", sector);
+        }
+    }
+}
+
+uint32_t flash_wear_get_count(uint8_t sector)
+{
+    if (!wear_loaded && flash_wear_init() != FLASH_ERR_NONE) {
+        return 0;
+    }
+    if (sector >= FLASH_WEAR_NB_SECTORS) {
+        return 0;
+    }
+    return wear_count[sector];
+}
+
+t_flash_err flash_wear_set_pool(uint32_t sectors)
+{
+    for (uint8_t sector = 0; sector < 32; ++sector) {
+        if (!(sectors & (1u << sector))) {
+            continue;
+        }
+        if (!flash_wear_is_valid(sector) || flash_wear_is_reserved(sector)) {
+            return FLASH_ERR_INVAL;
+        }
+    }
+    wear_pool = sectors;
+    wear_used = 0;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_wear_reserve(uint8_t sector)
+{
+    if (sector >= FLASH_WEAR_NB_SECTORS || !(wear_pool & (1u << sector))) {
+        return FLASH_ERR_INVAL;
+    }
+    wear_used |= 1u << sector;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_wear_alloc(uint8_t *sector)
+{
+    uint32_t free = wear_pool & ~wear_used;
+    uint8_t best = FLASH_WEAR_NB_SECTORS;
+    uint8_t s;
+    t_flash_err err;
+
+    if (sector == NULL) {
+        return FLASH_ERR_INVAL;
+    }
+    if (!wear_loaded && (err = flash_wear_init()) != FLASH_ERR_NONE) {
+        return err;
+    }
+    /* scan from the last allocated sector, so that equally worn sectors
+     * are handed out in turn */
+    for (uint8_t i = 1; i <= FLASH_WEAR_NB_SECTORS; ++i) {
+        s = (wear_last + i) % FLASH_WEAR_NB_SECTORS;
+        if (!(free & (1u << s))) {
+            continue;
+        }
+        if (best == FLASH_WEAR_NB_SECTORS || wear_count[s] < wear_count[best]) {
+            best = s;
+        }
+    }
+    if (best == FLASH_WEAR_NB_SECTORS) {
+        return FLASH_ERR_NOSPACE;
+    }
+    wear_used |= 1u << best;
+    wear_last = best;
+    *sector = best;
+    return FLASH_ERR_NONE;
+}
+
+t_flash_err flash_wear_release(uint8_t sector)
+{
+    if (sector >= FLASH_WEAR_NB_SECTORS || !(wear_used & (1u << sector))) {
+        return FLASH_ERR_INVAL;
+    }
+    wear_used &= ~(1u << sector);
+    return FLASH_ERR_NONE;
+}
+
+#endif
@@ -0,0 +1,901 @@
+/** @file flash_sim.c
+ * \brief Host-side register level simulator of the STM32F4 flash controller
+ *
+ * See flash_sim.h for the modelled behavior. Register semantics follow
+ * RM0090 (DocID018909 Rev 13) part 3.
+ */
+
+#define _GNU_SOURCE
+#include <sys/mman.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "flash_sim.h"
+#include "api/libflash.h"
+#include "flash_regs.h"
+#include "flash_backend.h"
+
+/* register offsets in the flash interface */
+#define SIM_REG_ACR             0x00
+#define SIM_REG_KEYR            0x04
+#define SIM_REG_OPTKEYR         0x08
+#define SIM_REG_SR              0x0C
+#define SIM_REG_CR              0x10
+#define SIM_REG_OPTCR           0x14
+#define SIM_REG_OPTCR1          0x18
+
+/* factory option bytes (OPTCR without OPTLOCK/OPTSTRT, and OPTCR1) */
+#if CONFIG_USR_DRV_FLASH_1M && CONFIG_USR_DRV_FLASH_DUAL_BANK
+# define SIM_OPT_DEFAULT        0x4FFFAAEC      /* DB1M set */
+#else
+# define SIM_OPT_DEFAULT        0x0FFFAAEC
+#endif
+#define SIM_OPT1_DEFAULT        0x0FFF0000
+
+#define SIM_SR_ERRORS           (FLASH_SR_OPERR_Msk | FLASH_SR_WRPERR_Msk | \
+                                 FLASH_SR_PGAERR_Msk | FLASH_SR_PGPERR_Msk | \
+                                 FLASH_SR_PGSERR_Msk | (1 << 8))
+
+typedef struct {
+    uint8_t num;
+    physaddr_t start;
+    physaddr_t end;
+} sim_sector_t;
+
+static const sim_sector_t sim_sectors[] = {
+    {  0, FLASH_SECTOR_0,  FLASH_SECTOR_0_END },
+    {  1, FLASH_SECTOR_1,  FLASH_SECTOR_1_END },
+    {  2, FLASH_SECTOR_2,  FLASH_SECTOR_2_END },
+    {  3, FLASH_SECTOR_3,  FLASH_SECTOR_3_END },
+    {  4, FLASH_SECTOR_4,  FLASH_SECTOR_4_END },
+    {  5, FLASH_SECTOR_5,  FLASH_SECTOR_5_END },
+    {  6, FLASH_SECTOR_6,  FLASH_SECTOR_6_END },
+    {  7, FLASH_SECTOR_7,  FLASH_SECTOR_7_END },
+#if (CONFIG_USR_DRV_FLASH_1M && !CONFIG_USR_DRV_FLASH_DUAL_BANK) || CONFIG_USR_DRV_FLASH_2M
+    {  8, FLASH_SECTOR_8,  FLASH_SECTOR_8_END },
+    {  9, FLASH_SECTOR_9,  FLASH_SECTOR_9_END },
+    { 10, FLASH_SECTOR_10, FLASH_SECTOR_10_END },
+    { 11, FLASH_SECTOR_11, FLASH_SECTOR_11_END },
+#endif
+#if (CONFIG_USR_DRV_FLASH_1M && CONFIG_USR_DRV_FLASH_DUAL_BANK) || CONFIG_USR_DRV_FLASH_2M
+    { 12, FLASH_SECTOR_12, FLASH_SECTOR_12_END },
+    { 13, FLASH_SECTOR_13, FLASH_SECTOR_13_END },
+    { 14, FLASH_SECTOR_14, FLASH_SECTOR_14_END },
+    { 15, FLASH_SECTOR_15, FLASH_SECTOR_15_END },
+    { 16, FLASH_SECTOR_16, FLASH_SECTOR_16_END },
+    { 17, FLASH_SECTOR_17, FLASH_SECTOR_17_END },
+    { 18, FLASH_SECTOR_18, FLASH_SECTOR_18_END },
+    { 19, FLASH_SECTOR_19, FLASH_SECTOR_19_END },
+#endif
+#if CONFIG_USR_DRV_FLASH_2M
+    { 20, FLASH_SECTOR_20, FLASH_SECTOR_20_END },
+    { 21, FLASH_SECTOR_21, FLASH_SECTOR_21_END },
+    { 22, FLASH_SECTOR_22, FLASH_SECTOR_22_END },
+    { 23, FLASH_SECTOR_23, FLASH_SECTOR_23_END },
+#endif
+};
+
+#define SIM_NB_SECTORS  (sizeof(sim_sectors) / sizeof(sim_sector_t))
+
+static struct {
+    /* registers */
+    uint32_t acr;
+    uint32_t sr;
+    uint32_t cr;
+    uint32_t optcr;
+    uint32_t optcr1;
+    /* non volatile option bytes */
+    uint32_t opt;
+    uint32_t opt1;
+    /* flash size reported by the device signature */
+    uint32_t dev_size;
+    /* unlock sequences state */
+    uint8_t key_step;
+    uint8_t optkey_step;
+    bool cr_hard_locked;
+    bool optcr_hard_locked;
+    /* memory: physical view (bank 1 first), and bus mapping of the banks */
+    uint8_t *mem;
+    int mem_fd;
+    bool swapped;
+    uint8_t otp[FLASH_OTP_SIZE];
+    /* virtual clock, end of the current operation and timing model */
+    uint64_t clock;
+    uint64_t busy_until;
+    bool hang_next;
+    flash_sim_vrange_t vrange;
+    flash_sim_timing_t timing;
+    /* statistics */
+    uint64_t program_count;
+    uint64_t erase_count;
+    /* operation recorder */
+    flash_sim_trace_t trace;
+    /* power loss injection */
+    bool powered;
+    uint64_t op_count;
+    uint64_t cut_op;
+    uint64_t cut_clock;
+    void (*cut_handler)(void);
+    uint32_t seed;
+    /* current operation, and memory content before it (when a cut is armed) */
+    uint64_t op_start;
+    bool op_is_opt;
+    uint32_t opt_prev;
+    uint32_t opt1_prev;
+    physaddr_t snap_addr;
+    uint32_t snap_size;
+    uint8_t *snap;
+} sim;
+
+static void sim_power_cut(uint32_t progress);
+
+/*
+ * Timing model. Program and erase durations, in microseconds, are the
+ * typical and max values of the STM32F42x/43x datasheet flash programming
+ * characteristics, for each parallelism (PSIZE x8, x16, x32 and x64, the
+ * latter requiring the external Vpp). Option bytes programming is not
+ * specified and is modelled as a 16 KB sector erase.
+ */
+typedef enum {
+    SIM_OP_PROGRAM = 0,
+    SIM_OP_ERASE_16K,
+    SIM_OP_ERASE_64K,
+    SIM_OP_ERASE_128K,
+    SIM_OP_ERASE_BANK,
+    SIM_OP_ERASE_MASS,
+    SIM_OP_NB
+} sim_op_t;
+
+static const uint32_t sim_durations[SIM_OP_NB][4][2] = {
+    /*                     x8                     x16                    x32                   x64 */
+    [SIM_OP_PROGRAM]    = { {      16,      100 }, {      16,      100 }, {      16,      100 }, {      16,      100 } },
+    [SIM_OP_ERASE_16K]  = { {  400000,   800000 }, {  300000,   600000 }, {  250000,   500000 }, {  230000,   500000 } },
+    [SIM_OP_ERASE_64K]  = { { 1200000,  2400000 }, {  700000,  1400000 }, {  550000,  1100000 }, {  490000,  1100000 } },
+    [SIM_OP_ERASE_128K] = { { 2000000,  4000000 }, { 1300000,  2600000 }, { 1000000,  2000000 }, {  875000,  2000000 } },
+    [SIM_OP_ERASE_BANK] = { { 8000000, 16000000 }, { 5500000, 11000000 }, { 4000000,  8000000 }, { 3450000,  8000000 } },
+    [SIM_OP_ERASE_MASS] = { {16000000, 32000000 }, {11000000, 22000000 }, { 8000000, 16000000 }, { 6900000, 16000000 } },
+};
+
+/*
+ * Each status register poll costs one microsecond of virtual time, which
+ * also gives the BSY flag resolution.
+ */
+#define SIM_POLL_COST_US        1
+
+/* default power cut pseudo random generator seed */
+#define SIM_SEED_DEFAULT        0x2545F491
+
+static inline bool sim_is_busy(void)
+{
+    return sim.clock < sim.busy_until;
+}
+
+static inline uint32_t sim_psize(void)
+{
+    return (sim.cr & FLASH_CR_PSIZE_Msk) >> FLASH_CR_PSIZE_Pos;
+}
+
+/* the supply voltage range gives the max usable parallelism */
+static inline bool sim_psize_allowed(uint32_t psize)
+{
+    return psize <= (uint32_t)sim.vrange;
+}
+
+/* xorshift32 pseudo random generator, for reproducible power cuts */
+static inline uint32_t sim_rand(void)
+{
+    sim.seed ^= sim.seed << 13;
+    sim.seed ^= sim.seed >> 17;
+    sim.seed ^= sim.seed << 5;
+    return sim.seed;
+}
+
+static inline bool sim_cut_armed(void)
+{
+    return sim.cut_op != 0 || sim.cut_clock != 0;
+}
+
+static inline void sim_start_op(sim_op_t op)
+{
+    sim.op_start = sim.clock;
+    sim.busy_until = sim.clock + sim_durations[op][sim_psize()][sim.timing];
+    if (sim.hang_next) {
+        sim.busy_until = UINT64_MAX;
+        sim.hang_next = false;
+    }
+    if (sim.cut_op != 0 && ++sim.op_count == sim.cut_op) {
+        /* random point of the operation */
+        sim_power_cut(sim_rand() & 0xffff);
+    }
+}
+
+/* the virtual clock may have reached the power cut time */
+static inline void sim_check_cut_clock(void)
+{
+    uint64_t duration = sim.busy_until - sim.op_start;
+
+    if (sim.cut_clock != 0 && sim.clock >= sim.cut_clock) {
+        sim_power_cut(duration == 0 || sim.cut_clock < sim.op_start ? 0 :
+                      (uint32_t)(((sim.cut_clock - sim.op_start) << 16) / duration));
+    }
+}
+
+static inline bool sim_is_otp(physaddr_t addr)
+{
+    return addr >= FLASH_SECTOR_OTP_AREA && addr <= FLASH_SECTOR_OTP_AREA_END;
+}
+
+/*
+ * Physical address of a bus address: when booted from bank 2 (BFB2 set at
+ * reset), the banks are swapped in the address space.
+ */
+static inline physaddr_t sim_phys(physaddr_t addr)
+{
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+    if (sim.swapped && addr >= FLASH_SIM_BASE && addr < FLASH_SIM_BASE + FLASH_SIM_SIZE) {
+        return addr < FLASH_SIM_BASE + FLASH_SIM_SIZE / 2 ? addr + FLASH_SIM_SIZE / 2
+                                                          : addr - FLASH_SIM_SIZE / 2;
+    }
+#endif
+    return addr;
+}
+
+/* memory of a physical address */
+static inline uint8_t *sim_ptr(physaddr_t addr)
+{
+    if (sim_is_otp(addr)) {
+        return sim.otp + (addr - FLASH_SECTOR_OTP_AREA);
+    }
+    return sim.mem + (addr - FLASH_SIM_BASE);
+}
+
+/* data byte of an OTP block whose lock byte is programmed to 0x00 */
+static bool sim_is_otp_locked(physaddr_t addr)
+{
+    uint32_t off = addr - FLASH_SECTOR_OTP_AREA;
+
+    return off < FLASH_OTP_LOCK_OFFSET &&
+           sim.otp[FLASH_OTP_LOCK_OFFSET + off / FLASH_OTP_BLOCK_SIZE] == 0x00;
+}
+
+static const sim_sector_t *sim_get_sector(physaddr_t addr)
+{
+    for (uint32_t i = 0; i < SIM_NB_SECTORS; ++i) {
+        if (addr >= sim_sectors[i].start && addr <= sim_sectors[i].end) {
+            return &sim_sectors[i];
+        }
+    }
+    return NULL;
+}
+
+static bool sim_nwrp(uint8_t num)
+{
+    if (num < 12) {
+        return !!(sim.opt & (1 << (FLASH_OPTCR_nWRP_Pos + num)));
+    }
+    return !!(sim.opt1 & (1 << (16 + num - 12)));
+}
+
+/* PCROP mode (SPRMOD set): nWRP set means read (and write) protected */
+static bool sim_is_pcrop(uint8_t num)
+{
+    return (sim.opt & (1u << 31)) && sim_nwrp(num);
+}
+
+/* nWRP bits are active low: 0 means write protected */
+static bool sim_is_write_protected(uint8_t num)
+{
+    if (sim.opt & (1u << 31)) {
+        return sim_is_pcrop(num);
+    }
+    return !sim_nwrp(num);
+}
+
+static void sim_erase_range(physaddr_t start, physaddr_t end)
+{
+    memset(sim_ptr(start), 0xff, end - start + 1);
+}
+
+/* save the memory content before an operation, when a cut is armed */
+static void sim_snapshot(physaddr_t addr, uint32_t size)
+{
+    sim.snap_size = 0;
+    if (!sim_cut_armed()) {
+        return;
+    }
+    if (sim.snap == NULL) {
+        sim.snap = malloc(FLASH_SIM_SIZE);
+        if (sim.snap == NULL) {
+            return;
+        }
+    }
+    memcpy(sim.snap, sim_ptr(addr), size);
+    sim.snap_addr = addr;
+    sim.snap_size = size;
+}
+
+/* random byte mask, each bit being set with the given probability (/65536) */
+static inline uint8_t sim_rand_mask(uint32_t proba)
+{
+    uint8_t mask = 0;
+
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+        if ((sim_rand() & 0xffff) < proba) {
+            mask |= 1 << bit;
+        }
+    }
+    return mask;
+}
+
+/*
+ * Interrupt the current operation, progress being the elapsed fraction of
+ * its duration (/65536). Each bit the operation was changing (cleared by a
+ * program, set by an erase) has reached its final value with a probability
+ * equal to the progress, leaving a partially programmed word or a partially
+ * erased, randomized, sector. An interrupted option bytes programming is
+ * not applied.
+ */
+static void sim_interrupt_op(uint32_t progress)
+{
+    uint8_t *mem;
+    uint8_t diff;
+
+    if (sim.op_is_opt) {
+        sim.opt = sim.opt_prev;
+        sim.opt1 = sim.opt1_prev;
+        return;
+    }
+    mem = sim_ptr(sim.snap_addr);
+    for (uint32_t i = 0; i < sim.snap_size; ++i) {
+        diff = sim.snap[i] ^ mem[i];
+        if (diff) {
+            mem[i] = sim.snap[i] ^ (diff & sim_rand_mask(progress));
+        }
+    }
+}
+
+/* power loss: interrupt the running operation, if any, and power off */
+static void sim_power_cut(uint32_t progress)
+{
+    if (sim_is_busy()) {
+        sim_interrupt_op(progress);
+    }
+    sim.powered = false;
+    sim.busy_until = sim.clock;
+    sim.cut_op = 0;
+    sim.cut_clock = 0;
+    sim.snap_size = 0;
+    if (sim.cut_handler != NULL) {
+        sim.cut_handler();
+    }
+}
+
+static inline void sim_trace(flash_sim_op_type_t type, physaddr_t addr, uint64_t value)
+{
+    flash_sim_op_t op;
+
+    if (sim.trace != NULL) {
+        op.type = type;
+        op.addr = addr;
+        op.value = value;
+        op.clock = sim.clock;
+        sim.trace(&op);
+    }
+}
+
+/*
+ * Program operation: check the controller state and the access, then apply
+ * the NOR rule (bits can only be cleared).
+ */
+static void sim_program(physaddr_t addr, uint64_t value, uint8_t size)
+{
+    uint32_t psize = sim_psize();
+    const sim_sector_t *sector;
+    bool otp = sim_is_otp(addr);
+    uint32_t err = 0;
+
+    addr = sim_phys(addr);
+    sector = sim_get_sector(addr);
+    if (!sim.powered) {
+        return;
+    }
+    if ((sector == NULL && !otp) || sim_is_busy() || (sim.cr & FLASH_CR_LOCK_Msk) ||
+        !(sim.cr & FLASH_CR_PG_Msk) ||
+        (sim.cr & (FLASH_CR_SER_Msk | FLASH_CR_MER_Msk))) {
+        err = FLASH_SR_PGSERR_Msk;
+    } else if (otp ? sim_is_otp_locked(addr) : sim_is_write_protected(sector->num)) {
+        err = FLASH_SR_WRPERR_Msk;
+    } else if (size != (1 << psize) || !sim_psize_allowed(psize)) {
+        /* access size must match the configured parallelism, which must be
+         * supported by the supply voltage range */
+        err = FLASH_SR_PGPERR_Msk;
+    } else if ((addr & 0xf) + size > 16) {
+        /* data must be contained in a single 128 bits row */
+        err = FLASH_SR_PGAERR_Msk;
+    }
+    if (err) {
+        sim.sr |= err;
+        return;
+    }
+    sim_snapshot(addr, size);
+    sim.op_is_opt = false;
+    for (uint8_t i = 0; i < size; ++i) {
+        sim_ptr(addr)[i] &= (uint8_t)(value >> (8 * i));
+    }
+    sim.program_count++;
+    sim_start_op(SIM_OP_PROGRAM);
+}
+
+static bool sim_erase_sector(uint32_t snb)
+{
+    uint8_t num = (snb & 0x10) ? 12 + (snb & 0xf) : (snb & 0xf);
+    uint32_t size;
+
+    for (uint32_t i = 0; i < SIM_NB_SECTORS; ++i) {
+        if (sim_sectors[i].num == num) {
+            if (sim_is_write_protected(num)) {
+                sim.sr |= FLASH_SR_WRPERR_Msk;
+                return false;
+            }
+            sim_erase_range(sim_sectors[i].start, sim_sectors[i].end);
+            sim.erase_count++;
+            size = sim_sectors[i].end - sim_sectors[i].start + 1;
+            sim_start_op(size == 0x4000 ? SIM_OP_ERASE_16K :
+                         size == 0x10000 ? SIM_OP_ERASE_64K : SIM_OP_ERASE_128K);
+            return true;
+        }
+    }
+    /* sector not existing in this geometry */
+    sim.sr |= FLASH_SR_PGSERR_Msk;
+    return false;
+}
+
+/* erase all the sectors of a bank (sectors 0-11 or 12-23) */
+static bool sim_erase_bank(uint8_t bank)
+{
+    for (uint32_t i = 0; i < SIM_NB_SECTORS; ++i) {
+        if ((sim_sectors[i].num >= 12) == (bank == 1)) {
+            if (sim_is_write_protected(sim_sectors[i].num)) {
+                sim.sr |= FLASH_SR_WRPERR_Msk;
+                return false;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < SIM_NB_SECTORS; ++i) {
+        if ((sim_sectors[i].num >= 12) == (bank == 1)) {
+            sim_erase_range(sim_sectors[i].start, sim_sectors[i].end);
+        }
+    }
+    sim.erase_count++;
+    return true;
+}
+
+/* MER1 only exists on dual bank devices, bit 15 being reserved otherwise */
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+# define SIM_CR_MER1            FLASH_CR_MER1_Msk
+#else
+# define SIM_CR_MER1            0
+#endif
+
+static void sim_start(void)
+{
+    uint32_t cr = sim.cr;
+    bool mer = !!(cr & FLASH_CR_MER_Msk);
+    bool mer1 = !!(cr & SIM_CR_MER1);
+
+    if ((cr & FLASH_CR_SER_Msk) && (mer || mer1)) {
+        sim.sr |= FLASH_SR_PGSERR_Msk;
+        return;
+    }
+    if (!sim_psize_allowed(sim_psize())) {
+        sim.sr |= FLASH_SR_PGPERR_Msk;
+        return;
+    }
+    if (cr & (FLASH_CR_SER_Msk | FLASH_CR_MER_Msk | SIM_CR_MER1)) {
+        sim_snapshot(FLASH_SIM_BASE, FLASH_SIM_SIZE);
+        sim.op_is_opt = false;
+    }
+    if (cr & FLASH_CR_SER_Msk) {
+        sim_erase_sector((cr & FLASH_CR_SNB_Msk) >> FLASH_CR_SNB_Pos);
+    } else if (mer || mer1) {
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+        if (mer && !sim_erase_bank(0)) {
+            return;
+        }
+        if (mer1 && !sim_erase_bank(1)) {
+            return;
+        }
+        sim_start_op((mer && mer1) ? SIM_OP_ERASE_MASS : SIM_OP_ERASE_BANK);
+#else
+        if (sim_erase_bank(0)) {
+            sim_start_op(SIM_OP_ERASE_MASS);
+        }
+#endif
+    } else {
+        sim.sr |= FLASH_SR_PGSERR_Msk;
+    }
+}
+
+static uint32_t sim_reg_offset(volatile const uint32_t *reg)
+{
+    uintptr_t addr = (uintptr_t)reg;
+
+    if (addr < FLASH_SIM_CTRL_BASE || addr >= FLASH_SIM_CTRL_BASE + 0x400) {
+        fprintf(stderr, "flash_sim: access to unmodelled register %lx\n",
+                (unsigned long)addr);
+        abort();
+    }
+    return (uint32_t)(addr - FLASH_SIM_CTRL_BASE);
+}
+
+static uint32_t sim_read_reg(uint32_t off)
+{
+    if (!sim.powered) {
+        /* powered off: the driver sees a failed, not busy, controller */
+        return off == SIM_REG_SR ? FLASH_SR_OPERR_Msk : 0;
+    }
+    switch (off) {
+        case SIM_REG_ACR:
+            return sim.acr;
+        case SIM_REG_SR:
+            sim.clock += SIM_POLL_COST_US;
+            sim_check_cut_clock();
+            if (!sim.powered) {
+                return FLASH_SR_OPERR_Msk;
+            }
+            return sim.sr | (sim_is_busy() ? FLASH_SR_BSY_Msk : 0);
+        case SIM_REG_CR:
+            return sim.cr;
+        case SIM_REG_OPTCR:
+            return sim.optcr;
+        case SIM_REG_OPTCR1:
+            return sim.optcr1;
+        default:
+            /* key registers are write only */
+            return 0;
+    }
+}
+
+static void sim_write_reg(uint32_t off, uint32_t value)
+{
+    if (!sim.powered) {
+        return;
+    }
+    switch (off) {
+        case SIM_REG_ACR:
+            sim.acr = value;
+            break;
+        case SIM_REG_KEYR:
+            if (sim.cr_hard_locked) {
+                break;
+            }
+            if (sim.key_step == 0 && value == KEY1) {
+                sim.key_step = 1;
+            } else if (sim.key_step == 1 && value == KEY2) {
+                sim.key_step = 0;
+                sim.cr &= ~FLASH_CR_LOCK_Msk;
+            } else {
+                /* wrong sequence: locked until next reset */
+                sim.cr_hard_locked = true;
+            }
+            break;
+        case SIM_REG_OPTKEYR:
+            if (sim.optcr_hard_locked) {
+                break;
+            }
+            if (sim.optkey_step == 0 && value == OPTKEY1) {
+                sim.optkey_step = 1;
+            } else if (sim.optkey_step == 1 && value == OPTKEY2) {
+                sim.optkey_step = 0;
+                sim.optcr &= ~FLASH_OPTCR_OPTLOCK_Msk;
+            } else {
+                sim.optcr_hard_locked = true;
+            }
+            break;
+        case SIM_REG_SR:
+            /* error flags and EOP are cleared by writing 1 */
+            sim.sr &= ~(value & (SIM_SR_ERRORS | FLASH_SR_EOP_Msk));
+            break;
+        case SIM_REG_CR:
+            if (sim.cr & FLASH_CR_LOCK_Msk) {
+                break;
+            }
+            sim.cr = value & ~FLASH_CR_STRT_Msk;
+            if ((value & FLASH_CR_STRT_Msk) && !sim_is_busy()) {
+                sim_start();
+            }
+            break;
+        case SIM_REG_OPTCR:
+            if (sim.optcr & FLASH_OPTCR_OPTLOCK_Msk) {
+                break;
+            }
+            sim.optcr = value & ~FLASH_OPTCR_OPTSTRT_Msk;
+            if ((value & FLASH_OPTCR_OPTSTRT_Msk) && !sim_is_busy()) {
+                sim.opt_prev = sim.opt;
+                sim.opt1_prev = sim.opt1;
+                sim.opt = value & ~(FLASH_OPTCR_OPTLOCK_Msk | FLASH_OPTCR_OPTSTRT_Msk);
+                sim.opt1 = sim.optcr1;
+                sim.op_is_opt = true;
+                sim_start_op(SIM_OP_ERASE_16K);
+            }
+            break;
+        case SIM_REG_OPTCR1:
+            if (sim.optcr & FLASH_OPTCR_OPTLOCK_Msk) {
+                break;
+            }
+            sim.optcr1 = value;
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * Backend primitives (see flash_backend.h)
+ */
+uint32_t flash_be_read_reg(volatile const uint32_t *reg)
+{
+    uint32_t value;
+
+    if (reg == r_CORTEX_M_FLASH_SIZE) {
+        /* flash size in kB, in the upper half word */
+        value = (sim.dev_size >> 10) << FLASH_SIZE_KB_Pos;
+    } else {
+        value = sim_read_reg(sim_reg_offset(reg));
+    }
+
+    sim_trace(FLASH_SIM_OP_READ_REG, (physaddr_t)(uintptr_t)reg, value);
+    return value;
+}
+
+void flash_be_write_reg(volatile uint32_t *reg, uint32_t value)
+{
+    sim_trace(FLASH_SIM_OP_WRITE_REG, (physaddr_t)(uintptr_t)reg, value);
+    sim_write_reg(sim_reg_offset(reg), value);
+}
+
+void flash_be_mem_write_8(physaddr_t addr, uint8_t value)
+{
+    sim_trace(FLASH_SIM_OP_WRITE_8, addr, value);
+    sim_program(addr, value, 1);
+}
+
+void flash_be_mem_write_16(physaddr_t addr, uint16_t value)
+{
+    sim_trace(FLASH_SIM_OP_WRITE_16, addr, value);
+    sim_program(addr, value, 2);
+}
+
+void flash_be_mem_write_32(physaddr_t addr, uint32_t value)
+{
+    sim_trace(FLASH_SIM_OP_WRITE_32, addr, value);
+    sim_program(addr, value, 4);
+}
+
+void flash_be_mem_write_64(physaddr_t addr, uint64_t value)
+{
+    sim_trace(FLASH_SIM_OP_WRITE_64, addr, value);
+    sim_program(addr, value, 8);
+}
+
+void flash_be_mem_read(void *dest, physaddr_t addr, uint32_t size)
+{
+    const sim_sector_t *sector;
+    uint32_t chunk;
+
+    sim_trace(FLASH_SIM_OP_READ_MEM, addr, size);
+    while (size > 0) {
+        sector = sim_get_sector(sim_phys(addr));
+        chunk = sector ? sector->end - sim_phys(addr) + 1 : size;
+        chunk = chunk < size ? chunk : size;
+        if (sector && sim_is_pcrop(sector->num)) {
+            /* data reads of PCROP sectors are refused */
+            sim.sr |= 1 << 8;
+            memset(dest, 0, chunk);
+        } else {
+            memcpy(dest, sim_ptr(sim_phys(addr)), chunk);
+        }
+        dest = (uint8_t*)dest + chunk;
+        addr += chunk;
+        size -= chunk;
+    }
+}
+
+void flash_sim_set_trace(flash_sim_trace_t trace)
+{
+    sim.trace = trace;
+}
+
+void flash_sim_set_device(uint32_t size, bool db1m)
+{
+    sim.dev_size = size;
+#if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)
+    if (db1m) {
+        sim.opt |= FLASH_OPTCR_DB1M_Msk;
+    } else {
+        sim.opt &= ~FLASH_OPTCR_DB1M_Msk;
+    }
+#else
+    /* no dual bank mode on f40xxx/41xxx */
+    (void)db1m;
+#endif
+}
+
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+/* map the banks on the bus, bank 2 first when swapped */
+static void sim_map_banks(bool swapped)
+{
+    const uint32_t half = FLASH_SIM_SIZE / 2;
+
+    if (swapped == sim.swapped) {
+        return;
+    }
+    if (mmap((void*)FLASH_SIM_BASE, half, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_FIXED, sim.mem_fd, swapped ? half : 0) == MAP_FAILED ||
+        mmap((void*)(FLASH_SIM_BASE + half), half, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_FIXED, sim.mem_fd, swapped ? 0 : half) == MAP_FAILED) {
+        perror("flash_sim: unable to remap the flash banks");
+        abort();
+    }
+    sim.swapped = swapped;
+}
+#endif
+
+void flash_sim_reset(void)
+{
+    sim.acr = 0;
+    sim.sr = 0;
+    sim.cr = FLASH_CR_LOCK_Msk;
+    sim.optcr = sim.opt | FLASH_OPTCR_OPTLOCK_Msk;
+    sim.optcr1 = sim.opt1;
+    sim.key_step = 0;
+    sim.optkey_step = 0;
+    sim.cr_hard_locked = false;
+    sim.optcr_hard_locked = false;
+    sim.busy_until = sim.clock;
+    sim.hang_next = false;
+    sim.powered = true;
+    sim.cut_op = 0;
+    sim.cut_clock = 0;
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+    sim_map_banks(!!(sim.opt & FLASH_OPTCR_BFB2_Msk));
+#endif
+}
+
+void flash_sim_erase_all(void)
+{
+    sim_erase_range(FLASH_SIM_BASE, FLASH_SIM_BASE + FLASH_SIM_SIZE - 1);
+}
+
+void flash_sim_poke(physaddr_t addr, const void *buf, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i) {
+        *sim_ptr(sim_phys(addr + i)) = ((const uint8_t*)buf)[i];
+    }
+}
+
+int flash_sim_init(void)
+{
+    void *bus;
+
+    if (sim.mem == NULL) {
+        /* the same memory is mapped on the bus, where the driver reads
+         * it, and at a free address for the simulator physical view */
+        sim.mem_fd = memfd_create("flash_sim", 0);
+        if (sim.mem_fd < 0 || ftruncate(sim.mem_fd, FLASH_SIM_SIZE) != 0) {
+            perror("flash_sim: unable to create the flash memory");
+            goto err;
+        }
+        bus = mmap((void*)FLASH_SIM_BASE, FLASH_SIM_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_FIXED_NOREPLACE, sim.mem_fd, 0);
+        if (bus == MAP_FAILED || bus != (void*)FLASH_SIM_BASE) {
+            perror("flash_sim: unable to map the flash memory");
+            goto err;
+        }
+        sim.mem = mmap(NULL, FLASH_SIM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       sim.mem_fd, 0);
+        if (sim.mem == MAP_FAILED) {
+            perror("flash_sim: unable to map the flash memory");
+            munmap(bus, FLASH_SIM_SIZE);
+            sim.mem = NULL;
+            goto err;
+        }
+        sim.swapped = false;
+    }
+    sim.opt = SIM_OPT_DEFAULT;
+    sim.opt1 = SIM_OPT1_DEFAULT;
+    sim.dev_size = FLASH_SIM_SIZE;
+    sim.vrange = FLASH_SIM_VRANGE_2V7_3V6;
+    sim.timing = FLASH_SIM_TIMING_TYP;
+    sim.program_count = 0;
+    sim.erase_count = 0;
+    sim.seed = SIM_SEED_DEFAULT;
+    memset(sim.otp, 0xff, sizeof(sim.otp));
+    flash_sim_erase_all();
+    flash_sim_reset();
+    return 0;
+err:
+    if (sim.mem_fd >= 0) {
+        close(sim.mem_fd);
+    }
+    return -1;
+}
+
+void flash_sim_exit(void)
+{
+    if (sim.mem != NULL) {
+        munmap((void*)FLASH_SIM_BASE, FLASH_SIM_SIZE);
+        munmap(sim.mem, FLASH_SIM_SIZE);
+        close(sim.mem_fd);
+        sim.mem = NULL;
+    }
+    free(sim.snap);
+    sim.snap = NULL;
+}
+
+uint64_t flash_sim_program_count(void)
+{
+    return sim.program_count;
+}
+
+uint64_t flash_sim_erase_count(void)
+{
+    return sim.erase_count;
+}
+
+uint64_t flash_sim_clock_us(void)
+{
+    return sim.clock;
+}
+
+void flash_sim_advance_clock(uint64_t us)
+{
+    sim.clock += us;
+    if (sim.powered) {
+        sim_check_cut_clock();
+    }
+}
+
+void flash_sim_hang_next_op(void)
+{
+    sim.hang_next = true;
+}
+
+void flash_sim_set_voltage_range(flash_sim_vrange_t range)
+{
+    sim.vrange = range;
+}
+
+void flash_sim_set_timing(flash_sim_timing_t timing)
+{
+    sim.timing = timing;
+}
+
+void flash_sim_cut_after_ops(uint32_t n)
+{
+    sim.op_count = 0;
+    sim.cut_op = n;
+}
+
+void flash_sim_cut_at(uint64_t clock_us)
+{
+    sim.cut_clock = clock_us;
+}
+
+void flash_sim_set_cut_handler(void (*handler)(void))
+{
+    sim.cut_handler = handler;
+}
+
+void flash_sim_set_seed(uint32_t seed)
+{
+    /* xorshift state must not be null */
+    sim.seed = seed ? seed : SIM_SEED_DEFAULT;
+}
+
+bool flash_sim_is_powered(void)
+{
+    return sim.powered;
+}
@@ -0,0 +1,168 @@
+#ifndef FLASH_SIM_H_
+#define FLASH_SIM_H_
+
+#include "autoconf.h"
+#include "libc/types.h"
+#include <stdbool.h>
+
+/*
+ * Host-side register level simulator of the STM32F4 flash controller.
+ *
+ * The flash memory of the configured geometry (1M single/dual bank or 2M) is
+ * backed by a RAM array mapped at its real address (0x08000000), so that
+ * the driver and the upper layers can access it unmodified. The control
+ * registers (0x40023C00) and the program stores are handled by the host
+ * implementation of the driver access backend (see flash_backend.h).
+ *
+ * The model handles:
+ * - the KEYR/OPTKEYR unlock sequences (a wrong sequence locks the
+ *   registers until the next reset)
+ * - the SR error flags (write 1 to clear) and the BSY flag
+ * - the CR PG/SER/MER/MER1/SNB/PSIZE/STRT semantics
+ * - the OPTCR/OPTCR1 option bytes, loaded at reset and programmed by OPTSTRT
+ * - the flash size register of the device signature (0x1FFF7A22), read only
+ * - the OTP area, blank at flash_sim_init() and never erased. Programming a
+ *   locked OTP block sets WRPERR
+ * - write protection, and PCROP when SPRMOD is set (data reads of a PCROP
+ *   sector through the backend set RDERR and return zeros)
+ * - NOR flash semantics: programming can only clear bits (1->0), erase sets
+ *   the sector to 0xFF
+ * - bank swap: in dual bank, BFB2 set at reset maps bank 2 at 0x08000000
+ *   and bank 1 at the bank 2 addresses
+ * - program and erase durations: BSY stays set for the datasheet typical
+ *   (or max) duration of the operation, for the configured parallelism, on a
+ *   virtual clock. Each status register poll advances the clock by 1us.
+ */
+
+#if CONFIG_USR_DRV_FLASH_2M
+# define FLASH_SIM_SIZE         0x200000
+#else
+# define FLASH_SIM_SIZE         0x100000
+#endif
+#define FLASH_SIM_BASE          0x08000000
+#define FLASH_SIM_CTRL_BASE     0x40023C00
+
+/* Map the simulated flash (fully erased) and reset the controller */
+int flash_sim_init(void);
+
+/* Unmap the simulated flash */
+void flash_sim_exit(void);
+
+/*
+ * Power-on reset: controller registers are back to their reset value, the
+ * option bytes are reloaded. Flash content and option bytes are kept.
+ */
+void flash_sim_reset(void);
+
+/* Erase the whole simulated flash, bypassing the controller */
+void flash_sim_erase_all(void);
+
+/* Write into the simulated flash, bypassing the controller and NOR rules */
+void flash_sim_poke(physaddr_t addr, const void *buf, uint32_t size);
+
+/* Number of program and erase operations executed by the controller */
+uint64_t flash_sim_program_count(void);
+uint64_t flash_sim_erase_count(void);
+
+/*
+ * Operation recorder: when set, the trace hook is called for each backend
+ * access (register reads are recorded with the returned value).
+ */
+typedef enum {
+    FLASH_SIM_OP_READ_REG,
+    FLASH_SIM_OP_WRITE_REG,
+    FLASH_SIM_OP_WRITE_8,
+    FLASH_SIM_OP_WRITE_16,
+    FLASH_SIM_OP_WRITE_32,
+    FLASH_SIM_OP_WRITE_64,
+    FLASH_SIM_OP_READ_MEM,  /* value is the read size */
+} flash_sim_op_type_t;
+
+typedef struct {
+    flash_sim_op_type_t type;
+    physaddr_t addr;
+    uint64_t value;
+    uint64_t clock;
+} flash_sim_op_t;
+
+typedef void (*flash_sim_trace_t)(const flash_sim_op_t *op);
+
+void flash_sim_set_trace(flash_sim_trace_t trace);
+
+/*
+ * Device seen by the geometry detection: flash size reported by the device
+ * signature, and DB1M option bit, loaded at the next flash_sim_reset(). The
+ * simulated memory keeps the configured geometry. flash_sim_init() restores
+ * the configured device.
+ */
+void flash_sim_set_device(uint32_t size, bool db1m);
+
+/*
+ * Supply voltage range, giving the max usable parallelism (PSIZE).
+ * Programming or erasing with a larger PSIZE sets PGPERR.
+ */
+typedef enum {
+    FLASH_SIM_VRANGE_1V8_2V1 = 0,   /* x8 */
+    FLASH_SIM_VRANGE_2V1_2V7,       /* x16 */
+    FLASH_SIM_VRANGE_2V7_3V6,       /* x32 (default) */
+    FLASH_SIM_VRANGE_VPP,           /* x64, with external Vpp */
+} flash_sim_vrange_t;
+
+void flash_sim_set_voltage_range(flash_sim_vrange_t range);
+
+/* Operation durations: datasheet typical (default) or max values */
+typedef enum {
+    FLASH_SIM_TIMING_TYP = 0,
+    FLASH_SIM_TIMING_MAX,
+} flash_sim_timing_t;
+
+void flash_sim_set_timing(flash_sim_timing_t timing);
+
+/*
+ * The next program, erase or option bytes operation never completes: BSY
+ * stays set until flash_sim_reset() (e.g. to test the driver timeouts).
+ */
+void flash_sim_hang_next_op(void);
+
+/*
+ * Systick availability: when unavailable, sys_get_systick() fails, as for a
+ * task without the timer permission.
+ */
+void flash_sim_set_systick(bool available);
+
+/* Virtual clock, in microseconds */
+uint64_t flash_sim_clock_us(void);
+
+/* Advance the virtual clock, e.g. to account for CPU processing time */
+void flash_sim_advance_clock(uint64_t us);
+
+/*
+ * Power loss injection. A power cut interrupts the running program, erase
+ * or option bytes operation:
+ * - an interrupted program leaves the target bits partially cleared
+ * - an interrupted erase leaves the sector (or bank) partially erased, each
+ *   bit being erased with a probability equal to the operation progress
+ * - an interrupted option bytes programming is not applied
+ * Then the controller is powered off: register and memory writes are
+ * ignored, the status register reports OPERR (not busy) so that the driver
+ * fails immediately, and the cut handler, if any, is called (e.g. to
+ * longjmp() back to the test, as the code would not go further on target).
+ * flash_sim_reset() powers the controller back on and disarms the cut.
+ *
+ * Interruption points are drawn from a pseudo random generator, seeded with
+ * flash_sim_set_seed() for reproducible runs.
+ */
+
+/* Cut power during the n-th next program/erase/option operation (0 disarms) */
+void flash_sim_cut_after_ops(uint32_t n);
+
+/* Cut power when the virtual clock reaches the given time (0 disarms) */
+void flash_sim_cut_at(uint64_t clock_us);
+
+void flash_sim_set_cut_handler(void (*handler)(void));
+
+void flash_sim_set_seed(uint32_t seed);
+
+bool flash_sim_is_powered(void);
+
+#endif/*!FLASH_SIM_H_*/
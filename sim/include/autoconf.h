@@ -0,0 +1,48 @@
+/*
+ * Host simulator configuration header.
+ *
+ * On target, this file is generated from Kconfig. For the simulator, the
+ * flash configuration (size, banking, SoC) is given on the compiler command
+ * line by sim/Makefile, one build per simulated geometry.
+ */
+#ifndef AUTOCONF_H_
+#define AUTOCONF_H_
+
+#define CONFIG_USR_DRV_FLASH 1
+
+/* register and memory accesses are implemented by the simulator */
+#define CONFIG_USR_DRV_FLASH_BACKEND_EXTERN 1
+
+/*
+ * optional modules, all enabled in the host build, unless SIM_NO_MODULES is
+ * set (benchmark builds). With the WOOKEY layout, the flip/flop images use
+ * all the free sectors, leaving none for the erase counters.
+ */
+#if !SIM_NO_MODULES
+# if CONFIG_WOOKEY
+#  define CONFIG_USR_DRV_FLASH_FW 1
+#  define CONFIG_USR_DRV_FLASH_FW_CKPT_INTERVAL 4096
+#  define CONFIG_USR_DRV_FLASH_PATCH 1
+#  define CONFIG_USR_DRV_FLASH_LZ4 1
+# else
+#  define CONFIG_USR_DRV_FLASH_WEAR 1
+#  if CONFIG_USR_DRV_FLASH_2M
+#   define CONFIG_USR_DRV_FLASH_WEAR_SECTOR 23
+#   define CONFIG_USR_DRV_FLASH_WEAR_SECTOR2 22
+#  elif CONFIG_USR_DRV_FLASH_DUAL_BANK
+#   define CONFIG_USR_DRV_FLASH_WEAR_SECTOR 19
+#   define CONFIG_USR_DRV_FLASH_WEAR_SECTOR2 18
+#  else
+#   define CONFIG_USR_DRV_FLASH_WEAR_SECTOR 11
+#   define CONFIG_USR_DRV_FLASH_WEAR_SECTOR2 10
+#  endif
+# endif
+# define CONFIG_USR_DRV_FLASH_KV 1
+# define CONFIG_USR_DRV_FLASH_KV_MAX_KEYS 64
+# define CONFIG_USR_DRV_FLASH_LOG 1
+# define CONFIG_USR_DRV_FLASH_TXN 1
+# define CONFIG_USR_DRV_FLASH_DIGEST 1
+# define CONFIG_USR_DRV_FLASH_MERKLE 1
+#endif
+
+#endif/*!AUTOCONF_H_*/
@@ -0,0 +1,7 @@
+/*
+ * Host shim of the libstd nostd header (nothing used by the driver)
+ */
+#ifndef LIBC_NOSTD_H_
+#define LIBC_NOSTD_H_
+
+#endif/*!LIBC_NOSTD_H_*/
@@ -0,0 +1,15 @@
+/*
+ * Host shim of the libstd register helpers.
+ *
+ * The flash driver reaches its registers through the access backend
+ * (flash_backend.h), implemented by the simulator on host. Only the
+ * register address helper is needed here.
+ */
+#ifndef LIBC_REGUTILS_H_
+#define LIBC_REGUTILS_H_
+
+#include "libc/types.h"
+
+#define REG_ADDR(addr)                      ((volatile uint32_t *)(addr))
+
+#endif/*!LIBC_REGUTILS_H_*/
@@ -0,0 +1,9 @@
+/*
+ * Host shim of the libstd stdio header
+ */
+#ifndef LIBC_STDIO_H_
+#define LIBC_STDIO_H_
+
+#include <stdio.h>
+
+#endif/*!LIBC_STDIO_H_*/
@@ -0,0 +1,9 @@
+/*
+ * Host shim of the libstd string header
+ */
+#ifndef LIBC_STRING_H_
+#define LIBC_STRING_H_
+
+#include <string.h>
+
+#endif/*!LIBC_STRING_H_*/
@@ -0,0 +1,55 @@
+/*
+ * Host shim of the EwoK syscall API, limited to what the flash driver uses.
+ * Devices are always granted, the systick is the simulator virtual clock.
+ */
+#ifndef LIBC_SYSCALL_H_
+#define LIBC_SYSCALL_H_
+
+#include "libc/types.h"
+
+typedef enum {
+    SYS_E_DONE = 0,
+    SYS_E_INVAL,
+    SYS_E_DENIED,
+    SYS_E_BUSY,
+} e_syscall_ret;
+
+typedef enum {
+    INIT_DEVACCESS = 0,
+} e_init_type;
+
+typedef enum {
+    PREC_MILLI,
+    PREC_MICRO,
+    PREC_CYCLE,
+} e_tick_type;
+
+typedef enum {
+    DEV_MAP_AUTO,
+    DEV_MAP_VOLUNTARY,
+} dev_map_mode_t;
+
+typedef struct {
+    uint32_t dummy;
+} dev_irq_info_t;
+
+typedef struct {
+    uint32_t dummy;
+} dev_gpio_info_t;
+
+typedef struct {
+    char name[16];
+    physaddr_t address;
+    uint32_t size;
+    uint8_t irq_num;
+    uint8_t gpio_num;
+    dev_map_mode_t map_mode;
+    dev_irq_info_t irqs[4];
+    dev_gpio_info_t gpios[16];
+} device_t;
+
+e_syscall_ret sys_init(e_init_type type, device_t *dev, int *desc);
+
+e_syscall_ret sys_get_systick(uint64_t *val, e_tick_type mode);
+
+#endif/*!LIBC_SYSCALL_H_*/
@@ -0,0 +1,13 @@
+/*
+ * Host shim of the libstd types header
+ */
+#ifndef LIBC_TYPES_H_
+#define LIBC_TYPES_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef uint32_t physaddr_t;
+
+#endif/*!LIBC_TYPES_H_*/
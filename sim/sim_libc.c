@@ -0,0 +1,52 @@
+/** @file sim_libc.c
+ * \brief Host implementation of the syscalls used by the flash driver
+ */
+
+#include "libc/syscall.h"
+#include "flash_sim.h"
+
+/* descriptors are allocated incrementally, all devices being granted */
+static int sim_next_desc = 1;
+
+e_syscall_ret sys_init(e_init_type type, device_t *dev, int *desc)
+{
+    if (type != INIT_DEVACCESS || dev == NULL || desc == NULL) {
+        return SYS_E_INVAL;
+    }
+    *desc = sim_next_desc++;
+    return SYS_E_DONE;
+}
+
+static bool sim_systick = true;
+
+void flash_sim_set_systick(bool available)
+{
+    sim_systick = available;
+}
+
+/* systick is the simulator virtual clock, the core running at 168MHz */
+e_syscall_ret sys_get_systick(uint64_t *val, e_tick_type mode)
+{
+    uint64_t us = flash_sim_clock_us();
+
+    if (!sim_systick) {
+        return SYS_E_DENIED;
+    }
+    if (val == NULL) {
+        return SYS_E_INVAL;
+    }
+    switch (mode) {
+        case PREC_MILLI:
+            *val = us / 1000;
+            break;
+        case PREC_MICRO:
+            *val = us;
+            break;
+        case PREC_CYCLE:
+            *val = us * 168;
+            break;
+        default:
+            return SYS_E_INVAL;
+    }
+    return SYS_E_DONE;
+}
@@ -0,0 +1,77 @@
+/** @file flash_test.c
+ * \brief Simulator based tests helpers
+ */
+
+#include <setjmp.h>
+#include "flash_test.h"
+#if CONFIG_USR_DRV_FLASH_WEAR
+# include "api/flash_wear.h"
+#endif
+
+static jmp_buf test_cut_env;
+/* power cut point of the running test_cut_run(), for the failure report */
+static uint32_t test_cut_point = 0;
+
+static void test_on_cut(void)
+{
+    longjmp(test_cut_env, 1);
+}
+
+void test_fail(const char *file, int line, const char *cond)
+{
+    printf("FAIL %s:%d: %s", file, line, cond);
+    if (test_cut_point != 0) {
+        printf(" (power cut at operation %u)", test_cut_point);
+    }
+    printf("\n");
+    exit(1);
+}
+
+/* startup of the driver, and of the modules counting the erases */
+static void test_start(void)
+{
+    TEST_ASSERT(flash_init() == 0);
+#if CONFIG_USR_DRV_FLASH_WEAR
+    TEST_ASSERT(flash_wear_init() == FLASH_ERR_NONE);
+#endif
+    flash_unlock();
+}
+
+void test_setup(void)
+{
+    TEST_ASSERT(flash_sim_init() == 0);
+    flash_sim_set_cut_handler(test_on_cut);
+    test_start();
+}
+
+void test_reboot(void)
+{
+    flash_sim_reset();
+    test_start();
+}
+
+bool test_cut_run(uint32_t n, uint32_t seed, void (*op)(void *ctx), void *ctx)
+{
+    test_cut_point = n;
+    flash_sim_set_seed(seed);
+    flash_sim_cut_after_ops(n);
+    if (setjmp(test_cut_env) != 0) {
+        return true;
+    }
+    op(ctx);
+    flash_sim_cut_after_ops(0);
+    test_cut_point = 0;
+    return false;
+}
+
+int test_done(const char *name)
+{
+    printf("PASS %s\n", name);
+    return 0;
+}
+
+int test_skip(const char *name)
+{
+    printf("SKIP %s\n", name);
+    return 0;
+}
@@ -0,0 +1,51 @@
+/** @file flash_test.h
+ * \brief Simulator based tests of the flash driver and its modules
+ *
+ * Each test_*.c file is a program, built against each simulated geometry
+ * (see ../Makefile) and run by "make -C sim test". A test returns 0 when it
+ * passes, or when the module it covers is not part of the configuration.
+ */
+#ifndef FLASH_TEST_H_
+#define FLASH_TEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "autoconf.h"
+#include "api/libflash.h"
+#include "flash_sim.h"
+
+#define TEST_ASSERT(cond) \
+    do { \
+        if (!(cond)) { \
+            test_fail(__FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+/* print the failed check, with the current power cut point, and exit */
+void test_fail(const char *file, int line, const char *cond);
+
+/*
+ * blank simulated flash, initialized and unlocked driver, loaded erase
+ * counters
+ */
+void test_setup(void);
+
+/*
+ * power-on reset: the flash content is kept, the driver is initialized
+ * again and the erase counters loaded again
+ */
+void test_reboot(void);
+
+/*
+ * Run op, the power being cut during its n-th program, erase or option bytes
+ * operation, at a point drawn with the given seed. Returns true if the
+ * power was cut (op is then left where the power was lost, as on target),
+ * false if op completed before its n-th operation.
+ */
+bool test_cut_run(uint32_t n, uint32_t seed, void (*op)(void *ctx), void *ctx);
+
+/* report the test result */
+int test_done(const char *name);
+int test_skip(const char *name);
+
+#endif/*!FLASH_TEST_H_*/
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Generate the LZ4 frames of test_lz4.c (lz4_frames.h)
+
+The test image is built as image() in test_lz4.c, then compressed by the
+lz4 command line tool with several frame options.
+
+usage: gen_lz4_frames.py [lz4 tool] > lz4_frames.h
+"""
+
+import os
+import subprocess
+import sys
+import tempfile
+
+IMG_SIZE = 72 * 1024
+# a first random part, then copies of the previous bytes at distances
+# depending on the 4KB segment, some bytes being changed
+RANDOM_SIZE = 1024
+DISTANCES = (1024, 4099, 65000)
+
+# frame name, lz4 tool options
+FRAMES = (
+    # 4MB independent blocks, content checksum
+    ("default", []),
+    # 1KB linked blocks, the first one stored raw, content size
+    ("linked", ["-9", "-B1024", "-BD", "--content-size"]),
+    # 64KB independent blocks, block checksums, no content checksum
+    ("block_crc", ["-B4", "-BX", "--no-frame-crc"]),
+)
+
+
+def image():
+    img = bytearray(IMG_SIZE)
+    state = 0x12345678
+    for i in range(IMG_SIZE):
+        if i < RANDOM_SIZE:
+            state = (state * 1103515245 + 12345) & 0xffffffff
+            img[i] = state >> 24
+        elif i % 997 == 0:
+            img[i] = i & 0xff
+        else:
+            dist = DISTANCES[(i // 4096) % len(DISTANCES)]
+            img[i] = img[i - (dist if dist <= i else RANDOM_SIZE)]
+    return bytes(img)
+
+
+def main():
+    tool = sys.argv[1] if len(sys.argv) > 1 else "lz4"
+    # from a file, for the tool to know the content size
+    with tempfile.NamedTemporaryFile(delete=False) as tmp:
+        tmp.write(image())
+    print("/* generated by gen_lz4_frames.py, do not edit */")
+    print()
+    print("#ifndef LZ4_FRAMES_H_")
+    print("#define LZ4_FRAMES_H_")
+    for name, opts in FRAMES:
+        frame = subprocess.run([tool, "-c", "-q"] + opts + [tmp.name],
+                               stdout=subprocess.PIPE, check=True).stdout
+        print()
+        print("/* lz4 %s */" % " ".join(opts) if opts else "/* lz4 */")
+        print("static const uint8_t lz4_frame_%s[%d] = {" % (name, len(frame)))
+        for off in range(0, len(frame), 12):
+            print("    " + " ".join("0x%02x," % b for b in frame[off:off + 12]))
+        print("};")
+    print()
+    print("#endif/*!LZ4_FRAMES_H_*/")
+    os.unlink(tmp.name)
+
+
+if __name__ == "__main__":
+    main()
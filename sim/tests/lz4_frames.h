@@ -0,0 +1,749 @@
+/* generated by gen_lz4_frames.py, do not edit */
+
+#ifndef LZ4_FRAMES_H_
+#define LZ4_FRAMES_H_
+
+/* lz4 */
+static const uint8_t lz4_frame_default[2241] = {
+    0x04, 0x22, 0x4d, 0x18, 0x64, 0x50, 0x08, 0xae, 0x08, 0x00, 0x00, 0xff,
+    0xff, 0xff, 0xff, 0xf4, 0x0b, 0x6f, 0x2e, 0x99, 0xa5, 0x77, 0x20, 0x6a,
+    0x26, 0x93, 0x77, 0xaf, 0x20, 0x25, 0xfb, 0x4e, 0xe0, 0x95, 0x4e, 0x91,
+    0x9f, 0xfa, 0x7e, 0xb0, 0x1a, 0x9e, 0x16, 0x5e, 0x31, 0x67, 0xc3, 0x58,
+    0x1f, 0xfa, 0x77, 0x8e, 0x79, 0x1c, 0x98, 0x5a, 0xf8, 0x9f, 0x9e, 0xfc,
+    0xbf, 0xed, 0x3c, 0x30, 0xaf, 0xee, 0xec, 0xa0, 0xe6, 0xe9, 0x82, 0x91,
+    0x84, 0x9d, 0x16, 0xfa, 0x5a, 0xa0, 0x6c, 0xf2, 0x0f, 0xd9, 0xb2, 0x27,
+    0xec, 0x96, 0x2d, 0xb6, 0x53, 0x91, 0x39, 0xae, 0x9b, 0xec, 0xa9, 0x0d,
+    0xc5, 0xf3, 0x77, 0xf9, 0x55, 0x31, 0x53, 0x8d, 0x3b, 0x1b, 0x69, 0x7e,
+    0x99, 0x6c, 0x8b, 0x6c, 0xd1, 0xf0, 0x8b, 0x9a, 0x1e, 0x50, 0x65, 0x75,
+    0xbf, 0x30, 0x9c, 0x16, 0x56, 0x9f, 0xdd, 0xa9, 0x18, 0xb0, 0xca, 0x67,
+    0xeb, 0xc3, 0x82, 0x90, 0x82, 0xc9, 0x51, 0x92, 0x2e, 0x92, 0x8b, 0x3d,
+    0xd8, 0xf2, 0x8d, 0xc8, 0x6f, 0x42, 0x60, 0xfa, 0xba, 0x93, 0x78, 0xb1,
+    0x4b, 0x92, 0x91, 0xb0, 0x16, 0xfe, 0x9b, 0x61, 0xe5, 0x1d, 0x3f, 0xf4,
+    0x99, 0xa0, 0x6b, 0x07, 0x12, 0xe0, 0xf0, 0xca, 0x11, 0x5c, 0x1b, 0x40,
+    0x78, 0xef, 0xda, 0x15, 0xc3, 0x19, 0xd8, 0x28, 0x94, 0x5b, 0x98, 0xbe,
+    0xad, 0x7f, 0x7e, 0x0d, 0xb9, 0x49, 0x54, 0x7d, 0xbb, 0xe8, 0xb3, 0xdc,
+    0xfd, 0x34, 0x5c, 0x62, 0xe8, 0x78, 0x76, 0x3b, 0x0e, 0x66, 0x2c, 0x01,
+    0x53, 0x6f, 0x24, 0x4f, 0x05, 0x9c, 0xe1, 0x58, 0x45, 0xa4, 0xe2, 0x38,
+    0x1d, 0xdb, 0x28, 0x5d, 0x1f, 0x34, 0x7d, 0x3d, 0x60, 0x76, 0x8d, 0x42,
+    0x42, 0x5d, 0xbd, 0x9e, 0x43, 0x43, 0x4a, 0x65, 0xe0, 0x90, 0x21, 0x26,
+    0x2f, 0x03, 0x78, 0xf1, 0xc1, 0xa9, 0x11, 0x60, 0xff, 0xf5, 0xbc, 0x31,
+    0xf8, 0x62, 0x7c, 0x7f, 0x6c, 0x99, 0x5c, 0x92, 0x81, 0xec, 0xe7, 0xfb,
+    0x65, 0xad, 0xc4, 0x53, 0xd9, 0xbe, 0xee, 0xdb, 0x5e, 0x4b, 0x84, 0xe5,
+    0x83, 0x95, 0x33, 0xaa, 0x8b, 0x44, 0xb0, 0x02, 0x75, 0x9d, 0xbd, 0x25,
+    0x0a, 0x9f, 0xbe, 0x67, 0x83, 0xd2, 0xc9, 0x90, 0xfe, 0x57, 0xc8, 0x4b,
+    0xad, 0x8c, 0x07, 0xc6, 0x9d, 0x3a, 0x49, 0x81, 0x65, 0x3c, 0x4a, 0xec,
+    0x2a, 0x01, 0x3e, 0x44, 0xc2, 0x5c, 0xac, 0xdd, 0xe1, 0x94, 0xc5, 0xbf,
+    0xa4, 0x8a, 0x15, 0x46, 0xd3, 0x81, 0x1e, 0x38, 0xc5, 0xd5, 0x44, 0x6b,
+    0xae, 0xa3, 0x25, 0xf9, 0xc1, 0x3e, 0x36, 0xa4, 0x7e, 0xf2, 0x3c, 0xda,
+    0x06, 0x62, 0x0c, 0x83, 0x54, 0x90, 0x9e, 0x87, 0xb8, 0x59, 0x58, 0xb3,
+    0xe6, 0xf7, 0x29, 0x72, 0x86, 0xc4, 0xd9, 0x7c, 0x13, 0x63, 0x96, 0x70,
+    0x6b, 0x07, 0xb2, 0xfe, 0x67, 0x69, 0x1d, 0x10, 0x64, 0xbe, 0x02, 0x1d,
+    0x83, 0xb7, 0x93, 0x98, 0x13, 0x52, 0xfa, 0x19, 0x74, 0x0e, 0xeb, 0xba,
+    0x51, 0xcc, 0x56, 0xd4, 0x09, 0x66, 0x31, 0xf4, 0xb3, 0xcf, 0x53, 0xd2,
+    0x02, 0x42, 0xf0, 0x9f, 0xfc, 0xcb, 0x0a, 0xde, 0x46, 0x3a, 0x0a, 0xb5,
+    0x83, 0x52, 0x40, 0x64, 0xf9, 0xab, 0x00, 0x41, 0x84, 0xae, 0xa8, 0x7c,
+    0x88, 0xa1, 0xab, 0x7e, 0x64, 0x9a, 0x8f, 0xa3, 0xa5, 0xe7, 0x5e, 0xac,
+    0xe8, 0x2e, 0xff, 0x23, 0x36, 0x55, 0x83, 0x8f, 0x51, 0x03, 0x4c, 0x2f,
+    0x28, 0x3e, 0xa1, 0xa1, 0x77, 0x78, 0x15, 0xa9, 0x45, 0x16, 0xd3, 0xf6,
+    0xc8, 0x37, 0xb2, 0xa1, 0xe5, 0x4e, 0xae, 0xc9, 0x3f, 0xdd, 0x16, 0x78,
+    0xa4, 0x51, 0x9c, 0xc1, 0x44, 0xdb, 0x1a, 0xbf, 0xf5, 0xc0, 0xa2, 0xe2,
+    0x80, 0x82, 0x42, 0xbc, 0xb0, 0xd5, 0x94, 0x2d, 0xa3, 0x42, 0xe9, 0xa8,
+    0x92, 0xf7, 0xc3, 0xf2, 0x16, 0x14, 0xe1, 0x94, 0xa0, 0x82, 0x0f, 0xd4,
+    0x9e, 0x1b, 0x84, 0x06, 0x8c, 0xbb, 0x73, 0x76, 0xf0, 0x71, 0x30, 0x41,
+    0xf7, 0xf7, 0xf6, 0xe1, 0x34, 0x23, 0x3b, 0x3e, 0xb6, 0xf0, 0x1b, 0x91,
+    0x7b, 0x5f, 0x4f, 0x58, 0xf5, 0x47, 0xb2, 0x3c, 0x1e, 0xd2, 0x3e, 0xa1,
+    0x57, 0x41, 0x21, 0x3d, 0x14, 0x36, 0x39, 0xf0, 0x03, 0xa3, 0x1d, 0xbc,
+    0x39, 0x0e, 0x89, 0x98, 0x9a, 0xd2, 0xd1, 0x7b, 0x79, 0x95, 0xaa, 0xd3,
+    0x28, 0x0e, 0x75, 0x58, 0xfd, 0xda, 0xd9, 0xda, 0xfd, 0xf1, 0x54, 0x82,
+    0x36, 0x0e, 0x16, 0xaf, 0x77, 0x0c, 0x47, 0x55, 0xe8, 0x04, 0x94, 0x96,
+    0xc2, 0xc3, 0x9b, 0xf0, 0x18, 0xd9, 0x97, 0x41, 0x7d, 0x4f, 0x66, 0x76,
+    0xf2, 0xd8, 0xc2, 0xa7, 0x5e, 0xf7, 0x51, 0xfc, 0x9b, 0x81, 0xdb, 0x8d,
+    0xb5, 0x6f, 0xd1, 0x2d, 0xf7, 0xce, 0xf6, 0xc2, 0xec, 0x74, 0xcb, 0x9f,
+    0x5b, 0x99, 0x18, 0x07, 0xf3, 0x8f, 0xae, 0xcd, 0x2f, 0x3d, 0x43, 0xa9,
+    0x99, 0x0a, 0xf8, 0xcd, 0x83, 0x65, 0xf8, 0xc8, 0xd9, 0x16, 0x32, 0xb3,
+    0x96, 0x07, 0x27, 0x55, 0x16, 0x22, 0x51, 0x9f, 0x41, 0x91, 0x8b, 0xb9,
+    0x44, 0x5c, 0x94, 0x80, 0x62, 0x49, 0x80, 0x2d, 0x07, 0x6d, 0xc7, 0x86,
+    0x2d, 0xda, 0x39, 0xc8, 0xbc, 0x59, 0xfd, 0x41, 0x70, 0x10, 0x78, 0x32,
+    0x76, 0x97, 0xb6, 0x77, 0xc5, 0xc6, 0xab, 0x14, 0xe7, 0x55, 0x78, 0xa1,
+    0xb5, 0x04, 0x7a, 0x2e, 0x3e, 0xf1, 0xd4, 0x20, 0xd1, 0x4d, 0xc5, 0x21,
+    0xf3, 0x9a, 0xe1, 0x1c, 0xaf, 0x1b, 0x1a, 0xe9, 0x80, 0x28, 0x21, 0x16,
+    0xde, 0x8d, 0x8d, 0x04, 0x0e, 0x21, 0xd8, 0x2b, 0xd0, 0x46, 0x0e, 0x51,
+    0x10, 0xef, 0xd5, 0x04, 0xa5, 0x77, 0x21, 0x95, 0xcf, 0x46, 0xab, 0x77,
+    0xf5, 0x23, 0x17, 0xb4, 0xe5, 0xb6, 0x54, 0xdb, 0x80, 0x84, 0xa4, 0x9f,
+    0xa9, 0x74, 0x4d, 0x07, 0xd3, 0xae, 0xf5, 0xe8, 0x8a, 0x51, 0x1b, 0x04,
+    0xda, 0x5d, 0x2d, 0x0f, 0x5c, 0xd8, 0x42, 0x71, 0x65, 0xf0, 0x56, 0x7d,
+    0x8f, 0xaf, 0xaf, 0x8f, 0x9b, 0x95, 0xbc, 0x27, 0x62, 0x10, 0x8e, 0x08,
+    0x5d, 0xac, 0xc4, 0xef, 0xf6, 0x88, 0x91, 0x60, 0x9c, 0x50, 0x25, 0xa9,
+    0x62, 0xd8, 0xa8, 0x12, 0x99, 0x15, 0x99, 0xd6, 0xa7, 0x0c, 0x2b, 0x65,
+    0x18, 0xf8, 0x01, 0x0c, 0x9f, 0xbf, 0x6b, 0xef, 0x89, 0x79, 0xec, 0x12,
+    0xdb, 0x94, 0xc0, 0xc2, 0x16, 0xec, 0xa0, 0xa7, 0x67, 0xd6, 0xff, 0x51,
+    0xaa, 0xf3, 0x81, 0xff, 0x90, 0x52, 0x5e, 0x01, 0xe0, 0x2f, 0xf8, 0xe7,
+    0x84, 0x5b, 0xd1, 0x68, 0xec, 0x1b, 0xbb, 0xa4, 0xf8, 0x01, 0xcd, 0x42,
+    0x6d, 0x1a, 0x93, 0x7a, 0xac, 0x71, 0x80, 0x11, 0x2c, 0xb5, 0x88, 0xe4,
+    0xea, 0x93, 0x7c, 0x6e, 0xd5, 0x09, 0x83, 0x80, 0xf0, 0xc9, 0xcb, 0x0a,
+    0x9a, 0x64, 0x58, 0xa9, 0x4d, 0xe5, 0x77, 0x62, 0xc1, 0x0f, 0x4d, 0xbd,
+    0x2d, 0x54, 0x84, 0x1f, 0x2f, 0x54, 0x05, 0x1b, 0x90, 0x6c, 0x53, 0x25,
+    0xd7, 0xa2, 0xe0, 0xc9, 0x7c, 0xf7, 0x7e, 0x5a, 0x1f, 0xf1, 0xc9, 0xcd,
+    0x13, 0xe5, 0x1d, 0x13, 0x30, 0x4d, 0x7b, 0x3b, 0xa2, 0x35, 0x7e, 0x35,
+    0x40, 0x93, 0x2b, 0xea, 0x9b, 0x07, 0x4d, 0x0d, 0xc2, 0x60, 0xa9, 0xe0,
+    0x80, 0xe3, 0x2b, 0xc9, 0x86, 0x2d, 0xef, 0x6a, 0xc0, 0x30, 0xb5, 0xae,
+    0xd3, 0x9f, 0x25, 0xe7, 0x81, 0xd6, 0xfd, 0xfa, 0x67, 0x01, 0x09, 0x3f,
+    0x5e, 0x18, 0x71, 0x75, 0x6b, 0xf5, 0xd4, 0x10, 0x0e, 0x95, 0x30, 0xb1,
+    0x56, 0x4d, 0x87, 0x86, 0x05, 0x80, 0xd5, 0xfb, 0xc0, 0x1f, 0xae, 0xe1,
+    0xfa, 0x06, 0xae, 0x00, 0x28, 0xfc, 0x89, 0xb6, 0x69, 0xe2, 0x61, 0x1c,
+    0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x21, 0x06, 0x5b, 0x00, 0x04, 0xff, 0xff,
+    0xff, 0xba, 0x1f, 0xca, 0x00, 0x04, 0xff, 0xff, 0xff, 0xd4, 0x1f, 0xaf,
+    0x00, 0x08, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0x94,
+    0x00, 0x0c, 0x07, 0x0f, 0x00, 0x04, 0x41, 0x0f, 0x03, 0x10, 0xff, 0xff,
+    0xff, 0x66, 0x1f, 0x79, 0x03, 0x10, 0xff, 0xff, 0xff, 0xd4, 0x1f, 0x5e,
+    0x03, 0x14, 0x5b, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0x43,
+    0x03, 0x18, 0x5b, 0x0f, 0x03, 0x0c, 0x41, 0x0f, 0x03, 0x1c, 0xff, 0xff,
+    0xff, 0x12, 0x1f, 0x28, 0x03, 0x1c, 0x5b, 0x0f, 0x03, 0x10, 0x5c, 0x0f,
+    0x00, 0x04, 0xff, 0xff, 0xf6, 0x1f, 0x0d, 0x03, 0x20, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0xf2, 0x03, 0x24, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0xd7, 0x03, 0x28, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0xbc, 0x03, 0x2c, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0xa1, 0x03, 0x30, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0x86, 0x03, 0x34, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0x6b, 0x03, 0x38, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0x50, 0x03, 0x3c, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0x83, 0x0f, 0x06, 0x3c, 0xff, 0xff, 0x24, 0x1f, 0x35, 0x06,
+    0x40, 0x5b, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0x1a, 0x06,
+    0x44, 0x5b, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0xff, 0x06,
+    0x48, 0x5b, 0x0f, 0x03, 0x0c, 0xff, 0x83, 0x0f, 0x00, 0x0c, 0xff, 0xcf,
+    0x1f, 0xe4, 0x06, 0x4c, 0x5b, 0x0f, 0x03, 0x10, 0xff, 0x9e, 0x0f, 0x00,
+    0x04, 0xff, 0xb4, 0x1f, 0xc9, 0x06, 0x50, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0xae, 0x06, 0x54, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x93, 0x06, 0x58, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x78, 0x06, 0x5c, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x5d, 0x06, 0x60, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x42, 0x06, 0x64, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x27, 0x06, 0x68, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x0c, 0x06, 0x6c, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xc8, 0x0f, 0x09, 0x6c, 0xde, 0x1f, 0xf1, 0x09, 0x70, 0x5b, 0x0f,
+    0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0xd6, 0x09, 0x74, 0x5b, 0x0f,
+    0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0xbb, 0x09, 0x78, 0x5b, 0x0f,
+    0x03, 0x0c, 0xff, 0xff, 0xc8, 0x0f, 0x03, 0x3c, 0x8a, 0x1f, 0xa0, 0x09,
+    0x7c, 0x5b, 0x0f, 0x03, 0x10, 0xff, 0xff, 0xe3, 0x0f, 0x00, 0x04, 0x6f,
+    0x1f, 0x85, 0x09, 0x80, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0x6a, 0x09, 0x84, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0x4f, 0x09, 0x88, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0x34, 0x09, 0x8c, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0x19, 0x09, 0x90, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0xfe, 0x00, 0x24, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0xe3, 0x09, 0x94, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x16, 0xc8, 0x09, 0x98, 0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0xff,
+    0xff, 0xba, 0x16, 0xad, 0x09, 0x9c, 0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04,
+    0x25, 0x2f, 0x69, 0xe2, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x80, 0x1f, 0x92,
+    0x09, 0x84, 0x5b, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0x77,
+    0x0c, 0xa4, 0x15, 0x0f, 0x00, 0x04, 0x33, 0x0f, 0x03, 0x0c, 0xff, 0xff,
+    0xff, 0x66, 0x1f, 0x5c, 0x0c, 0xa8, 0x30, 0x0f, 0x00, 0x04, 0x18, 0x0f,
+    0x03, 0x0c, 0x25, 0x0f, 0x03, 0x18, 0xff, 0xff, 0xff, 0x2e, 0x1f, 0x41,
+    0x0c, 0xac, 0x4b, 0x0c, 0x00, 0x04, 0x0f, 0x03, 0x10, 0x40, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0x13, 0x16, 0x26, 0x0c, 0xb0, 0x0c, 0x09, 0x90,
+    0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x0b, 0x0c, 0xb4, 0x0c,
+    0x09, 0x90, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0xf0, 0x0c,
+    0xb8, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16,
+    0xd5, 0x0c, 0xbc, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff,
+    0xba, 0x16, 0xba, 0x0c, 0xc0, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x16, 0x9f, 0x0c, 0xc4, 0x0c, 0x06, 0x84, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x84, 0x0c, 0xc8, 0x0c, 0x06, 0x84,
+    0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x69, 0x0c, 0xcc, 0x0c,
+    0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0x6a, 0x0f, 0x03, 0x2c, 0xff, 0xff,
+    0x3d, 0x19, 0x4e, 0x0f, 0xd0, 0x0f, 0x0c, 0x94, 0x4e, 0x0f, 0x03, 0x0c,
+    0xff, 0xff, 0xff, 0x66, 0x1f, 0x33, 0x0f, 0xd4, 0x15, 0x0f, 0x00, 0x04,
+    0x33, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0x18, 0x0f, 0xd8,
+    0x30, 0x0f, 0x00, 0x04, 0x18, 0x0f, 0x03, 0x0c, 0xff, 0x6a, 0x0f, 0x03,
+    0x2c, 0xff, 0xe8, 0x1f, 0xfd, 0x0f, 0xdc, 0x4b, 0x0c, 0x00, 0x04, 0x0f,
+    0x03, 0x10, 0xff, 0x85, 0x0f, 0x00, 0x04, 0xff, 0xcd, 0x16, 0xe2, 0x0f,
+    0xe0, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16,
+    0xc7, 0x0f, 0xe4, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff,
+    0xba, 0x16, 0xac, 0x0f, 0xe8, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x16, 0x91, 0x0f, 0xec, 0x0c, 0x09, 0x90, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x76, 0x0f, 0xf0, 0x0c, 0x09, 0x90,
+    0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x5b, 0x0f, 0xf4, 0x0c,
+    0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x40, 0x0f,
+    0xf8, 0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16,
+    0x25, 0x0f, 0xfc, 0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xaf,
+    0x3f, 0xae, 0x00, 0x28, 0x03, 0x30, 0xf4, 0x1f, 0x0a, 0x09, 0x84, 0x5b,
+    0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0xcf, 0xef, 0x8d, 0x42, 0x42,
+    0x5d, 0xbd, 0x9e, 0x43, 0x43, 0x4a, 0x65, 0xe0, 0x09, 0x94, 0x0a, 0x0f,
+    0x09, 0x88, 0x33, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0xcf, 0xd4,
+    0x3b, 0x0e, 0x66, 0x2c, 0x01, 0x53, 0x6f, 0x24, 0x4f, 0x05, 0x9c, 0x09,
+    0x94, 0x25, 0x0f, 0x00, 0x04, 0x18, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xaf,
+    0x0f, 0x00, 0x0c, 0xa3, 0xcf, 0xb9, 0xc3, 0x19, 0xd8, 0x28, 0x94, 0x5b,
+    0x98, 0xbe, 0xad, 0x7f, 0x7e, 0x09, 0x94, 0x40, 0x0c, 0x00, 0x04, 0x0f,
+    0x03, 0x10, 0xff, 0xff, 0xc7, 0x0f, 0xe5, 0xc9, 0x5b, 0x1f, 0xa9, 0xe8,
+    0xd9, 0x07, 0x1f, 0x94, 0xe8, 0xdd, 0x01, 0x7f, 0x9e, 0x76, 0x97, 0xb6,
+    0x77, 0xc5, 0xc6, 0xe8, 0xe1, 0x07, 0x1f, 0x80, 0xe8, 0xe5, 0x07, 0x1f,
+    0x77, 0xe8, 0xe9, 0x07, 0x1f, 0x2d, 0xe8, 0xed, 0x07, 0x1f, 0x88, 0xe8,
+    0xf1, 0x3d, 0x0f, 0xe8, 0xfd, 0xff, 0xff, 0xff, 0x12, 0x1f, 0x83, 0x00,
+    0x04, 0x07, 0x1f, 0x32, 0x00, 0x04, 0x94, 0x0f, 0xe8, 0xfd, 0xff, 0xff,
+    0xff, 0x12, 0x1f, 0x68, 0x00, 0x08, 0x22, 0x0f, 0x00, 0x04, 0x7a, 0x0f,
+    0xe8, 0xfd, 0xff, 0xff, 0xff, 0x12, 0x7f, 0x4d, 0xa7, 0x5e, 0xf7, 0x51,
+    0xfc, 0x9b, 0xe8, 0xe1, 0x07, 0x0f, 0x00, 0x0c, 0x1d, 0x0f, 0x00, 0x04,
+    0x5f, 0x0c, 0xdf, 0x69, 0x1f, 0x0c, 0xdf, 0x6d, 0x5b, 0x1f, 0x13, 0xe2,
+    0x7d, 0x07, 0x1f, 0xc9, 0xe2, 0x81, 0x07, 0x1f, 0xd4, 0xe2, 0x85, 0x07,
+    0x0f, 0xdf, 0x7d, 0x08, 0x1f, 0xe0, 0xe2, 0x8d, 0x07, 0x1f, 0xfc, 0xe2,
+    0x91, 0x07, 0x1f, 0x2d, 0xe2, 0x95, 0x07, 0x1f, 0xf0, 0xe2, 0x99, 0x07,
+    0x1f, 0x2e, 0xe2, 0x9d, 0x07, 0x1f, 0xf4, 0xe2, 0xa1, 0x5b, 0x1f, 0xc4,
+    0xe5, 0xb1, 0x07, 0x1f, 0xd2, 0xe5, 0xb5, 0x07, 0x1f, 0xe1, 0xe5, 0xb9,
+    0x07, 0x1f, 0xda, 0xe5, 0xbd, 0x07, 0x1f, 0xb2, 0xe5, 0xc1, 0x07, 0x1f,
+    0x66, 0xe5, 0xc5, 0x07, 0x1f, 0x84, 0xe5, 0xc9, 0x07, 0x1f, 0x2f, 0xe5,
+    0xcd, 0x07, 0x1f, 0x9c, 0xe5, 0xd1, 0x1e, 0x50, 0x34, 0x23, 0x3b, 0x3e,
+    0xb6, 0x00, 0x00, 0x00, 0x00, 0x6a, 0x19, 0xc0, 0x8d,
+};
+
+/* lz4 -9 -B1024 -BD --content-size */
+static const uint8_t lz4_frame_linked[3161] = {
+    0x04, 0x22, 0x4d, 0x18, 0x4c, 0x40, 0x00, 0x20, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x83, 0x00, 0x04, 0x00, 0x80, 0x0b, 0x6f, 0x2e, 0x99, 0xa5,
+    0x77, 0x20, 0x6a, 0x26, 0x93, 0x77, 0xaf, 0x20, 0x25, 0xfb, 0x4e, 0xe0,
+    0x95, 0x4e, 0x91, 0x9f, 0xfa, 0x7e, 0xb0, 0x1a, 0x9e, 0x16, 0x5e, 0x31,
+    0x67, 0xc3, 0x58, 0x1f, 0xfa, 0x77, 0x8e, 0x79, 0x1c, 0x98, 0x5a, 0xf8,
+    0x9f, 0x9e, 0xfc, 0xbf, 0xed, 0x3c, 0x30, 0xaf, 0xee, 0xec, 0xa0, 0xe6,
+    0xe9, 0x82, 0x91, 0x84, 0x9d, 0x16, 0xfa, 0x5a, 0xa0, 0x6c, 0xf2, 0x0f,
+    0xd9, 0xb2, 0x27, 0xec, 0x96, 0x2d, 0xb6, 0x53, 0x91, 0x39, 0xae, 0x9b,
+    0xec, 0xa9, 0x0d, 0xc5, 0xf3, 0x77, 0xf9, 0x55, 0x31, 0x53, 0x8d, 0x3b,
+    0x1b, 0x69, 0x7e, 0x99, 0x6c, 0x8b, 0x6c, 0xd1, 0xf0, 0x8b, 0x9a, 0x1e,
+    0x50, 0x65, 0x75, 0xbf, 0x30, 0x9c, 0x16, 0x56, 0x9f, 0xdd, 0xa9, 0x18,
+    0xb0, 0xca, 0x67, 0xeb, 0xc3, 0x82, 0x90, 0x82, 0xc9, 0x51, 0x92, 0x2e,
+    0x92, 0x8b, 0x3d, 0xd8, 0xf2, 0x8d, 0xc8, 0x6f, 0x42, 0x60, 0xfa, 0xba,
+    0x93, 0x78, 0xb1, 0x4b, 0x92, 0x91, 0xb0, 0x16, 0xfe, 0x9b, 0x61, 0xe5,
+    0x1d, 0x3f, 0xf4, 0x99, 0xa0, 0x6b, 0x07, 0x12, 0xe0, 0xf0, 0xca, 0x11,
+    0x5c, 0x1b, 0x40, 0x78, 0xef, 0xda, 0x15, 0xc3, 0x19, 0xd8, 0x28, 0x94,
+    0x5b, 0x98, 0xbe, 0xad, 0x7f, 0x7e, 0x0d, 0xb9, 0x49, 0x54, 0x7d, 0xbb,
+    0xe8, 0xb3, 0xdc, 0xfd, 0x34, 0x5c, 0x62, 0xe8, 0x78, 0x76, 0x3b, 0x0e,
+    0x66, 0x2c, 0x01, 0x53, 0x6f, 0x24, 0x4f, 0x05, 0x9c, 0xe1, 0x58, 0x45,
+    0xa4, 0xe2, 0x38, 0x1d, 0xdb, 0x28, 0x5d, 0x1f, 0x34, 0x7d, 0x3d, 0x60,
+    0x76, 0x8d, 0x42, 0x42, 0x5d, 0xbd, 0x9e, 0x43, 0x43, 0x4a, 0x65, 0xe0,
+    0x90, 0x21, 0x26, 0x2f, 0x03, 0x78, 0xf1, 0xc1, 0xa9, 0x11, 0x60, 0xff,
+    0xf5, 0xbc, 0x31, 0xf8, 0x62, 0x7c, 0x7f, 0x6c, 0x99, 0x5c, 0x92, 0x81,
+    0xec, 0xe7, 0xfb, 0x65, 0xad, 0xc4, 0x53, 0xd9, 0xbe, 0xee, 0xdb, 0x5e,
+    0x4b, 0x84, 0xe5, 0x83, 0x95, 0x33, 0xaa, 0x8b, 0x44, 0xb0, 0x02, 0x75,
+    0x9d, 0xbd, 0x25, 0x0a, 0x9f, 0xbe, 0x67, 0x83, 0xd2, 0xc9, 0x90, 0xfe,
+    0x57, 0xc8, 0x4b, 0xad, 0x8c, 0x07, 0xc6, 0x9d, 0x3a, 0x49, 0x81, 0x65,
+    0x3c, 0x4a, 0xec, 0x2a, 0x01, 0x3e, 0x44, 0xc2, 0x5c, 0xac, 0xdd, 0xe1,
+    0x94, 0xc5, 0xbf, 0xa4, 0x8a, 0x15, 0x46, 0xd3, 0x81, 0x1e, 0x38, 0xc5,
+    0xd5, 0x44, 0x6b, 0xae, 0xa3, 0x25, 0xf9, 0xc1, 0x3e, 0x36, 0xa4, 0x7e,
+    0xf2, 0x3c, 0xda, 0x06, 0x62, 0x0c, 0x83, 0x54, 0x90, 0x9e, 0x87, 0xb8,
+    0x59, 0x58, 0xb3, 0xe6, 0xf7, 0x29, 0x72, 0x86, 0xc4, 0xd9, 0x7c, 0x13,
+    0x63, 0x96, 0x70, 0x6b, 0x07, 0xb2, 0xfe, 0x67, 0x69, 0x1d, 0x10, 0x64,
+    0xbe, 0x02, 0x1d, 0x83, 0xb7, 0x93, 0x98, 0x13, 0x52, 0xfa, 0x19, 0x74,
+    0x0e, 0xeb, 0xba, 0x51, 0xcc, 0x56, 0xd4, 0x09, 0x66, 0x31, 0xf4, 0xb3,
+    0xcf, 0x53, 0xd2, 0x02, 0x42, 0xf0, 0x9f, 0xfc, 0xcb, 0x0a, 0xde, 0x46,
+    0x3a, 0x0a, 0xb5, 0x83, 0x52, 0x40, 0x64, 0xf9, 0xab, 0x00, 0x41, 0x84,
+    0xae, 0xa8, 0x7c, 0x88, 0xa1, 0xab, 0x7e, 0x64, 0x9a, 0x8f, 0xa3, 0xa5,
+    0xe7, 0x5e, 0xac, 0xe8, 0x2e, 0xff, 0x23, 0x36, 0x55, 0x83, 0x8f, 0x51,
+    0x03, 0x4c, 0x2f, 0x28, 0x3e, 0xa1, 0xa1, 0x77, 0x78, 0x15, 0xa9, 0x45,
+    0x16, 0xd3, 0xf6, 0xc8, 0x37, 0xb2, 0xa1, 0xe5, 0x4e, 0xae, 0xc9, 0x3f,
+    0xdd, 0x16, 0x78, 0xa4, 0x51, 0x9c, 0xc1, 0x44, 0xdb, 0x1a, 0xbf, 0xf5,
+    0xc0, 0xa2, 0xe2, 0x80, 0x82, 0x42, 0xbc, 0xb0, 0xd5, 0x94, 0x2d, 0xa3,
+    0x42, 0xe9, 0xa8, 0x92, 0xf7, 0xc3, 0xf2, 0x16, 0x14, 0xe1, 0x94, 0xa0,
+    0x82, 0x0f, 0xd4, 0x9e, 0x1b, 0x84, 0x06, 0x8c, 0xbb, 0x73, 0x76, 0xf0,
+    0x71, 0x30, 0x41, 0xf7, 0xf7, 0xf6, 0xe1, 0x34, 0x23, 0x3b, 0x3e, 0xb6,
+    0xf0, 0x1b, 0x91, 0x7b, 0x5f, 0x4f, 0x58, 0xf5, 0x47, 0xb2, 0x3c, 0x1e,
+    0xd2, 0x3e, 0xa1, 0x57, 0x41, 0x21, 0x3d, 0x14, 0x36, 0x39, 0xf0, 0x03,
+    0xa3, 0x1d, 0xbc, 0x39, 0x0e, 0x89, 0x98, 0x9a, 0xd2, 0xd1, 0x7b, 0x79,
+    0x95, 0xaa, 0xd3, 0x28, 0x0e, 0x75, 0x58, 0xfd, 0xda, 0xd9, 0xda, 0xfd,
+    0xf1, 0x54, 0x82, 0x36, 0x0e, 0x16, 0xaf, 0x77, 0x0c, 0x47, 0x55, 0xe8,
+    0x04, 0x94, 0x96, 0xc2, 0xc3, 0x9b, 0xf0, 0x18, 0xd9, 0x97, 0x41, 0x7d,
+    0x4f, 0x66, 0x76, 0xf2, 0xd8, 0xc2, 0xa7, 0x5e, 0xf7, 0x51, 0xfc, 0x9b,
+    0x81, 0xdb, 0x8d, 0xb5, 0x6f, 0xd1, 0x2d, 0xf7, 0xce, 0xf6, 0xc2, 0xec,
+    0x74, 0xcb, 0x9f, 0x5b, 0x99, 0x18, 0x07, 0xf3, 0x8f, 0xae, 0xcd, 0x2f,
+    0x3d, 0x43, 0xa9, 0x99, 0x0a, 0xf8, 0xcd, 0x83, 0x65, 0xf8, 0xc8, 0xd9,
+    0x16, 0x32, 0xb3, 0x96, 0x07, 0x27, 0x55, 0x16, 0x22, 0x51, 0x9f, 0x41,
+    0x91, 0x8b, 0xb9, 0x44, 0x5c, 0x94, 0x80, 0x62, 0x49, 0x80, 0x2d, 0x07,
+    0x6d, 0xc7, 0x86, 0x2d, 0xda, 0x39, 0xc8, 0xbc, 0x59, 0xfd, 0x41, 0x70,
+    0x10, 0x78, 0x32, 0x76, 0x97, 0xb6, 0x77, 0xc5, 0xc6, 0xab, 0x14, 0xe7,
+    0x55, 0x78, 0xa1, 0xb5, 0x04, 0x7a, 0x2e, 0x3e, 0xf1, 0xd4, 0x20, 0xd1,
+    0x4d, 0xc5, 0x21, 0xf3, 0x9a, 0xe1, 0x1c, 0xaf, 0x1b, 0x1a, 0xe9, 0x80,
+    0x28, 0x21, 0x16, 0xde, 0x8d, 0x8d, 0x04, 0x0e, 0x21, 0xd8, 0x2b, 0xd0,
+    0x46, 0x0e, 0x51, 0x10, 0xef, 0xd5, 0x04, 0xa5, 0x77, 0x21, 0x95, 0xcf,
+    0x46, 0xab, 0x77, 0xf5, 0x23, 0x17, 0xb4, 0xe5, 0xb6, 0x54, 0xdb, 0x80,
+    0x84, 0xa4, 0x9f, 0xa9, 0x74, 0x4d, 0x07, 0xd3, 0xae, 0xf5, 0xe8, 0x8a,
+    0x51, 0x1b, 0x04, 0xda, 0x5d, 0x2d, 0x0f, 0x5c, 0xd8, 0x42, 0x71, 0x65,
+    0xf0, 0x56, 0x7d, 0x8f, 0xaf, 0xaf, 0x8f, 0x9b, 0x95, 0xbc, 0x27, 0x62,
+    0x10, 0x8e, 0x08, 0x5d, 0xac, 0xc4, 0xef, 0xf6, 0x88, 0x91, 0x60, 0x9c,
+    0x50, 0x25, 0xa9, 0x62, 0xd8, 0xa8, 0x12, 0x99, 0x15, 0x99, 0xd6, 0xa7,
+    0x0c, 0x2b, 0x65, 0x18, 0xf8, 0x01, 0x0c, 0x9f, 0xbf, 0x6b, 0xef, 0x89,
+    0x79, 0xec, 0x12, 0xdb, 0x94, 0xc0, 0xc2, 0x16, 0xec, 0xa0, 0xa7, 0x67,
+    0xd6, 0xff, 0x51, 0xaa, 0xf3, 0x81, 0xff, 0x90, 0x52, 0x5e, 0x01, 0xe0,
+    0x2f, 0xf8, 0xe7, 0x84, 0x5b, 0xd1, 0x68, 0xec, 0x1b, 0xbb, 0xa4, 0xf8,
+    0x01, 0xcd, 0x42, 0x6d, 0x1a, 0x93, 0x7a, 0xac, 0x71, 0x80, 0x11, 0x2c,
+    0xb5, 0x88, 0xe4, 0xea, 0x93, 0x7c, 0x6e, 0xd5, 0x09, 0x83, 0x80, 0xf0,
+    0xc9, 0xcb, 0x0a, 0x9a, 0x64, 0x58, 0xa9, 0x4d, 0xe5, 0x77, 0x62, 0xc1,
+    0x0f, 0x4d, 0xbd, 0x2d, 0x54, 0x84, 0x1f, 0x2f, 0x54, 0x05, 0x1b, 0x90,
+    0x6c, 0x53, 0x25, 0xd7, 0xa2, 0xe0, 0xc9, 0x7c, 0xf7, 0x7e, 0x5a, 0x1f,
+    0xf1, 0xc9, 0xcd, 0x13, 0xe5, 0x1d, 0x13, 0x30, 0x4d, 0x7b, 0x3b, 0xa2,
+    0x35, 0x7e, 0x35, 0x40, 0x93, 0x2b, 0xea, 0x9b, 0x07, 0x4d, 0x0d, 0xc2,
+    0x60, 0xa9, 0xe0, 0x80, 0xe3, 0x2b, 0xc9, 0x86, 0x2d, 0xef, 0x6a, 0xc0,
+    0x30, 0xb5, 0xae, 0xd3, 0x9f, 0x25, 0xe7, 0x81, 0xd6, 0xfd, 0xfa, 0x67,
+    0x01, 0x09, 0x3f, 0x5e, 0x18, 0x71, 0x75, 0x6b, 0xf5, 0xd4, 0x10, 0x0e,
+    0x95, 0x30, 0xb1, 0x56, 0x4d, 0x87, 0x86, 0x05, 0x80, 0xd5, 0xfb, 0xc0,
+    0x1f, 0xae, 0xe1, 0xfa, 0x06, 0xae, 0x00, 0x28, 0xfc, 0x89, 0xb6, 0x69,
+    0xe2, 0x61, 0x1c, 0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x21, 0x06, 0x5b, 0x12,
+    0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0xca,
+    0x00, 0x04, 0x1d, 0x50, 0xd1, 0xf6, 0x21, 0x06, 0x5b, 0x12, 0x00, 0x00,
+    0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0x9f, 0x1f, 0xaf, 0x00, 0x04,
+    0x38, 0x50, 0xd1, 0xf6, 0x21, 0x06, 0x5b, 0x12, 0x00, 0x00, 0x00, 0x0f,
+    0x00, 0x04, 0xff, 0xff, 0xff, 0x84, 0x1f, 0x94, 0x00, 0x04, 0x53, 0x50,
+    0xd1, 0xf6, 0x21, 0x06, 0x5b, 0x24, 0x00, 0x00, 0x00, 0x3f, 0x0b, 0x6f,
+    0x2e, 0x03, 0x04, 0xff, 0xff, 0xff, 0x66, 0x1f, 0x79, 0x03, 0x04, 0x0a,
+    0x1f, 0x90, 0x03, 0x04, 0x07, 0x1f, 0x35, 0x03, 0x04, 0x07, 0x1f, 0x25,
+    0x03, 0x04, 0x1a, 0x50, 0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x1f, 0x00, 0x00,
+    0x00, 0x3f, 0x21, 0x06, 0x5b, 0x00, 0x04, 0xff, 0xff, 0xff, 0x4b, 0x1f,
+    0x5e, 0x00, 0x04, 0x07, 0x1f, 0x7c, 0x00, 0x04, 0x40, 0x1f, 0xca, 0x00,
+    0x04, 0x1a, 0x50, 0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x1c, 0x00, 0x00, 0x00,
+    0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0x33, 0x1f, 0x43, 0x00, 0x04, 0x07,
+    0x1f, 0xe7, 0x00, 0x04, 0x40, 0x1f, 0xaf, 0x00, 0x04, 0x35, 0x50, 0xa7,
+    0x61, 0xb3, 0xd1, 0xf6, 0x1c, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0x18, 0x1f, 0x28, 0x00, 0x04, 0x07, 0x1f, 0x89, 0x00, 0x04,
+    0x40, 0x1f, 0x94, 0x00, 0x04, 0x50, 0x50, 0xa7, 0x61, 0xb3, 0xd1, 0xf6,
+    0x11, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xfc, 0x1f, 0x0d,
+    0x00, 0x04, 0xda, 0x50, 0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x11, 0x00, 0x00,
+    0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xe1, 0x1f, 0xf2, 0x00, 0x04, 0xf5,
+    0x50, 0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xc6, 0x1f, 0xd7, 0x00, 0x04, 0xff, 0x11, 0x50, 0xa7,
+    0x61, 0xb3, 0xd1, 0xf6, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xab, 0x1f, 0xbc, 0x00, 0x04, 0xff, 0x2c, 0x50, 0xa7, 0x61, 0xb3,
+    0xd1, 0xf6, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0x90,
+    0x1f, 0xa1, 0x00, 0x04, 0xff, 0x47, 0x50, 0xa7, 0x61, 0xb3, 0xd1, 0xf6,
+    0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0x75, 0x1f, 0x86,
+    0x00, 0x04, 0xff, 0x62, 0x50, 0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x12, 0x00,
+    0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0x5a, 0x1f, 0x6b, 0x00, 0x04,
+    0xff, 0x7d, 0x50, 0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x12, 0x00, 0x00, 0x00,
+    0x0f, 0x00, 0x04, 0xff, 0xff, 0x3f, 0x1f, 0x50, 0x00, 0x04, 0xff, 0x98,
+    0x50, 0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x24, 0x00, 0x00, 0x00, 0x3f, 0xb3,
+    0xd1, 0xf6, 0x03, 0x04, 0xff, 0xff, 0x21, 0x1f, 0x35, 0x03, 0x04, 0x0a,
+    0x1f, 0x0c, 0x03, 0x04, 0x07, 0x1f, 0x9b, 0x03, 0x04, 0x07, 0x1f, 0xa9,
+    0x03, 0x04, 0xff, 0x5f, 0x50, 0xe2, 0x61, 0x1c, 0xa7, 0x61, 0x1c, 0x00,
+    0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0x09, 0x1f, 0x1a, 0x00, 0x04,
+    0x07, 0x1f, 0xbc, 0x00, 0x04, 0x40, 0x1f, 0x86, 0x00, 0x04, 0xff, 0x5f,
+    0x50, 0xe2, 0x61, 0x1c, 0xa7, 0x61, 0x1b, 0x00, 0x00, 0x00, 0x0f, 0x00,
+    0x04, 0xff, 0xed, 0x1f, 0xff, 0x00, 0x04, 0x07, 0x1f, 0xb6, 0x00, 0x04,
+    0x40, 0x1f, 0x6b, 0x00, 0x04, 0xff, 0x7a, 0x50, 0xe2, 0x61, 0x1c, 0xa7,
+    0x61, 0x1b, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xd2, 0x1f, 0xe4,
+    0x00, 0x04, 0x07, 0x1f, 0x14, 0x00, 0x04, 0x40, 0x1f, 0x50, 0x00, 0x04,
+    0xff, 0x95, 0x50, 0xe2, 0x61, 0x1c, 0xa7, 0x61, 0x12, 0x00, 0x00, 0x00,
+    0x0f, 0x00, 0x04, 0xff, 0xb7, 0x1f, 0xc9, 0x00, 0x04, 0xff, 0xff, 0x20,
+    0x50, 0xe2, 0x61, 0x1c, 0xa7, 0x61, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00,
+    0x04, 0xff, 0x9c, 0x1f, 0xae, 0x00, 0x04, 0xff, 0xff, 0x3b, 0x50, 0xe2,
+    0x61, 0x1c, 0xa7, 0x61, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff,
+    0x81, 0x1f, 0x93, 0x00, 0x04, 0xff, 0xff, 0x56, 0x50, 0xe2, 0x61, 0x1c,
+    0xa7, 0x61, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0x66, 0x1f,
+    0x78, 0x00, 0x04, 0xff, 0xff, 0x71, 0x50, 0xe2, 0x61, 0x1c, 0xa7, 0x61,
+    0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0x4b, 0x1f, 0x5d, 0x00,
+    0x04, 0xff, 0xff, 0x8c, 0x50, 0xe2, 0x61, 0x1c, 0xa7, 0x61, 0x12, 0x00,
+    0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0x30, 0x1f, 0x42, 0x00, 0x04, 0xff,
+    0xff, 0xa7, 0x50, 0xe2, 0x61, 0x1c, 0xa7, 0x61, 0x12, 0x00, 0x00, 0x00,
+    0x0f, 0x00, 0x04, 0xff, 0x15, 0x1f, 0x27, 0x00, 0x04, 0xff, 0xff, 0xc2,
+    0x50, 0xe2, 0x61, 0x1c, 0xa7, 0x61, 0x11, 0x00, 0x00, 0x00, 0x0f, 0x00,
+    0x04, 0xf9, 0x1f, 0x0c, 0x00, 0x04, 0xff, 0xff, 0xdd, 0x50, 0xe2, 0x61,
+    0x1c, 0xa7, 0x61, 0x23, 0x00, 0x00, 0x00, 0x3f, 0x1c, 0xa7, 0x61, 0x03,
+    0x04, 0xdb, 0x1f, 0xf1, 0x03, 0x04, 0x0a, 0x1f, 0xc4, 0x03, 0x04, 0x07,
+    0x1f, 0xd2, 0x03, 0x04, 0x07, 0x1f, 0xe1, 0x03, 0x04, 0xff, 0xff, 0xa4,
+    0x50, 0x89, 0xb6, 0x69, 0xe2, 0x61, 0x1b, 0x00, 0x00, 0x00, 0x0f, 0x00,
+    0x04, 0xc3, 0x1f, 0xd6, 0x00, 0x04, 0x07, 0x1f, 0xe0, 0x00, 0x04, 0x40,
+    0x1f, 0x42, 0x00, 0x04, 0xff, 0xff, 0xa4, 0x50, 0x89, 0xb6, 0x69, 0xe2,
+    0x61, 0x1b, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xa8, 0x1f, 0xbb, 0x00,
+    0x04, 0x07, 0x1f, 0x9c, 0x00, 0x04, 0x40, 0x1f, 0x27, 0x00, 0x04, 0xff,
+    0xff, 0xbf, 0x50, 0x89, 0xb6, 0x69, 0xe2, 0x61, 0x1b, 0x00, 0x00, 0x00,
+    0x0f, 0x00, 0x04, 0x8d, 0x1f, 0xa0, 0x00, 0x04, 0x07, 0x1f, 0x7e, 0x00,
+    0x04, 0x40, 0x1f, 0x0c, 0x00, 0x04, 0xff, 0xff, 0xda, 0x50, 0x89, 0xb6,
+    0x69, 0xe2, 0x61, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0x72, 0x1f,
+    0x85, 0x00, 0x04, 0xff, 0xff, 0xff, 0x65, 0x50, 0x89, 0xb6, 0x69, 0xe2,
+    0x61, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0x57, 0x1f, 0x6a, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0x80, 0x50, 0x89, 0xb6, 0x69, 0xe2, 0x61, 0x12,
+    0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0x3c, 0x1f, 0x4f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0x9b, 0x50, 0x89, 0xb6, 0x69, 0xe2, 0x61, 0x12, 0x00, 0x00,
+    0x00, 0x0f, 0x00, 0x04, 0x21, 0x1f, 0x34, 0x00, 0x04, 0xff, 0xff, 0xff,
+    0xb6, 0x50, 0x89, 0xb6, 0x69, 0xe2, 0x61, 0x12, 0x00, 0x00, 0x00, 0x0f,
+    0x00, 0x04, 0x06, 0x1f, 0x19, 0x00, 0x04, 0xff, 0xff, 0xff, 0xd1, 0x50,
+    0x89, 0xb6, 0x69, 0xfe, 0x61, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04,
+    0xff, 0xff, 0xff, 0xd3, 0x1f, 0xe3, 0x00, 0x04, 0x04, 0x50, 0x89, 0xb6,
+    0x69, 0xfe, 0x61, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff,
+    0xff, 0xb8, 0x1f, 0xc8, 0x00, 0x04, 0x1f, 0x50, 0x89, 0xb6, 0x69, 0xfe,
+    0x61, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0x9d,
+    0x1f, 0xad, 0x00, 0x04, 0x3a, 0x50, 0x89, 0xb6, 0x69, 0xfe, 0x61, 0x24,
+    0x00, 0x00, 0x00, 0x3f, 0x69, 0xe2, 0x61, 0x03, 0x04, 0xff, 0xff, 0xff,
+    0x7f, 0x1f, 0x92, 0x03, 0x04, 0x0a, 0x1f, 0x13, 0x03, 0x04, 0x07, 0x1f,
+    0xc9, 0x03, 0x04, 0x07, 0x1f, 0xd4, 0x03, 0x04, 0x01, 0x50, 0x00, 0x28,
+    0xfc, 0x89, 0xb6, 0x1e, 0x00, 0x00, 0x00, 0x2f, 0x69, 0xfe, 0x00, 0x04,
+    0xff, 0xff, 0xff, 0x65, 0x1f, 0x77, 0x00, 0x04, 0x07, 0x1f, 0x77, 0x00,
+    0x04, 0x40, 0x1f, 0xe3, 0x00, 0x04, 0x01, 0x50, 0x00, 0x28, 0xfc, 0x89,
+    0xb6, 0x1c, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0x4c,
+    0x1f, 0x5c, 0x00, 0x04, 0x07, 0x1f, 0x7a, 0x00, 0x04, 0x40, 0x1f, 0xc8,
+    0x00, 0x04, 0x1c, 0x50, 0x00, 0x28, 0xfc, 0x89, 0xb6, 0x1c, 0x00, 0x00,
+    0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0x31, 0x1f, 0x41, 0x00, 0x04,
+    0x07, 0x1f, 0xaa, 0x00, 0x04, 0x40, 0x1f, 0xad, 0x00, 0x04, 0x37, 0x50,
+    0x00, 0x28, 0xfc, 0x89, 0xb6, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04,
+    0xff, 0xff, 0xff, 0x16, 0x1f, 0x26, 0x00, 0x04, 0xc1, 0x50, 0x00, 0x28,
+    0xfc, 0x89, 0xb6, 0x11, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff,
+    0xfa, 0x1f, 0x0b, 0x00, 0x04, 0xdc, 0x50, 0x00, 0x28, 0xfc, 0x89, 0xb6,
+    0x11, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xdf, 0x1f, 0xf0,
+    0x00, 0x04, 0xf7, 0x50, 0x00, 0x28, 0xfc, 0x89, 0xb6, 0x12, 0x00, 0x00,
+    0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xc4, 0x1f, 0xd5, 0x00, 0x04, 0xff,
+    0x13, 0x50, 0x00, 0x28, 0xfc, 0x89, 0xb6, 0x12, 0x00, 0x00, 0x00, 0x0f,
+    0x00, 0x04, 0xff, 0xff, 0xa9, 0x1f, 0xba, 0x00, 0x04, 0xff, 0x2e, 0x50,
+    0x00, 0x28, 0xfc, 0x89, 0xb6, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04,
+    0xff, 0xff, 0x8e, 0x1f, 0x9f, 0x00, 0x04, 0xff, 0x49, 0x50, 0x00, 0x28,
+    0xfc, 0x89, 0xb6, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff,
+    0x73, 0x1f, 0x84, 0x00, 0x04, 0xff, 0x64, 0x50, 0x00, 0x28, 0xfc, 0x89,
+    0xb6, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0x58, 0x1f,
+    0x69, 0x00, 0x04, 0xff, 0x7f, 0x50, 0x00, 0x28, 0xfc, 0x89, 0xb6, 0x24,
+    0x00, 0x00, 0x00, 0x3f, 0xfc, 0x89, 0xb6, 0x03, 0x04, 0xff, 0xff, 0x3a,
+    0x1f, 0x4e, 0x03, 0x04, 0x0a, 0x1f, 0x4f, 0x03, 0x04, 0x07, 0x1f, 0x5b,
+    0x03, 0x04, 0x07, 0x1f, 0x55, 0x03, 0x04, 0xff, 0x46, 0x50, 0xfa, 0x06,
+    0xae, 0x00, 0x28, 0x1c, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff,
+    0x22, 0x1f, 0x33, 0x00, 0x04, 0x07, 0x1f, 0x58, 0x00, 0x04, 0x40, 0x1f,
+    0x9f, 0x00, 0x04, 0xff, 0x46, 0x50, 0xfa, 0x06, 0xae, 0x00, 0x28, 0x1c,
+    0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xff, 0x07, 0x1f, 0x18, 0x00,
+    0x04, 0x07, 0x1f, 0x57, 0x00, 0x04, 0x40, 0x1f, 0x84, 0x00, 0x04, 0xff,
+    0x61, 0x50, 0xfa, 0x06, 0xae, 0x00, 0x28, 0x1b, 0x00, 0x00, 0x00, 0x0f,
+    0x00, 0x04, 0xff, 0xeb, 0x1f, 0xfd, 0x00, 0x04, 0x07, 0x1f, 0x71, 0x00,
+    0x04, 0x40, 0x1f, 0x69, 0x00, 0x04, 0xff, 0x7c, 0x50, 0xfa, 0x06, 0xae,
+    0x00, 0x28, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xd0, 0x1f,
+    0xe2, 0x00, 0x04, 0xff, 0xff, 0x07, 0x50, 0xfa, 0x06, 0xae, 0x00, 0x28,
+    0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0xb5, 0x1f, 0xc7, 0x00,
+    0x04, 0xff, 0xff, 0x22, 0x50, 0xfa, 0x06, 0xae, 0x00, 0x28, 0x12, 0x00,
+    0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0x9a, 0x1f, 0xac, 0x00, 0x04, 0xff,
+    0xff, 0x3d, 0x50, 0xfa, 0x06, 0xae, 0x00, 0x28, 0x12, 0x00, 0x00, 0x00,
+    0x0f, 0x00, 0x04, 0xff, 0x7f, 0x1f, 0x91, 0x00, 0x04, 0xff, 0xff, 0x58,
+    0x50, 0xfa, 0x06, 0xae, 0x00, 0x28, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00,
+    0x04, 0xff, 0x64, 0x1f, 0x76, 0x00, 0x04, 0xff, 0xff, 0x73, 0x50, 0xfa,
+    0x06, 0xae, 0x00, 0x28, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff,
+    0x49, 0x1f, 0x5b, 0x00, 0x04, 0xff, 0xff, 0x8e, 0x50, 0xfa, 0x06, 0xae,
+    0x00, 0x28, 0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0x2e, 0x1f,
+    0x40, 0x00, 0x04, 0xff, 0xff, 0xa9, 0x50, 0xfa, 0x06, 0xae, 0x00, 0x28,
+    0x12, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xff, 0x13, 0x1f, 0x25, 0x00,
+    0x04, 0xff, 0xff, 0xc4, 0x50, 0xfa, 0x06, 0xae, 0x00, 0x28, 0x23, 0x00,
+    0x00, 0x00, 0x3f, 0xae, 0x00, 0x28, 0x03, 0x04, 0xf4, 0x1f, 0x0a, 0x03,
+    0x04, 0x0a, 0x1f, 0xb0, 0x03, 0x04, 0x07, 0x1f, 0x3c, 0x03, 0x04, 0x07,
+    0x1f, 0xae, 0x03, 0x04, 0xff, 0xff, 0x8b, 0x50, 0x1f, 0xae, 0xe1, 0xfa,
+    0x06, 0x1b, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xdc, 0x1f, 0xef, 0x00,
+    0x04, 0x07, 0x1f, 0xf8, 0x00, 0x04, 0x40, 0x1f, 0x5b, 0x00, 0x04, 0xff,
+    0xff, 0x8b, 0x50, 0x1f, 0xae, 0xe1, 0xfa, 0x06, 0x1b, 0x00, 0x00, 0x00,
+    0x0f, 0x00, 0x04, 0xc1, 0x1f, 0xd4, 0x00, 0x04, 0x07, 0x1f, 0x76, 0x00,
+    0x04, 0x40, 0x1f, 0x40, 0x00, 0x04, 0xff, 0xff, 0xa6, 0x50, 0x1f, 0xae,
+    0xe1, 0xfa, 0x06, 0x1b, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0xa6, 0x1f,
+    0xb9, 0x00, 0x04, 0x07, 0x1f, 0x76, 0x00, 0x04, 0x40, 0x1f, 0x25, 0x00,
+    0x04, 0xff, 0xff, 0xc1, 0x50, 0x1f, 0xae, 0xe1, 0xfa, 0x06, 0xe8, 0x00,
+    0x00, 0x00, 0x0f, 0xd9, 0x01, 0x25, 0x1b, 0x0c, 0xd9, 0x01, 0x16, 0x4f,
+    0xd9, 0x01, 0x1b, 0x9b, 0xd9, 0x01, 0x16, 0x5b, 0xd9, 0x01, 0x1b, 0xa9,
+    0xd9, 0x01, 0x16, 0x55, 0xd9, 0x01, 0x1b, 0x94, 0xd9, 0x01, 0x10, 0xfd,
+    0xd9, 0x01, 0x11, 0x9e, 0xd9, 0x01, 0x1b, 0xc6, 0xd9, 0x01, 0x16, 0x4d,
+    0xd9, 0x01, 0x1b, 0x80, 0xd9, 0x01, 0x16, 0x10, 0xd9, 0x01, 0x1b, 0x77,
+    0xd9, 0x01, 0x16, 0x07, 0xd9, 0x01, 0x1b, 0x2d, 0xd9, 0x01, 0x16, 0xbc,
+    0xd9, 0x01, 0x1b, 0x88, 0xd9, 0x01, 0x1f, 0x0c, 0xd9, 0x01, 0x2d, 0x1f,
+    0x79, 0xd9, 0x01, 0x0a, 0x1b, 0x90, 0xd9, 0x01, 0x16, 0x13, 0xd9, 0x01,
+    0x1b, 0x35, 0xd9, 0x01, 0x16, 0xc9, 0xd9, 0x01, 0x1b, 0x25, 0xd9, 0x01,
+    0x1f, 0xd4, 0xd9, 0x01, 0x00, 0x03, 0xd9, 0x05, 0x1f, 0xe2, 0xd9, 0x05,
+    0x07, 0x1f, 0xe0, 0xd9, 0x05, 0x07, 0x1f, 0xfc, 0xd9, 0x05, 0x07, 0x1f,
+    0x2d, 0xd9, 0x05, 0x07, 0x1f, 0xf0, 0xd9, 0x05, 0x07, 0x1f, 0x2e, 0xd9,
+    0x05, 0x07, 0x1b, 0xf4, 0xd9, 0x05, 0x1f, 0x15, 0xd9, 0x05, 0x4b, 0x1b,
+    0xc4, 0xd9, 0x05, 0x16, 0xb0, 0xd9, 0x05, 0x1b, 0xd2, 0xd9, 0x05, 0x16,
+    0x3c, 0xd9, 0x05, 0x1b, 0xe1, 0xd9, 0x05, 0x16, 0xae, 0xd9, 0x05, 0x1b,
+    0xda, 0xd9, 0x05, 0x16, 0x72, 0xd9, 0x05, 0x1b, 0xb2, 0xd9, 0x05, 0x16,
+    0xfa, 0xd9, 0x05, 0x1b, 0x66, 0xd9, 0x05, 0x16, 0x3a, 0xd9, 0x05, 0x1b,
+    0x84, 0xd9, 0x05, 0x16, 0xe8, 0xd9, 0x05, 0x1b, 0x2f, 0xd9, 0x05, 0x16,
+    0xa1, 0xd9, 0x05, 0x1b, 0x9c, 0xd9, 0x05, 0x1f, 0x94, 0xd9, 0x05, 0x0e,
+    0x50, 0x34, 0x23, 0x3b, 0x3e, 0xb6, 0x25, 0x00, 0x00, 0x00, 0x0f, 0x00,
+    0x04, 0x70, 0x1f, 0x83, 0x00, 0x04, 0x07, 0x1f, 0x32, 0x00, 0x04, 0x94,
+    0x1f, 0x5e, 0x00, 0x04, 0x07, 0x1f, 0x7c, 0x00, 0x04, 0x40, 0x1f, 0xca,
+    0x00, 0x04, 0xff, 0xff, 0x34, 0x50, 0x34, 0x23, 0x3b, 0x3e, 0xb6, 0x25,
+    0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0x55, 0x1f, 0x68, 0x00, 0x04, 0x07,
+    0x1f, 0x41, 0x00, 0x04, 0x94, 0x1f, 0x43, 0x00, 0x04, 0x07, 0x1f, 0xe7,
+    0x00, 0x04, 0x40, 0x1f, 0xaf, 0x00, 0x04, 0xff, 0xff, 0x4f, 0x50, 0x34,
+    0x23, 0x3b, 0x3e, 0xb6, 0x25, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x04, 0x3a,
+    0x1f, 0x4d, 0x00, 0x04, 0x07, 0x1f, 0x8f, 0x00, 0x04, 0x94, 0x1f, 0x28,
+    0x00, 0x04, 0x07, 0x1f, 0x89, 0x00, 0x04, 0x40, 0x1f, 0x94, 0x00, 0x04,
+    0xff, 0xff, 0x6a, 0x50, 0x34, 0x23, 0x3b, 0x3e, 0xb6, 0x00, 0x00, 0x00,
+    0x00, 0x6a, 0x19, 0xc0, 0x8d,
+};
+
+/* lz4 -B4 -BX --no-frame-crc */
+static const uint8_t lz4_frame_block_crc[3351] = {
+    0x04, 0x22, 0x4d, 0x18, 0x70, 0x40, 0xad, 0x7c, 0x07, 0x00, 0x00, 0xff,
+    0xff, 0xff, 0xff, 0xf4, 0x0b, 0x6f, 0x2e, 0x99, 0xa5, 0x77, 0x20, 0x6a,
+    0x26, 0x93, 0x77, 0xaf, 0x20, 0x25, 0xfb, 0x4e, 0xe0, 0x95, 0x4e, 0x91,
+    0x9f, 0xfa, 0x7e, 0xb0, 0x1a, 0x9e, 0x16, 0x5e, 0x31, 0x67, 0xc3, 0x58,
+    0x1f, 0xfa, 0x77, 0x8e, 0x79, 0x1c, 0x98, 0x5a, 0xf8, 0x9f, 0x9e, 0xfc,
+    0xbf, 0xed, 0x3c, 0x30, 0xaf, 0xee, 0xec, 0xa0, 0xe6, 0xe9, 0x82, 0x91,
+    0x84, 0x9d, 0x16, 0xfa, 0x5a, 0xa0, 0x6c, 0xf2, 0x0f, 0xd9, 0xb2, 0x27,
+    0xec, 0x96, 0x2d, 0xb6, 0x53, 0x91, 0x39, 0xae, 0x9b, 0xec, 0xa9, 0x0d,
+    0xc5, 0xf3, 0x77, 0xf9, 0x55, 0x31, 0x53, 0x8d, 0x3b, 0x1b, 0x69, 0x7e,
+    0x99, 0x6c, 0x8b, 0x6c, 0xd1, 0xf0, 0x8b, 0x9a, 0x1e, 0x50, 0x65, 0x75,
+    0xbf, 0x30, 0x9c, 0x16, 0x56, 0x9f, 0xdd, 0xa9, 0x18, 0xb0, 0xca, 0x67,
+    0xeb, 0xc3, 0x82, 0x90, 0x82, 0xc9, 0x51, 0x92, 0x2e, 0x92, 0x8b, 0x3d,
+    0xd8, 0xf2, 0x8d, 0xc8, 0x6f, 0x42, 0x60, 0xfa, 0xba, 0x93, 0x78, 0xb1,
+    0x4b, 0x92, 0x91, 0xb0, 0x16, 0xfe, 0x9b, 0x61, 0xe5, 0x1d, 0x3f, 0xf4,
+    0x99, 0xa0, 0x6b, 0x07, 0x12, 0xe0, 0xf0, 0xca, 0x11, 0x5c, 0x1b, 0x40,
+    0x78, 0xef, 0xda, 0x15, 0xc3, 0x19, 0xd8, 0x28, 0x94, 0x5b, 0x98, 0xbe,
+    0xad, 0x7f, 0x7e, 0x0d, 0xb9, 0x49, 0x54, 0x7d, 0xbb, 0xe8, 0xb3, 0xdc,
+    0xfd, 0x34, 0x5c, 0x62, 0xe8, 0x78, 0x76, 0x3b, 0x0e, 0x66, 0x2c, 0x01,
+    0x53, 0x6f, 0x24, 0x4f, 0x05, 0x9c, 0xe1, 0x58, 0x45, 0xa4, 0xe2, 0x38,
+    0x1d, 0xdb, 0x28, 0x5d, 0x1f, 0x34, 0x7d, 0x3d, 0x60, 0x76, 0x8d, 0x42,
+    0x42, 0x5d, 0xbd, 0x9e, 0x43, 0x43, 0x4a, 0x65, 0xe0, 0x90, 0x21, 0x26,
+    0x2f, 0x03, 0x78, 0xf1, 0xc1, 0xa9, 0x11, 0x60, 0xff, 0xf5, 0xbc, 0x31,
+    0xf8, 0x62, 0x7c, 0x7f, 0x6c, 0x99, 0x5c, 0x92, 0x81, 0xec, 0xe7, 0xfb,
+    0x65, 0xad, 0xc4, 0x53, 0xd9, 0xbe, 0xee, 0xdb, 0x5e, 0x4b, 0x84, 0xe5,
+    0x83, 0x95, 0x33, 0xaa, 0x8b, 0x44, 0xb0, 0x02, 0x75, 0x9d, 0xbd, 0x25,
+    0x0a, 0x9f, 0xbe, 0x67, 0x83, 0xd2, 0xc9, 0x90, 0xfe, 0x57, 0xc8, 0x4b,
+    0xad, 0x8c, 0x07, 0xc6, 0x9d, 0x3a, 0x49, 0x81, 0x65, 0x3c, 0x4a, 0xec,
+    0x2a, 0x01, 0x3e, 0x44, 0xc2, 0x5c, 0xac, 0xdd, 0xe1, 0x94, 0xc5, 0xbf,
+    0xa4, 0x8a, 0x15, 0x46, 0xd3, 0x81, 0x1e, 0x38, 0xc5, 0xd5, 0x44, 0x6b,
+    0xae, 0xa3, 0x25, 0xf9, 0xc1, 0x3e, 0x36, 0xa4, 0x7e, 0xf2, 0x3c, 0xda,
+    0x06, 0x62, 0x0c, 0x83, 0x54, 0x90, 0x9e, 0x87, 0xb8, 0x59, 0x58, 0xb3,
+    0xe6, 0xf7, 0x29, 0x72, 0x86, 0xc4, 0xd9, 0x7c, 0x13, 0x63, 0x96, 0x70,
+    0x6b, 0x07, 0xb2, 0xfe, 0x67, 0x69, 0x1d, 0x10, 0x64, 0xbe, 0x02, 0x1d,
+    0x83, 0xb7, 0x93, 0x98, 0x13, 0x52, 0xfa, 0x19, 0x74, 0x0e, 0xeb, 0xba,
+    0x51, 0xcc, 0x56, 0xd4, 0x09, 0x66, 0x31, 0xf4, 0xb3, 0xcf, 0x53, 0xd2,
+    0x02, 0x42, 0xf0, 0x9f, 0xfc, 0xcb, 0x0a, 0xde, 0x46, 0x3a, 0x0a, 0xb5,
+    0x83, 0x52, 0x40, 0x64, 0xf9, 0xab, 0x00, 0x41, 0x84, 0xae, 0xa8, 0x7c,
+    0x88, 0xa1, 0xab, 0x7e, 0x64, 0x9a, 0x8f, 0xa3, 0xa5, 0xe7, 0x5e, 0xac,
+    0xe8, 0x2e, 0xff, 0x23, 0x36, 0x55, 0x83, 0x8f, 0x51, 0x03, 0x4c, 0x2f,
+    0x28, 0x3e, 0xa1, 0xa1, 0x77, 0x78, 0x15, 0xa9, 0x45, 0x16, 0xd3, 0xf6,
+    0xc8, 0x37, 0xb2, 0xa1, 0xe5, 0x4e, 0xae, 0xc9, 0x3f, 0xdd, 0x16, 0x78,
+    0xa4, 0x51, 0x9c, 0xc1, 0x44, 0xdb, 0x1a, 0xbf, 0xf5, 0xc0, 0xa2, 0xe2,
+    0x80, 0x82, 0x42, 0xbc, 0xb0, 0xd5, 0x94, 0x2d, 0xa3, 0x42, 0xe9, 0xa8,
+    0x92, 0xf7, 0xc3, 0xf2, 0x16, 0x14, 0xe1, 0x94, 0xa0, 0x82, 0x0f, 0xd4,
+    0x9e, 0x1b, 0x84, 0x06, 0x8c, 0xbb, 0x73, 0x76, 0xf0, 0x71, 0x30, 0x41,
+    0xf7, 0xf7, 0xf6, 0xe1, 0x34, 0x23, 0x3b, 0x3e, 0xb6, 0xf0, 0x1b, 0x91,
+    0x7b, 0x5f, 0x4f, 0x58, 0xf5, 0x47, 0xb2, 0x3c, 0x1e, 0xd2, 0x3e, 0xa1,
+    0x57, 0x41, 0x21, 0x3d, 0x14, 0x36, 0x39, 0xf0, 0x03, 0xa3, 0x1d, 0xbc,
+    0x39, 0x0e, 0x89, 0x98, 0x9a, 0xd2, 0xd1, 0x7b, 0x79, 0x95, 0xaa, 0xd3,
+    0x28, 0x0e, 0x75, 0x58, 0xfd, 0xda, 0xd9, 0xda, 0xfd, 0xf1, 0x54, 0x82,
+    0x36, 0x0e, 0x16, 0xaf, 0x77, 0x0c, 0x47, 0x55, 0xe8, 0x04, 0x94, 0x96,
+    0xc2, 0xc3, 0x9b, 0xf0, 0x18, 0xd9, 0x97, 0x41, 0x7d, 0x4f, 0x66, 0x76,
+    0xf2, 0xd8, 0xc2, 0xa7, 0x5e, 0xf7, 0x51, 0xfc, 0x9b, 0x81, 0xdb, 0x8d,
+    0xb5, 0x6f, 0xd1, 0x2d, 0xf7, 0xce, 0xf6, 0xc2, 0xec, 0x74, 0xcb, 0x9f,
+    0x5b, 0x99, 0x18, 0x07, 0xf3, 0x8f, 0xae, 0xcd, 0x2f, 0x3d, 0x43, 0xa9,
+    0x99, 0x0a, 0xf8, 0xcd, 0x83, 0x65, 0xf8, 0xc8, 0xd9, 0x16, 0x32, 0xb3,
+    0x96, 0x07, 0x27, 0x55, 0x16, 0x22, 0x51, 0x9f, 0x41, 0x91, 0x8b, 0xb9,
+    0x44, 0x5c, 0x94, 0x80, 0x62, 0x49, 0x80, 0x2d, 0x07, 0x6d, 0xc7, 0x86,
+    0x2d, 0xda, 0x39, 0xc8, 0xbc, 0x59, 0xfd, 0x41, 0x70, 0x10, 0x78, 0x32,
+    0x76, 0x97, 0xb6, 0x77, 0xc5, 0xc6, 0xab, 0x14, 0xe7, 0x55, 0x78, 0xa1,
+    0xb5, 0x04, 0x7a, 0x2e, 0x3e, 0xf1, 0xd4, 0x20, 0xd1, 0x4d, 0xc5, 0x21,
+    0xf3, 0x9a, 0xe1, 0x1c, 0xaf, 0x1b, 0x1a, 0xe9, 0x80, 0x28, 0x21, 0x16,
+    0xde, 0x8d, 0x8d, 0x04, 0x0e, 0x21, 0xd8, 0x2b, 0xd0, 0x46, 0x0e, 0x51,
+    0x10, 0xef, 0xd5, 0x04, 0xa5, 0x77, 0x21, 0x95, 0xcf, 0x46, 0xab, 0x77,
+    0xf5, 0x23, 0x17, 0xb4, 0xe5, 0xb6, 0x54, 0xdb, 0x80, 0x84, 0xa4, 0x9f,
+    0xa9, 0x74, 0x4d, 0x07, 0xd3, 0xae, 0xf5, 0xe8, 0x8a, 0x51, 0x1b, 0x04,
+    0xda, 0x5d, 0x2d, 0x0f, 0x5c, 0xd8, 0x42, 0x71, 0x65, 0xf0, 0x56, 0x7d,
+    0x8f, 0xaf, 0xaf, 0x8f, 0x9b, 0x95, 0xbc, 0x27, 0x62, 0x10, 0x8e, 0x08,
+    0x5d, 0xac, 0xc4, 0xef, 0xf6, 0x88, 0x91, 0x60, 0x9c, 0x50, 0x25, 0xa9,
+    0x62, 0xd8, 0xa8, 0x12, 0x99, 0x15, 0x99, 0xd6, 0xa7, 0x0c, 0x2b, 0x65,
+    0x18, 0xf8, 0x01, 0x0c, 0x9f, 0xbf, 0x6b, 0xef, 0x89, 0x79, 0xec, 0x12,
+    0xdb, 0x94, 0xc0, 0xc2, 0x16, 0xec, 0xa0, 0xa7, 0x67, 0xd6, 0xff, 0x51,
+    0xaa, 0xf3, 0x81, 0xff, 0x90, 0x52, 0x5e, 0x01, 0xe0, 0x2f, 0xf8, 0xe7,
+    0x84, 0x5b, 0xd1, 0x68, 0xec, 0x1b, 0xbb, 0xa4, 0xf8, 0x01, 0xcd, 0x42,
+    0x6d, 0x1a, 0x93, 0x7a, 0xac, 0x71, 0x80, 0x11, 0x2c, 0xb5, 0x88, 0xe4,
+    0xea, 0x93, 0x7c, 0x6e, 0xd5, 0x09, 0x83, 0x80, 0xf0, 0xc9, 0xcb, 0x0a,
+    0x9a, 0x64, 0x58, 0xa9, 0x4d, 0xe5, 0x77, 0x62, 0xc1, 0x0f, 0x4d, 0xbd,
+    0x2d, 0x54, 0x84, 0x1f, 0x2f, 0x54, 0x05, 0x1b, 0x90, 0x6c, 0x53, 0x25,
+    0xd7, 0xa2, 0xe0, 0xc9, 0x7c, 0xf7, 0x7e, 0x5a, 0x1f, 0xf1, 0xc9, 0xcd,
+    0x13, 0xe5, 0x1d, 0x13, 0x30, 0x4d, 0x7b, 0x3b, 0xa2, 0x35, 0x7e, 0x35,
+    0x40, 0x93, 0x2b, 0xea, 0x9b, 0x07, 0x4d, 0x0d, 0xc2, 0x60, 0xa9, 0xe0,
+    0x80, 0xe3, 0x2b, 0xc9, 0x86, 0x2d, 0xef, 0x6a, 0xc0, 0x30, 0xb5, 0xae,
+    0xd3, 0x9f, 0x25, 0xe7, 0x81, 0xd6, 0xfd, 0xfa, 0x67, 0x01, 0x09, 0x3f,
+    0x5e, 0x18, 0x71, 0x75, 0x6b, 0xf5, 0xd4, 0x10, 0x0e, 0x95, 0x30, 0xb1,
+    0x56, 0x4d, 0x87, 0x86, 0x05, 0x80, 0xd5, 0xfb, 0xc0, 0x1f, 0xae, 0xe1,
+    0xfa, 0x06, 0xae, 0x00, 0x28, 0xfc, 0x89, 0xb6, 0x69, 0xe2, 0x61, 0x1c,
+    0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x21, 0x06, 0x5b, 0x00, 0x04, 0xff, 0xff,
+    0xff, 0xba, 0x1f, 0xca, 0x00, 0x04, 0xff, 0xff, 0xff, 0xd4, 0x1f, 0xaf,
+    0x00, 0x08, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0x94,
+    0x00, 0x0c, 0x07, 0x0f, 0x00, 0x04, 0x41, 0x0f, 0x03, 0x10, 0xff, 0xff,
+    0xff, 0x66, 0x1f, 0x79, 0x03, 0x10, 0xff, 0xff, 0xff, 0xd4, 0x1f, 0x5e,
+    0x03, 0x14, 0x5b, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0x43,
+    0x03, 0x18, 0x5b, 0x0f, 0x03, 0x0c, 0x41, 0x0f, 0x03, 0x1c, 0xff, 0xff,
+    0xff, 0x12, 0x1f, 0x28, 0x03, 0x1c, 0x5b, 0x0f, 0x03, 0x10, 0x5c, 0x0f,
+    0x00, 0x04, 0xff, 0xff, 0xf6, 0x1f, 0x0d, 0x03, 0x20, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0xf2, 0x03, 0x24, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0xd7, 0x03, 0x28, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0xbc, 0x03, 0x2c, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0xa1, 0x03, 0x30, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0x86, 0x03, 0x34, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0x6b, 0x03, 0x38, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0x50, 0x03, 0x3c, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0x83, 0x0f, 0x06, 0x3c, 0xff, 0xff, 0x24, 0x1f, 0x35, 0x06,
+    0x40, 0x5b, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0x1a, 0x06,
+    0x44, 0x5b, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0xff, 0x06,
+    0x48, 0x5b, 0x0f, 0x03, 0x0c, 0xff, 0x83, 0x0f, 0x00, 0x0c, 0xff, 0xcf,
+    0x1f, 0xe4, 0x06, 0x4c, 0x5b, 0x0f, 0x03, 0x10, 0xff, 0x9e, 0x0f, 0x00,
+    0x04, 0xff, 0xb4, 0x1f, 0xc9, 0x06, 0x50, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0xae, 0x06, 0x54, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x93, 0x06, 0x58, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x78, 0x06, 0x5c, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x5d, 0x06, 0x60, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x42, 0x06, 0x64, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x27, 0x06, 0x68, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xff, 0xba, 0x1f, 0x0c, 0x06, 0x6c, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xc8, 0x0f, 0x09, 0x6c, 0xde, 0x1f, 0xf1, 0x09, 0x70, 0x5b, 0x0f,
+    0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0xd6, 0x09, 0x74, 0x5b, 0x0f,
+    0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0xbb, 0x09, 0x78, 0x5b, 0x0f,
+    0x03, 0x0c, 0xff, 0xff, 0xc8, 0x0f, 0x03, 0x3c, 0x8a, 0x1f, 0xa0, 0x09,
+    0x7c, 0x5b, 0x0f, 0x03, 0x10, 0xff, 0xff, 0xe3, 0x0f, 0x00, 0x04, 0x6f,
+    0x1f, 0x85, 0x09, 0x80, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0x6a, 0x09, 0x84, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0x4f, 0x09, 0x88, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0x34, 0x09, 0x8c, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0x19, 0x09, 0x90, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0xfe, 0x00, 0x24, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x1f, 0xe3, 0x09, 0x94, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x16, 0xc8, 0x09, 0x98, 0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0xff,
+    0xff, 0xba, 0x16, 0xad, 0x09, 0x9c, 0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04,
+    0x25, 0x2f, 0x69, 0xe2, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x80, 0x19, 0x92,
+    0x0c, 0xa0, 0x0f, 0x09, 0x84, 0x4e, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff,
+    0x66, 0x1f, 0x77, 0x0c, 0xa4, 0x15, 0x0f, 0x00, 0x04, 0x33, 0x0f, 0x03,
+    0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0x5c, 0x0c, 0xa8, 0x30, 0x0f, 0x00,
+    0x04, 0x18, 0x0f, 0x03, 0x0c, 0x25, 0x0f, 0x03, 0x18, 0xff, 0xff, 0xff,
+    0x2e, 0x1f, 0x41, 0x0c, 0xac, 0x4b, 0x0c, 0x00, 0x04, 0x0f, 0x03, 0x10,
+    0x40, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0x13, 0x16, 0x26, 0x0c, 0xb0,
+    0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x0b,
+    0x0c, 0xb4, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x16, 0xf0, 0x0c, 0xb8, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04, 0xff, 0xff,
+    0xff, 0xba, 0x16, 0xd5, 0x0c, 0xbc, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04,
+    0xff, 0xff, 0xff, 0xba, 0x16, 0xba, 0x0c, 0xc0, 0x0c, 0x09, 0x90, 0x0f,
+    0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x9f, 0x0c, 0xc4, 0x0c, 0x06,
+    0x84, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x84, 0x0c, 0xc8,
+    0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x69,
+    0x0c, 0xcc, 0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0x6a, 0x0f, 0x03,
+    0x2c, 0xff, 0xff, 0x3d, 0x19, 0x4e, 0x0f, 0xd0, 0x0f, 0x09, 0x84, 0x4e,
+    0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f, 0x33, 0x0f, 0xd4, 0x15,
+    0x0f, 0x00, 0x04, 0x33, 0x0f, 0x03, 0x0c, 0xff, 0xff, 0xff, 0x66, 0x1f,
+    0x18, 0x0f, 0xd8, 0x30, 0x0f, 0x00, 0x04, 0x18, 0x0f, 0x03, 0x0c, 0xff,
+    0x6a, 0x0f, 0x03, 0x2c, 0xff, 0xe8, 0x1f, 0xfd, 0x0f, 0xdc, 0x4b, 0x0c,
+    0x00, 0x04, 0x0f, 0x03, 0x10, 0xff, 0x85, 0x0f, 0x00, 0x04, 0xff, 0xcd,
+    0x16, 0xe2, 0x0f, 0xe0, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04, 0xff, 0xff,
+    0xff, 0xba, 0x16, 0xc7, 0x0f, 0xe4, 0x0c, 0x09, 0x90, 0x0f, 0x00, 0x04,
+    0xff, 0xff, 0xff, 0xba, 0x16, 0xac, 0x0f, 0xe8, 0x0c, 0x09, 0x90, 0x0f,
+    0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x1f, 0x91, 0x09, 0x90, 0x07, 0x0f,
+    0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x76, 0x0f, 0xf0, 0x0c, 0x09,
+    0x90, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x5b, 0x0f, 0xf4,
+    0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba, 0x16, 0x40,
+    0x0f, 0xf8, 0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0xff, 0xff, 0xba,
+    0x16, 0x25, 0x0f, 0xfc, 0x0c, 0x06, 0x84, 0x0f, 0x00, 0x04, 0xff, 0xff,
+    0xaa, 0x50, 0xfa, 0x06, 0xae, 0x00, 0x28, 0xed, 0x77, 0xed, 0xb8, 0x80,
+    0x05, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xf4, 0xae, 0x00, 0x28, 0xfc,
+    0x89, 0xb6, 0x69, 0xfe, 0x61, 0x1c, 0xa7, 0x61, 0xb3, 0xd1, 0xf6, 0x21,
+    0x06, 0x5b, 0x0b, 0x6f, 0x2e, 0x99, 0xa5, 0x77, 0x20, 0x6a, 0x26, 0x93,
+    0x77, 0xaf, 0x20, 0x25, 0xfb, 0x4e, 0x19, 0x95, 0x4e, 0x91, 0x9f, 0xfa,
+    0x7e, 0xb0, 0x1a, 0x9e, 0x16, 0x5e, 0x31, 0x67, 0xc3, 0x58, 0x1f, 0xfa,
+    0x77, 0x8e, 0x79, 0x1c, 0x98, 0x5a, 0xf8, 0x9f, 0x9e, 0x34, 0xbf, 0xed,
+    0x3c, 0x30, 0xaf, 0xee, 0xec, 0xa0, 0xe6, 0xe9, 0x82, 0x91, 0x84, 0x9d,
+    0x16, 0xfa, 0x5a, 0xa0, 0x6c, 0xf2, 0x0f, 0xd9, 0xb2, 0x27, 0xec, 0x96,
+    0x4f, 0xb6, 0x53, 0x91, 0x39, 0xae, 0x9b, 0xec, 0xa9, 0x0d, 0xc5, 0xf3,
+    0x77, 0xf9, 0x55, 0x31, 0x53, 0x8d, 0x3b, 0x1b, 0x69, 0x7e, 0x99, 0x6c,
+    0x8b, 0x6c, 0xd1, 0x6a, 0x8b, 0x9a, 0x1e, 0x50, 0x65, 0x75, 0xbf, 0x30,
+    0x9c, 0x16, 0x56, 0x9f, 0xdd, 0xa9, 0x18, 0xb0, 0xca, 0x67, 0xeb, 0xc3,
+    0x82, 0x90, 0x82, 0xc9, 0x51, 0x92, 0x85, 0x92, 0x8b, 0x3d, 0xd8, 0xf2,
+    0x8d, 0xc8, 0x6f, 0x42, 0x60, 0xfa, 0xba, 0x93, 0x78, 0xb1, 0x4b, 0x92,
+    0x91, 0xb0, 0x16, 0xfe, 0x9b, 0x61, 0xe5, 0x1d, 0x3f, 0xa0, 0x99, 0xa0,
+    0x6b, 0x07, 0x12, 0xe0, 0xf0, 0xca, 0x11, 0x5c, 0x1b, 0x40, 0x78, 0xef,
+    0xda, 0x15, 0xc3, 0x19, 0xd8, 0x28, 0x94, 0x5b, 0x98, 0xbe, 0xad, 0x7f,
+    0x7e, 0x0d, 0xb9, 0x49, 0x54, 0x7d, 0xbb, 0xe8, 0xb3, 0xdc, 0xfd, 0x34,
+    0x5c, 0x62, 0xe8, 0x78, 0x76, 0x3b, 0x0e, 0x66, 0x2c, 0x01, 0x53, 0x6f,
+    0x24, 0x4f, 0x05, 0x9c, 0xe1, 0x58, 0x45, 0xa4, 0xe2, 0x38, 0x1d, 0xdb,
+    0x28, 0x5d, 0x1f, 0x34, 0x7d, 0x3d, 0x60, 0x76, 0x8d, 0x42, 0x42, 0x5d,
+    0xbd, 0x9e, 0x43, 0x43, 0x4a, 0x65, 0xe0, 0x90, 0x21, 0x26, 0x2f, 0x03,
+    0x78, 0xf1, 0xc1, 0xa9, 0x11, 0x60, 0xff, 0xf5, 0xbc, 0x31, 0x0a, 0x62,
+    0x7c, 0x7f, 0x6c, 0x99, 0x5c, 0x92, 0x81, 0xec, 0xe7, 0xfb, 0x65, 0xad,
+    0x0c, 0x53, 0xd9, 0xbe, 0xee, 0xdb, 0x5e, 0x4b, 0x84, 0xe5, 0x83, 0x95,
+    0x33, 0xaa, 0x8b, 0x44, 0xb0, 0x02, 0x75, 0x9d, 0xbd, 0x25, 0x0a, 0x9f,
+    0xbe, 0x67, 0x83, 0x27, 0xc9, 0x90, 0xfe, 0x57, 0xc8, 0x4b, 0xad, 0x8c,
+    0x07, 0xc6, 0x9d, 0x3a, 0x49, 0x81, 0x65, 0x3c, 0x4a, 0xec, 0x2a, 0x01,
+    0x3e, 0x44, 0xc2, 0x5c, 0xac, 0xdd, 0x42, 0x94, 0xc5, 0xbf, 0xa4, 0x8a,
+    0x15, 0x46, 0xd3, 0x81, 0x1e, 0x38, 0xc5, 0xd5, 0x44, 0x6b, 0xae, 0xa3,
+    0x25, 0xf9, 0xc1, 0x3e, 0x36, 0xa4, 0x7e, 0xf2, 0x3c, 0x5d, 0x06, 0x62,
+    0x0c, 0x83, 0x54, 0x90, 0x9e, 0x87, 0xb8, 0x59, 0x58, 0xb3, 0xe6, 0xf7,
+    0x29, 0x76, 0x86, 0xc4, 0xd9, 0x7c, 0x13, 0x63, 0x96, 0x70, 0x6b, 0x07,
+    0x78, 0xfe, 0x67, 0x69, 0x1d, 0x10, 0x64, 0xbe, 0x02, 0x1d, 0x83, 0xb7,
+    0x93, 0x98, 0x13, 0x52, 0x91, 0x19, 0x74, 0x0e, 0xeb, 0xba, 0x51, 0xcc,
+    0x56, 0xd4, 0x09, 0x93, 0x31, 0xf4, 0xb3, 0xcf, 0x53, 0xd2, 0x02, 0x42,
+    0xf0, 0x9f, 0xfc, 0xcb, 0x0a, 0xde, 0x46, 0xac, 0x0a, 0xb5, 0x83, 0x52,
+    0x40, 0x64, 0xf9, 0xab, 0x00, 0x41, 0xae, 0xae, 0xa8, 0x7c, 0x88, 0xa1,
+    0xab, 0x7e, 0x64, 0x9a, 0x8f, 0xa3, 0xa5, 0xe7, 0x5e, 0xac, 0xc7, 0x2e,
+    0xff, 0x23, 0x36, 0x55, 0x83, 0x8f, 0x51, 0x03, 0x4c, 0xc9, 0x28, 0x3e,
+    0xa1, 0xa1, 0x77, 0x78, 0x15, 0xa9, 0x45, 0x16, 0xd3, 0xf6, 0xc8, 0x37,
+    0xb2, 0xe2, 0xe5, 0x4e, 0xae, 0xc9, 0x3f, 0xdd, 0x16, 0x78, 0xa4, 0x51,
+    0xe4, 0xc1, 0x44, 0xdb, 0x1a, 0xbf, 0xf5, 0xc0, 0xa2, 0xe2, 0x80, 0x82,
+    0x42, 0xbc, 0xb0, 0xd5, 0xfd, 0x2d, 0xa3, 0x42, 0xe9, 0xa8, 0x92, 0xf7,
+    0xc3, 0xf2, 0x16, 0x14, 0xe1, 0x94, 0xa0, 0x82, 0x0f, 0xd4, 0x9e, 0x1b,
+    0x84, 0x06, 0x8c, 0xbb, 0x73, 0x76, 0xf0, 0x71, 0x30, 0x41, 0xf7, 0xf7,
+    0xf6, 0xe1, 0x34, 0x23, 0x3b, 0x3e, 0xb6, 0xf0, 0x1b, 0x91, 0x7b, 0x5f,
+    0x4f, 0x58, 0xf5, 0x47, 0xb2, 0x3c, 0x1e, 0xd2, 0x3e, 0xa1, 0x57, 0x41,
+    0x21, 0x3d, 0x14, 0x36, 0x39, 0xf0, 0x03, 0xa3, 0x1d, 0xbc, 0x39, 0x0e,
+    0x89, 0x98, 0x9a, 0xd2, 0xd1, 0x7b, 0x79, 0x95, 0xaa, 0xd3, 0x28, 0x0e,
+    0x75, 0x58, 0xfd, 0xda, 0xd9, 0xda, 0xfd, 0xf1, 0x54, 0x82, 0x36, 0x0e,
+    0x16, 0xaf, 0x77, 0x50, 0x47, 0x55, 0xe8, 0x04, 0x94, 0x96, 0xc2, 0xc3,
+    0x9b, 0xf0, 0x18, 0xd9, 0x97, 0x41, 0x7d, 0x69, 0x66, 0x76, 0xf2, 0xd8,
+    0xc2, 0xa7, 0x5e, 0xf7, 0x51, 0xfc, 0x6b, 0x81, 0xdb, 0x8d, 0xb5, 0x6f,
+    0xd1, 0x2d, 0xf7, 0xce, 0xf6, 0xc2, 0xec, 0x74, 0xcb, 0x9f, 0x84, 0x99,
+    0x18, 0x07, 0xf3, 0x8f, 0xae, 0xcd, 0x2f, 0x3d, 0x43, 0x86, 0x99, 0x0a,
+    0xf8, 0xcd, 0x83, 0x65, 0xf8, 0xc8, 0xd9, 0x16, 0x32, 0xb3, 0x96, 0x07,
+    0x27, 0x9f, 0x16, 0x22, 0x51, 0x9f, 0x41, 0x91, 0x8b, 0xb9, 0x44, 0x5c,
+    0xa1, 0x80, 0x62, 0x49, 0x80, 0x2d, 0x07, 0x6d, 0xc7, 0x86, 0x2d, 0xda,
+    0x39, 0xc8, 0xbc, 0x59, 0xba, 0x41, 0x70, 0x10, 0x78, 0x32, 0x76, 0x97,
+    0xb6, 0x77, 0xc5, 0xbc, 0xab, 0x14, 0xe7, 0x55, 0x78, 0xa1, 0xb5, 0x04,
+    0x7a, 0x2e, 0x3e, 0xf1, 0xd4, 0x20, 0xd1, 0xd5, 0xc5, 0x21, 0xf3, 0x9a,
+    0xe1, 0x1c, 0xaf, 0x1b, 0x1a, 0xe9, 0xd7, 0x28, 0x21, 0x16, 0xde, 0x8d,
+    0x8d, 0x04, 0x0e, 0x21, 0xd8, 0x2b, 0xd0, 0x46, 0x0e, 0x51, 0xf0, 0xef,
+    0xd5, 0x04, 0xa5, 0x77, 0x21, 0x95, 0xcf, 0x46, 0xab, 0xf2, 0xf5, 0x23,
+    0x17, 0xb4, 0xe5, 0xb6, 0x54, 0xdb, 0x80, 0x84, 0xa4, 0x9f, 0xa9, 0x74,
+    0x4d, 0x0b, 0xd3, 0xae, 0xf5, 0xe8, 0x8a, 0x51, 0x1b, 0x04, 0xda, 0x5d,
+    0x0d, 0x0f, 0x5c, 0xd8, 0x42, 0x71, 0x65, 0xf0, 0x56, 0x7d, 0x8f, 0xaf,
+    0xaf, 0x8f, 0x9b, 0x95, 0x26, 0x27, 0x62, 0x10, 0x8e, 0x08, 0x5d, 0xac,
+    0xc4, 0xef, 0xf6, 0x28, 0x91, 0x60, 0x9c, 0x50, 0x25, 0xa9, 0x62, 0xd8,
+    0xa8, 0x12, 0x99, 0x15, 0x99, 0xd6, 0xa7, 0x41, 0x2b, 0x65, 0x18, 0xf8,
+    0x01, 0x0c, 0x9f, 0xbf, 0x6b, 0xef, 0x89, 0x79, 0xec, 0x12, 0xdb, 0x94,
+    0xc0, 0xc2, 0x16, 0xec, 0xa0, 0xa7, 0x67, 0xd6, 0xff, 0x51, 0xaa, 0xf3,
+    0x81, 0xff, 0x90, 0x52, 0x5e, 0x01, 0xe0, 0x2f, 0xf8, 0xe7, 0x84, 0x5b,
+    0xd1, 0x68, 0xec, 0x1b, 0xbb, 0xa4, 0xf8, 0x01, 0xcd, 0x42, 0x6d, 0x1a,
+    0x93, 0x7a, 0xac, 0x71, 0x80, 0x11, 0x2c, 0xb5, 0x88, 0xe4, 0xea, 0x93,
+    0x7c, 0x6e, 0xd5, 0x09, 0x83, 0x80, 0xf0, 0xc9, 0xcb, 0x0a, 0x9a, 0x64,
+    0x58, 0xa9, 0x4d, 0xe5, 0x77, 0x62, 0xc1, 0x0f, 0x4d, 0xbd, 0x2d, 0x54,
+    0x84, 0x1f, 0x2f, 0x54, 0x05, 0x1b, 0x94, 0x6c, 0x53, 0x25, 0xd7, 0xa2,
+    0xe0, 0xc9, 0x7c, 0xf7, 0x7e, 0x5a, 0x1f, 0xf1, 0xc9, 0xcd, 0xad, 0xe5,
+    0x1d, 0x13, 0x30, 0x4d, 0x7b, 0x3b, 0xa2, 0x35, 0x7e, 0xaf, 0x40, 0x93,
+    0x2b, 0xea, 0x9b, 0x07, 0x4d, 0x0d, 0xc2, 0x60, 0xa9, 0xe0, 0x80, 0xe3,
+    0x2b, 0xc8, 0x86, 0x2d, 0xef, 0x6a, 0xc0, 0x30, 0xb5, 0xae, 0xd3, 0x9f,
+    0xca, 0xe7, 0x81, 0xd6, 0xfd, 0xfa, 0x67, 0x01, 0x09, 0x3f, 0x5e, 0x18,
+    0x71, 0x75, 0x6b, 0xf5, 0xe3, 0x10, 0x0e, 0x95, 0x30, 0xb1, 0x56, 0x4d,
+    0x87, 0x86, 0x05, 0x80, 0xd5, 0xfb, 0xc0, 0x1f, 0xae, 0xe1, 0xfa, 0x06,
+    0x00, 0x04, 0xdc, 0x1f, 0xef, 0x00, 0x04, 0x07, 0x1f, 0xf8, 0x00, 0x04,
+    0x40, 0x1f, 0x5b, 0x00, 0x04, 0xff, 0xff, 0xff, 0x65, 0x1f, 0xd4, 0x00,
+    0x08, 0x22, 0x0f, 0x00, 0x04, 0x26, 0x1f, 0x40, 0x00, 0x08, 0x07, 0x0f,
+    0x00, 0x04, 0xff, 0xff, 0xff, 0x4b, 0x1f, 0xb9, 0x00, 0x0c, 0x3d, 0x0f,
+    0x00, 0x04, 0x0b, 0x1f, 0x25, 0x00, 0x0c, 0x07, 0x0f, 0x00, 0x04, 0xff,
+    0xff, 0xac, 0x0f, 0xd9, 0x0d, 0x25, 0x1b, 0x0c, 0xd9, 0x0d, 0x16, 0x4f,
+    0xd9, 0x0d, 0x1b, 0x9b, 0xd9, 0x0d, 0x16, 0x5b, 0xd9, 0x0d, 0x1b, 0xa9,
+    0xd9, 0x0d, 0x16, 0x55, 0xd9, 0x0d, 0x1b, 0x94, 0xd9, 0x0d, 0xcb, 0xfd,
+    0x41, 0x70, 0x10, 0x78, 0x9e, 0x76, 0x97, 0xb6, 0x77, 0xc5, 0xc6, 0xd9,
+    0x0d, 0x16, 0x4d, 0xd9, 0x0d, 0x1b, 0x80, 0xd9, 0x0d, 0x16, 0x10, 0xd9,
+    0x0d, 0x1b, 0x77, 0xd9, 0x0d, 0x16, 0x07, 0xd9, 0x0d, 0x1b, 0x2d, 0xd9,
+    0x0d, 0x16, 0xbc, 0xd9, 0x0d, 0x1b, 0x88, 0xd9, 0x0d, 0x1f, 0x0c, 0xd9,
+    0x0d, 0x2d, 0x1f, 0x79, 0xd9, 0x0d, 0x0a, 0x1b, 0x90, 0xd9, 0x0d, 0x16,
+    0x13, 0xd9, 0x0d, 0x1b, 0x35, 0xd9, 0x0d, 0x16, 0xc9, 0xd9, 0x0d, 0x1b,
+    0x25, 0xd9, 0x0d, 0x1f, 0xd4, 0xd9, 0x0d, 0x07, 0x1f, 0xe2, 0xd9, 0x11,
+    0x07, 0x1f, 0xe0, 0xd9, 0x11, 0x07, 0x1f, 0xfc, 0xd9, 0x11, 0x07, 0x1f,
+    0x2d, 0xd9, 0x11, 0x07, 0x1f, 0xf0, 0xd9, 0x11, 0x07, 0x1f, 0x2e, 0xd9,
+    0x11, 0x07, 0x1f, 0xf4, 0xd9, 0x11, 0x4d, 0x0a, 0xd9, 0x05, 0x1f, 0xc4,
+    0xd9, 0x11, 0x07, 0x1f, 0xd2, 0xd9, 0x11, 0x07, 0x1f, 0xe1, 0xd9, 0x11,
+    0x07, 0x1b, 0xda, 0xd9, 0x11, 0x16, 0x72, 0xd9, 0x11, 0x1b, 0xb2, 0xd9,
+    0x11, 0x16, 0xfa, 0xd9, 0x11, 0x1b, 0x66, 0xd9, 0x11, 0x16, 0x3a, 0xd9,
+    0x11, 0x1b, 0x84, 0xd9, 0x11, 0x16, 0xe8, 0xd9, 0x11, 0x1b, 0x2f, 0xd9,
+    0x11, 0x16, 0xa1, 0xd9, 0x11, 0x1b, 0x9c, 0xd9, 0x11, 0x1f, 0x94, 0xd9,
+    0x11, 0x4b, 0x0f, 0x00, 0x04, 0x38, 0x1f, 0x83, 0x00, 0x04, 0x07, 0x1f,
+    0x32, 0x00, 0x04, 0x94, 0x1f, 0x5e, 0xd9, 0x11, 0x25, 0x0f, 0x00, 0x04,
+    0x23, 0x1f, 0xca, 0x00, 0x04, 0xff, 0xff, 0xa1, 0x11, 0x68, 0xd9, 0x15,
+    0x0f, 0x00, 0x08, 0x1d, 0x0f, 0x00, 0x04, 0x7a, 0x1f, 0x43, 0xd9, 0x15,
+    0x40, 0x0f, 0x00, 0x04, 0x08, 0x1f, 0xaf, 0x00, 0x08, 0x07, 0x0f, 0x00,
+    0x04, 0xff, 0xff, 0x87, 0x11, 0x4d, 0xd9, 0x19, 0x0f, 0x00, 0x0c, 0x38,
+    0x0f, 0x00, 0x04, 0x5f, 0x1f, 0x28, 0x00, 0x0c, 0x3d, 0x1f, 0x7c, 0x00,
+    0x0c, 0x0a, 0x1f, 0x94, 0x00, 0x0c, 0x07, 0x0f, 0x00, 0x04, 0xff, 0xff,
+    0x50, 0x50, 0x34, 0x23, 0x3b, 0x3e, 0xb6, 0xa5, 0xf3, 0x84, 0xce, 0x00,
+    0x00, 0x00, 0x00,
+};
+
+#endif/*!LZ4_FRAMES_H_*/
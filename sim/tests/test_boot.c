@@ -0,0 +1,117 @@
+/** @file test_boot.c
+ * \brief Boot bank selection
+ *
+ * A bank is only selected to boot from if its vector table is the one of
+ * an image: the initial stack pointer in SRAM or CCM RAM, the reset handler
+ * in flash. Once booted from bank 2, the banks are swapped in the address
+ * space, sector numbers staying physical.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+
+#define SRAM_END        0x20030000
+#define CCM_END         0x10010000
+
+/* vector table at the start of the bank, as mapped at reset */
+static void poke_vectors(uint8_t sector, uint32_t sp)
+{
+    physaddr_t base = flash_sector_addr(sector);
+    uint32_t vectors[2] = { sp, (uint32_t)base + 0x201 };
+
+    flash_sim_poke(base, vectors, sizeof(vectors));
+}
+
+static bool boot_bank_is(bool bfb2)
+{
+    t_flash_opt opt;
+
+    TEST_ASSERT(flash_opt_read(&opt) == FLASH_ERR_NONE);
+    return opt.bfb2 == bfb2;
+}
+
+/* no image: erased, or a stack pointer past the SRAM or in a hole */
+static void test_invalid(void)
+{
+    static const uint32_t sps[] = {
+        0xffffffff, SRAM_END + 4, 0x20040000, 0x20000000, CCM_END + 4,
+    };
+
+    test_setup();
+    flash_unlock_opt();
+    TEST_ASSERT(flash_boot_set_bank(FLASH_BANK_1) == FLASH_ERR_VERIFY);
+    for (uint32_t i = 0; i < sizeof(sps) / sizeof(sps[0]); ++i) {
+        poke_vectors(12, sps[i]);
+        TEST_ASSERT(flash_boot_set_bank(FLASH_BANK_1) == FLASH_ERR_VERIFY);
+        TEST_ASSERT(boot_bank_is(false));
+    }
+    /* the reset handler must be a thumb address in flash */
+    poke_vectors(12, SRAM_END);
+    flash_sim_poke(flash_sector_addr(12) + 4, &(uint32_t){ 0x20000001 }, 4);
+    TEST_ASSERT(flash_boot_set_bank(FLASH_BANK_1) == FLASH_ERR_VERIFY);
+    TEST_ASSERT(boot_bank_is(false));
+}
+
+/* boot from bank 2, then back from bank 1 */
+static void test_swap(void)
+{
+    uint8_t bank1[16];
+    uint8_t bank2[16];
+    physaddr_t bank2_addr;
+
+    test_setup();
+    bank2_addr = flash_sector_addr(12);
+    poke_vectors(0, CCM_END);
+    poke_vectors(12, SRAM_END);
+    memcpy(bank1, (const void*)flash_sector_addr(0), sizeof(bank1));
+    memcpy(bank2, (const void*)bank2_addr, sizeof(bank2));
+    TEST_ASSERT(flash_boot_get_bank() == FLASH_BANK_0);
+    flash_unlock_opt();
+    TEST_ASSERT(flash_boot_set_bank(FLASH_BANK_1) == FLASH_ERR_NONE);
+    TEST_ASSERT(boot_bank_is(true));
+    /* the bank booted from is the one of the last reset */
+    TEST_ASSERT(flash_boot_get_bank() == FLASH_BANK_0);
+
+    test_reboot();
+    TEST_ASSERT(flash_boot_get_bank() == FLASH_BANK_1);
+    /* bank 2 is at the start of the flash, bank 1 at the bank 2 addresses */
+    TEST_ASSERT(memcmp((const void*)FLASH_SECTOR_0, bank2, sizeof(bank2)) == 0);
+    TEST_ASSERT(memcmp((const void*)bank2_addr, bank1, sizeof(bank1)) == 0);
+    TEST_ASSERT(flash_sector_addr(12) == FLASH_SECTOR_0);
+    TEST_ASSERT(flash_sector_addr(0) == bank2_addr);
+    TEST_ASSERT(flash_select_sector(FLASH_SECTOR_0) == 12);
+    TEST_ASSERT(flash_select_sector(bank2_addr + flash_sector_size(0)) == 1);
+    /* an erase of a physical sector erases it at its swapped address */
+    TEST_ASSERT(flash_sector_erase(FLASH_SECTOR_0) != 0xff);
+    TEST_ASSERT(*(volatile uint32_t*)FLASH_SECTOR_0 == 0xffffffff);
+    TEST_ASSERT(memcmp((const void*)bank2_addr, bank1, sizeof(bank1)) == 0);
+
+    /* the erased bank 2 can't be selected anymore, bank 1 can */
+    flash_unlock_opt();
+    TEST_ASSERT(flash_boot_set_bank(FLASH_BANK_1) == FLASH_ERR_VERIFY);
+    TEST_ASSERT(flash_boot_set_bank(FLASH_BANK_0) == FLASH_ERR_NONE);
+    TEST_ASSERT(boot_bank_is(false));
+    test_reboot();
+    TEST_ASSERT(flash_boot_get_bank() == FLASH_BANK_0);
+    TEST_ASSERT(memcmp((const void*)FLASH_SECTOR_0, bank1, sizeof(bank1)) == 0);
+    TEST_ASSERT(flash_select_sector(FLASH_SECTOR_0) == 0);
+}
+
+int main(void)
+{
+    test_invalid();
+    test_swap();
+    flash_sim_exit();
+    return test_done("boot");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("boot");
+}
+
+#endif
@@ -0,0 +1,90 @@
+/** @file test_busy.c
+ * \brief Bounded busy waits
+ *
+ * An operation which never completes fails with FLASH_ERR_TIMEOUT after its
+ * datasheet max duration (plus margin), the progress hook being called
+ * periodically meanwhile, even when the systick can't be read.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+/* timeouts of the driver: datasheet max duration (x32), and 25% margin */
+#define TMO_ERASE_16K   (500000 + 500000 / 4)
+#define TMO_PROG        (100 + 100 / 4)
+
+#define MAX_CALLS       64
+
+static uint32_t calls[MAX_CALLS];
+static uint32_t nb_calls;
+
+static void hook(uint32_t elapsed_us)
+{
+    TEST_ASSERT(nb_calls < MAX_CALLS);
+    calls[nb_calls++] = elapsed_us;
+}
+
+/* the hook is called at most every period, with an increasing elapsed time */
+static void check_calls(uint32_t period, uint32_t timeout)
+{
+    for (uint32_t i = 0; i < nb_calls; ++i) {
+        TEST_ASSERT(calls[i] >= (i + 1) * period);
+        TEST_ASSERT(i == 0 || calls[i] - calls[i - 1] >= period);
+        TEST_ASSERT(calls[i] <= timeout);
+    }
+    /* and not much less often */
+    TEST_ASSERT(nb_calls >= timeout / period - 2);
+}
+
+static void test_erase_timeout(void)
+{
+    const uint32_t period = 100000;
+    uint64_t start;
+
+    test_setup();
+    nb_calls = 0;
+    flash_set_progress_hook(hook, period);
+    flash_sim_hang_next_op();
+    start = flash_sim_clock_us();
+    TEST_ASSERT(flash_sector_erase(FLASH_SECTOR_1) == 0xff);
+    TEST_ASSERT(flash_get_last_error() == FLASH_ERR_TIMEOUT);
+    /* each status poll is one virtual microsecond */
+    TEST_ASSERT(flash_sim_clock_us() - start > TMO_ERASE_16K);
+    TEST_ASSERT(flash_sim_clock_us() - start < TMO_ERASE_16K + 1000);
+    check_calls(period, TMO_ERASE_16K);
+    flash_set_progress_hook(NULL, 0);
+}
+
+/*
+ * Without systick, the elapsed time is bounded from the number of polls:
+ * the operation still times out, later than the timeout.
+ */
+static void test_no_systick(void)
+{
+    const uint32_t period = 10;
+    uint32_t *word = (uint32_t*)(FLASH_SECTOR_1 + 4);
+    uint64_t start;
+
+    test_setup();
+    flash_sim_set_systick(false);
+    nb_calls = 0;
+    flash_set_progress_hook(hook, period);
+    TEST_ASSERT(flash_program_word(word, 0x12345678) == FLASH_ERR_NONE);
+    TEST_ASSERT(*word == 0x12345678);
+    TEST_ASSERT(nb_calls == 0);
+    flash_sim_hang_next_op();
+    start = flash_sim_clock_us();
+    TEST_ASSERT(flash_program_word(word + 1, 0) == FLASH_ERR_TIMEOUT);
+    TEST_ASSERT(flash_sim_clock_us() - start > TMO_PROG);
+    check_calls(period, TMO_PROG);
+    flash_set_progress_hook(NULL, 0);
+    flash_sim_set_systick(true);
+}
+
+int main(void)
+{
+    test_erase_timeout();
+    test_no_systick();
+    flash_sim_exit();
+    return test_done("busy");
+}
@@ -0,0 +1,164 @@
+/** @file test_digest.c
+ * \brief Per-sector digest cache invalidation
+ *
+ * Only the sectors programmed or erased since their digest was computed are
+ * read and hashed again, the region digest then changing. A bank erase
+ * keeps the cached digests of the other bank.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+#if CONFIG_USR_DRV_FLASH_DIGEST
+
+#include "api/flash_digest.h"
+
+/* the region: three 16KB sectors and a 64KB one */
+#define FIRST           1
+#define NB              4
+#define SECTORS(first, nb) (((1u << (nb)) - 1) << (first))
+
+/* sectors read by the last region(), from the simulator trace */
+static uint32_t reads;
+
+static void trace(const flash_sim_op_t *op)
+{
+    if (op->type == FLASH_SIM_OP_READ_MEM) {
+        reads |= flash_range_sectors(op->addr, (uint32_t)op->value);
+    }
+}
+
+static void fill(uint8_t sector)
+{
+    static uint8_t buf[128 * 1024];
+    uint32_t size = flash_sector_size(sector);
+
+    for (uint32_t i = 0; i < size; ++i) {
+        buf[i] = (uint8_t)(i * 7 + (i >> 8) + sector * 0x35) | 0x80;
+    }
+    flash_sim_poke(flash_sector_addr(sector), buf, size);
+}
+
+static void setup(void)
+{
+    test_setup();
+    for (uint8_t sector = FIRST; sector < FIRST + NB; ++sector) {
+        fill(sector);
+    }
+    TEST_ASSERT(flash_digest_init(&flash_hash_sha256) == FLASH_ERR_NONE);
+    flash_sim_set_trace(trace);
+}
+
+/* region digest, and the sectors read to compute it */
+static uint32_t region(uint8_t first, uint8_t nb, uint8_t *digest)
+{
+    reads = 0;
+    TEST_ASSERT(flash_digest_region(first, nb, digest) == FLASH_ERR_NONE);
+    return reads;
+}
+
+/* the sector digest, against its content hashed from scratch */
+static void check_sector(uint8_t sector)
+{
+    uint8_t ref[FLASH_HASH_MAX_DIGEST];
+    uint8_t digest[FLASH_HASH_MAX_DIGEST];
+    t_flash_hash_ctx ctx;
+
+    flash_hash_init(&ctx, &flash_hash_sha256);
+    flash_hash_update(&ctx, (const uint8_t*)flash_sector_addr(sector), flash_sector_size(sector));
+    flash_hash_final(&ctx, ref);
+    TEST_ASSERT(flash_digest_sector(sector, digest) == FLASH_ERR_NONE);
+    TEST_ASSERT(memcmp(digest, ref, 32) == 0);
+}
+
+static void test_program(void)
+{
+    uint8_t first[FLASH_HASH_MAX_DIGEST];
+    uint8_t digest[FLASH_HASH_MAX_DIGEST];
+    uint8_t again[FLASH_HASH_MAX_DIGEST];
+    physaddr_t addr;
+    uint8_t byte;
+
+    setup();
+    TEST_ASSERT(region(FIRST, NB, first) == SECTORS(FIRST, NB));
+    TEST_ASSERT(region(FIRST, NB, digest) == 0);
+    TEST_ASSERT(memcmp(digest, first, 32) == 0);
+
+    /* a single byte programmed */
+    addr = flash_sector_addr(FIRST + 2) + 1001;
+    byte = *(volatile uint8_t*)addr & 0x0f;
+    TEST_ASSERT(flash_write(addr, &byte, 1) == FLASH_ERR_NONE);
+    TEST_ASSERT(region(FIRST, NB, digest) == SECTORS(FIRST + 2, 1));
+    TEST_ASSERT(memcmp(digest, first, 32) != 0);
+    check_sector(FIRST + 2);
+    /* the same digest as from scratch */
+    TEST_ASSERT(flash_digest_init(&flash_hash_sha256) == FLASH_ERR_NONE);
+    TEST_ASSERT(region(FIRST, NB, again) == SECTORS(FIRST, NB));
+    TEST_ASSERT(memcmp(digest, again, 32) == 0);
+
+    /* an erased sector */
+    TEST_ASSERT(flash_sector_erase(flash_sector_addr(FIRST)) != 0xff);
+    TEST_ASSERT(region(FIRST, NB, again) == SECTORS(FIRST, 1));
+    TEST_ASSERT(memcmp(digest, again, 32) != 0);
+    check_sector(FIRST);
+    /* an explicit invalidation */
+    flash_digest_invalidate(FIRST + 3);
+    TEST_ASSERT(region(FIRST, NB, digest) == SECTORS(FIRST + 3, 1));
+    TEST_ASSERT(memcmp(digest, again, 32) == 0);
+    flash_sim_set_trace(NULL);
+}
+
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+
+/* the same region in each bank */
+#define BANK2           12
+
+static void test_bank_erase(void)
+{
+    uint8_t bank1[FLASH_HASH_MAX_DIGEST];
+    uint8_t bank2[FLASH_HASH_MAX_DIGEST];
+    uint8_t digest[FLASH_HASH_MAX_DIGEST];
+
+    setup();
+    for (uint8_t sector = BANK2 + FIRST; sector < BANK2 + FIRST + NB; ++sector) {
+        fill(sector);
+    }
+    TEST_ASSERT(region(FIRST, NB, bank1) == SECTORS(FIRST, NB));
+    TEST_ASSERT(region(BANK2 + FIRST, NB, bank2) == SECTORS(BANK2 + FIRST, NB));
+
+    TEST_ASSERT(flash_bank_erase(1) == FLASH_ERR_NONE);
+    TEST_ASSERT(region(FIRST, NB, digest) == 0);
+    TEST_ASSERT(memcmp(digest, bank1, 32) == 0);
+    TEST_ASSERT(region(BANK2 + FIRST, NB, digest) == SECTORS(BANK2 + FIRST, NB));
+    TEST_ASSERT(memcmp(digest, bank2, 32) != 0);
+    memcpy(bank2, digest, sizeof(bank2));
+
+    TEST_ASSERT(flash_bank_erase(0) == FLASH_ERR_NONE);
+    TEST_ASSERT(region(BANK2 + FIRST, NB, digest) == 0);
+    TEST_ASSERT(memcmp(digest, bank2, 32) == 0);
+    TEST_ASSERT(region(FIRST, NB, digest) == SECTORS(FIRST, NB));
+    TEST_ASSERT(memcmp(digest, bank1, 32) != 0);
+    check_sector(FIRST);
+    flash_sim_set_trace(NULL);
+}
+
+#endif
+
+int main(void)
+{
+    test_program();
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+    test_bank_erase();
+#endif
+    flash_sim_exit();
+    return test_done("digest");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("digest");
+}
+
+#endif
@@ -0,0 +1,484 @@
+/** @file test_fw.c
+ * \brief Firmware update resume under power cuts
+ *
+ * After power cuts at any point of an update, and of its resumed runs, the
+ * update resumes from its last checkpoint (or restarts), and completes with
+ * the expected image, the previous bank staying active until then.
+ *
+ * An image written again over the same one, from a manifest or by direct
+ * comparison, neither erases nor programs its unchanged sectors, the
+ * update being resumed in the middle of one of them.
+ *
+ * The additional digest of an update, resumed or not, is the SHA-256 of
+ * the image.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+#if CONFIG_USR_DRV_FLASH_FW
+
+#include "api/flash_fw.h"
+
+/* a 64KB and a 128KB image sector, the second one partially written */
+#define IMG_SIZE        (96 * 1024)
+#define IMG_VERSION     2
+#define CHUNK_SIZE      1024
+#define NB_RESUME_CUTS  3
+
+typedef struct {
+    bool resume;
+    uint32_t offset;    /* offset the update started or resumed at */
+} update_t;
+
+/* image content, the previous image in the bank being a different one */
+static void image(uint32_t gen, uint32_t off, uint8_t *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; ++i) {
+        buf[i] = (uint8_t)((off + i) * 31 + ((off + i) >> 8) + gen * 0x5b);
+    }
+}
+
+static uint32_t image_crc(void)
+{
+    uint8_t buf[CHUNK_SIZE];
+    uint32_t crc = 0;
+
+    for (uint32_t off = 0; off < IMG_SIZE; off += CHUNK_SIZE) {
+        image(IMG_VERSION, off, buf, CHUNK_SIZE);
+        crc = flash_crc32(crc, buf, CHUNK_SIZE);
+    }
+    return crc;
+}
+
+/* the inactive bank holds an older image, without valid header */
+static void setup(void)
+{
+    uint8_t buf[CHUNK_SIZE];
+    physaddr_t img = flash_fw_get_image(FLASH_FW_FLOP);
+
+    test_setup();
+    for (uint32_t off = 0; off < IMG_SIZE; off += CHUNK_SIZE) {
+        image(IMG_VERSION - 1, off, buf, CHUNK_SIZE);
+        flash_sim_poke(img + off, buf, CHUNK_SIZE);
+    }
+}
+
+static void update(void *ctx)
+{
+    update_t *u = ctx;
+    uint8_t buf[CHUNK_SIZE];
+    uint32_t off = 0;
+    t_flash_err err;
+
+    if (u->resume) {
+        err = flash_fw_resume(IMG_SIZE, IMG_VERSION, &off);
+        TEST_ASSERT(err == FLASH_ERR_NONE || err == FLASH_ERR_NOENT);
+        if (err == FLASH_ERR_NOENT) {
+            off = 0;
+            TEST_ASSERT(flash_fw_begin(IMG_SIZE, IMG_VERSION) == FLASH_ERR_NONE);
+        }
+    } else {
+        TEST_ASSERT(flash_fw_begin(IMG_SIZE, IMG_VERSION) == FLASH_ERR_NONE);
+    }
+    u->offset = off;
+    /* resumed at a chunk boundary, the image being streamed by chunks */
+    TEST_ASSERT(off % 4 == 0);
+    for (uint32_t len; off < IMG_SIZE; off += len) {
+        len = IMG_SIZE - off < CHUNK_SIZE - off % CHUNK_SIZE ?
+              IMG_SIZE - off : CHUNK_SIZE - off % CHUNK_SIZE;
+        image(IMG_VERSION, off, buf, len);
+        TEST_ASSERT(flash_fw_write(buf, len) == FLASH_ERR_NONE);
+    }
+    TEST_ASSERT(flash_fw_finish(image_crc()) == FLASH_ERR_NONE);
+}
+
+static bool is_updated(void)
+{
+    t_flash_fw_bank bank;
+    t_flash_fw_header hdr;
+
+    if (flash_fw_get_active(&bank, &hdr) != FLASH_ERR_NONE) {
+        return false;
+    }
+    TEST_ASSERT(bank == FLASH_FW_FLOP);
+    TEST_ASSERT(hdr.version == IMG_VERSION && hdr.size == IMG_SIZE);
+    return true;
+}
+
+static void check_image(void)
+{
+    uint8_t buf[CHUNK_SIZE];
+    physaddr_t img = flash_fw_get_image(FLASH_FW_FLOP);
+
+    TEST_ASSERT(is_updated());
+    for (uint32_t off = 0; off < IMG_SIZE; off += CHUNK_SIZE) {
+        image(IMG_VERSION, off, buf, CHUNK_SIZE);
+        TEST_ASSERT(memcmp((const void*)(img + off), buf, CHUNK_SIZE) == 0);
+    }
+}
+
+/*
+ * Resume the update after a power cut, itself interrupted by a few power
+ * cuts, until the update completes.
+ */
+static void check_resume(uint32_t seed, uint32_t min_offset)
+{
+    update_t u = { .resume = true };
+    uint32_t n = seed;
+
+    for (uint32_t i = 0; i < NB_RESUME_CUTS; ++i) {
+        test_reboot();
+        if (is_updated()) {
+            break;
+        }
+        /* cut at a pseudo random point of the resumed run */
+        n = n * 1103515245 + 12345;
+        if (!test_cut_run(1 + (n >> 8) % 8192, seed + i, update, &u)) {
+            break;
+        }
+        /* a resumed update doesn't go back past its checkpoints */
+        TEST_ASSERT(u.offset >= min_offset);
+    }
+    test_reboot();
+    if (!is_updated()) {
+        update(&u);
+        TEST_ASSERT(u.offset >= min_offset);
+    }
+    check_image();
+}
+
+/*
+ * flash operations count at the start of each chunk (the update start, then
+ * the end of the last chunk and of the update), chunks erasing
+ */
+#define NB_CHUNKS       (IMG_SIZE / CHUNK_SIZE)
+static uint32_t op_start[NB_CHUNKS + 2];
+static bool erasing[NB_CHUNKS];
+static uint32_t op_base;
+
+static inline uint32_t op_count(void)
+{
+    return (uint32_t)(flash_sim_program_count() + flash_sim_erase_count()) - op_base;
+}
+
+static void profile(void)
+{
+    uint8_t buf[CHUNK_SIZE];
+    uint64_t erases;
+
+    setup();
+    op_base = 0;
+    op_base = op_count();
+    TEST_ASSERT(flash_fw_begin(IMG_SIZE, IMG_VERSION) == FLASH_ERR_NONE);
+    for (uint32_t i = 0; i < NB_CHUNKS; ++i) {
+        op_start[i] = op_count();
+        erases = flash_sim_erase_count();
+        image(IMG_VERSION, i * CHUNK_SIZE, buf, CHUNK_SIZE);
+        TEST_ASSERT(flash_fw_write(buf, CHUNK_SIZE) == FLASH_ERR_NONE);
+        erasing[i] = flash_sim_erase_count() != erases;
+    }
+    op_start[NB_CHUNKS] = op_count();
+    TEST_ASSERT(flash_fw_finish(image_crc()) == FLASH_ERR_NONE);
+    op_start[NB_CHUNKS + 1] = op_count();
+    check_image();
+}
+
+/*
+ * Power cut at each operation of the update start and end, and around each
+ * image sector erase, and at spread operations of the streaming.
+ */
+static void test_update(void)
+{
+    update_t u = { .resume = false };
+    uint32_t min_offset = 0;
+    uint32_t n;
+    bool exhaustive;
+
+    profile();
+    for (n = 1; n <= op_start[NB_CHUNKS + 1]; ++n) {
+        exhaustive = n <= op_start[0] + 8 || n > op_start[NB_CHUNKS] - 8;
+        for (uint32_t i = 0; i < NB_CHUNKS && !exhaustive; ++i) {
+            exhaustive = erasing[i] && n > op_start[i] && n <= op_start[i] + 16;
+        }
+        if (!exhaustive && n % 997 != 0) {
+            continue;
+        }
+        /* past a sector start checkpoint, the resume point doesn't go back */
+        for (uint32_t i = 1; i < NB_CHUNKS; ++i) {
+            if (erasing[i] && n > op_start[i] + 16) {
+                min_offset = i * CHUNK_SIZE;
+            }
+        }
+        setup();
+        TEST_ASSERT(test_cut_run(n, n, update, &u));
+        check_resume(n, min_offset);
+    }
+}
+
+/*
+ * Sector-skip updates: an image of three sectors, a 64KB, a 128KB one and a
+ * part of a 128KB one, written over itself or over an image differing by a
+ * single sector
+ */
+#define SKIP_SIZE       (232 * 1024)
+#define SKIP_NB_SECTORS 3
+#define SKIP_CHANGED    1
+#define SKIP_ALL        ((1u << SKIP_NB_SECTORS) - 1)
+
+static const uint32_t skip_end[SKIP_NB_SECTORS] = {
+    64 * 1024, 192 * 1024, SKIP_SIZE,
+};
+
+/* image sectors erased and programmed by the update */
+static uint32_t erased;
+static uint32_t programmed;
+
+static uint32_t skip_sector(uint32_t off)
+{
+    uint32_t idx = 0;
+
+    while (off >= skip_end[idx]) {
+        idx++;
+    }
+    return idx;
+}
+
+static void skip_image(bool changed, uint32_t off, uint8_t *buf, uint32_t len)
+{
+    image(IMG_VERSION, off, buf, len);
+    for (uint32_t i = 0; i < len && changed; ++i) {
+        if (skip_sector(off + i) == SKIP_CHANGED && (off + i) % 4099 == 0) {
+            buf[i] ^= 0x5a;
+        }
+    }
+}
+
+static void skip_trace(const flash_sim_op_t *op)
+{
+    physaddr_t img = flash_fw_get_image(flash_fw_get_target());
+
+    if (op->type >= FLASH_SIM_OP_WRITE_8 && op->type <= FLASH_SIM_OP_WRITE_64 &&
+        op->addr >= img && op->addr < img + SKIP_SIZE) {
+        programmed |= 1u << skip_sector(op->addr - img);
+    }
+}
+
+/*
+ * Stream the image from offset, by chunks not crossing the image sectors.
+ * The image sectors are only erased by the chunks starting them.
+ */
+static void skip_write(bool changed, uint32_t off, uint32_t chunk)
+{
+    static uint8_t buf[128 * 1024];
+    uint64_t erases;
+    uint32_t len;
+
+    flash_sim_set_trace(skip_trace);
+    for (; off < SKIP_SIZE; off += len) {
+        len = skip_end[skip_sector(off)] - off;
+        len = len < chunk ? len : chunk;
+        skip_image(changed, off, buf, len);
+        erases = flash_sim_erase_count();
+        TEST_ASSERT(flash_fw_write(buf, len) == FLASH_ERR_NONE);
+        if (flash_sim_erase_count() != erases) {
+            erased |= 1u << skip_sector(off);
+        }
+    }
+    flash_sim_set_trace(NULL);
+}
+
+static void skip_set_manifest(bool changed)
+{
+    static uint32_t crcs[SKIP_NB_SECTORS];
+    static uint8_t buf[CHUNK_SIZE];
+
+    memset(crcs, 0, sizeof(crcs));
+    for (uint32_t off = 0; off < SKIP_SIZE; off += CHUNK_SIZE) {
+        skip_image(changed, off, buf, CHUNK_SIZE);
+        crcs[skip_sector(off)] = flash_crc32(crcs[skip_sector(off)], buf, CHUNK_SIZE);
+    }
+    TEST_ASSERT(flash_fw_set_manifest(crcs, SKIP_NB_SECTORS) == FLASH_ERR_NONE);
+}
+
+static uint32_t skip_crc(bool changed)
+{
+    uint8_t buf[CHUNK_SIZE];
+    uint32_t crc = 0;
+
+    for (uint32_t off = 0; off < SKIP_SIZE; off += CHUNK_SIZE) {
+        skip_image(changed, off, buf, CHUNK_SIZE);
+        crc = flash_crc32(crc, buf, CHUNK_SIZE);
+    }
+    return crc;
+}
+
+static void skip_check(bool changed, t_flash_fw_bank target)
+{
+    uint8_t buf[CHUNK_SIZE];
+    t_flash_fw_bank bank;
+    t_flash_fw_header hdr;
+
+    TEST_ASSERT(flash_fw_get_active(&bank, &hdr) == FLASH_ERR_NONE);
+    TEST_ASSERT(bank == target && hdr.size == SKIP_SIZE);
+    for (uint32_t off = 0; off < SKIP_SIZE; off += CHUNK_SIZE) {
+        skip_image(changed, off, buf, CHUNK_SIZE);
+        TEST_ASSERT(memcmp((const void*)(flash_fw_get_image(bank) + off), buf, CHUNK_SIZE) == 0);
+    }
+}
+
+/*
+ * Update with the manifest, or by chunks of the given size, returning the
+ * sectors erased or programmed. The skipped sectors are all the other ones.
+ */
+static uint32_t skip_update(bool changed, bool manifest, uint32_t chunk)
+{
+    t_flash_fw_bank target;
+    uint32_t touched;
+
+    TEST_ASSERT(flash_fw_begin(SKIP_SIZE, IMG_VERSION) == FLASH_ERR_NONE);
+    target = flash_fw_get_target();
+    if (manifest) {
+        skip_set_manifest(changed);
+    }
+    erased = 0;
+    programmed = 0;
+    skip_write(changed, 0, chunk);
+    TEST_ASSERT(flash_fw_finish(skip_crc(changed)) == FLASH_ERR_NONE);
+    skip_check(changed, target);
+    touched = erased | programmed;
+    TEST_ASSERT(flash_fw_get_skipped() ==
+                SKIP_NB_SECTORS - (uint32_t)__builtin_popcount(touched));
+    return touched;
+}
+
+static void test_skipped(void)
+{
+    test_setup();
+    /* the image into both (blank) banks */
+    TEST_ASSERT(skip_update(false, true, CHUNK_SIZE) == SKIP_ALL);
+    TEST_ASSERT(skip_update(false, false, SKIP_SIZE) == SKIP_ALL);
+    /* the same image again, into each bank */
+    TEST_ASSERT(skip_update(false, true, CHUNK_SIZE) == 0);
+    TEST_ASSERT(skip_update(false, false, SKIP_SIZE) == 0);
+    /* a sector changed */
+    TEST_ASSERT(skip_update(true, true, CHUNK_SIZE) == 1u << SKIP_CHANGED);
+    TEST_ASSERT(skip_update(true, false, SKIP_SIZE) == 1u << SKIP_CHANGED);
+    /* without manifest, chunks not covering the sectors aren't compared */
+    TEST_ASSERT(skip_update(true, false, CHUNK_SIZE) == SKIP_ALL);
+}
+
+/*
+ * Reset in the middle of a skipped sector: the update resumes in it, without
+ * erasing it, the next sectors being skipped again.
+ */
+static void test_skipped_resume(void)
+{
+    uint8_t buf[CHUNK_SIZE];
+    t_flash_fw_bank target;
+    uint32_t off;
+
+    test_setup();
+    TEST_ASSERT(skip_update(false, true, CHUNK_SIZE) == SKIP_ALL);
+    TEST_ASSERT(skip_update(false, true, CHUNK_SIZE) == SKIP_ALL);
+    TEST_ASSERT(flash_fw_begin(SKIP_SIZE, IMG_VERSION) == FLASH_ERR_NONE);
+    target = flash_fw_get_target();
+    skip_set_manifest(false);
+    erased = 0;
+    programmed = 0;
+    /* streamed up to the middle of the second sector */
+    for (off = 0; off < 104 * 1024; off += CHUNK_SIZE) {
+        skip_image(false, off, buf, CHUNK_SIZE);
+        TEST_ASSERT(flash_fw_write(buf, CHUNK_SIZE) == FLASH_ERR_NONE);
+    }
+    TEST_ASSERT(flash_fw_get_skipped() == 2);
+
+    test_reboot();
+    TEST_ASSERT(flash_fw_resume(SKIP_SIZE, IMG_VERSION, &off) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_fw_get_target() == target);
+    TEST_ASSERT(off > skip_end[0] && off <= 104 * 1024 && off % CHUNK_SIZE == 0);
+    skip_set_manifest(false);
+    skip_write(false, off, CHUNK_SIZE);
+    TEST_ASSERT(flash_fw_finish(skip_crc(false)) == FLASH_ERR_NONE);
+    skip_check(false, target);
+    /* the resumed sector is programmed again with the same data */
+    TEST_ASSERT(erased == 0);
+    TEST_ASSERT((programmed & ~(1u << 1)) == 0);
+    TEST_ASSERT(flash_fw_get_skipped() == 1);
+}
+
+/* SHA-256 of the image, computed from the streamed data */
+static void image_sha256(uint8_t *digest)
+{
+    uint8_t buf[CHUNK_SIZE];
+    t_flash_hash_ctx ctx;
+
+    flash_hash_init(&ctx, &flash_hash_sha256);
+    for (uint32_t off = 0; off < IMG_SIZE; off += CHUNK_SIZE) {
+        image(IMG_VERSION, off, buf, CHUNK_SIZE);
+        flash_hash_update(&ctx, buf, CHUNK_SIZE);
+    }
+    flash_hash_final(&ctx, digest);
+}
+
+static void write_image(uint32_t from, uint32_t to)
+{
+    uint8_t buf[CHUNK_SIZE];
+
+    for (uint32_t off = from; off < to; off += CHUNK_SIZE) {
+        image(IMG_VERSION, off, buf, CHUNK_SIZE);
+        TEST_ASSERT(flash_fw_write(buf, CHUNK_SIZE) == FLASH_ERR_NONE);
+    }
+}
+
+static void test_digest(void)
+{
+    uint8_t ref[FLASH_HASH_MAX_DIGEST];
+    uint8_t digest[FLASH_HASH_MAX_DIGEST];
+    uint32_t off;
+
+    image_sha256(ref);
+    setup();
+    TEST_ASSERT(flash_fw_begin(IMG_SIZE, IMG_VERSION) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_fw_set_hash(&flash_hash_sha256) == FLASH_ERR_NONE);
+    write_image(0, IMG_SIZE);
+    TEST_ASSERT(flash_fw_get_digest(digest) == 0);
+    TEST_ASSERT(flash_fw_finish(image_crc()) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_fw_get_digest(digest) == 32);
+    TEST_ASSERT(memcmp(digest, ref, 32) == 0);
+    check_image();
+
+    /* resumed: the programmed part is hashed from the flash */
+    setup();
+    TEST_ASSERT(flash_fw_begin(IMG_SIZE, IMG_VERSION) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_fw_set_hash(&flash_hash_sha256) == FLASH_ERR_NONE);
+    write_image(0, 72 * 1024);
+    test_reboot();
+    TEST_ASSERT(flash_fw_resume(IMG_SIZE, IMG_VERSION, &off) == FLASH_ERR_NONE);
+    TEST_ASSERT(off > 0 && off % CHUNK_SIZE == 0);
+    TEST_ASSERT(flash_fw_set_hash(&flash_hash_sha256) == FLASH_ERR_NONE);
+    write_image(off, IMG_SIZE);
+    TEST_ASSERT(flash_fw_finish(image_crc()) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_fw_get_digest(digest) == 32);
+    TEST_ASSERT(memcmp(digest, ref, 32) == 0);
+    check_image();
+}
+
+int main(void)
+{
+    test_update();
+    test_digest();
+    test_skipped();
+    test_skipped_resume();
+    flash_sim_exit();
+    return test_done("fw");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("fw");
+}
+
+#endif
@@ -0,0 +1,89 @@
+/** @file test_geometry.c
+ * \brief Runtime flash geometry detection
+ *
+ * flash_init() selects the geometry from the flash size register and the
+ * DB1M option bit. A layout the registered devices don't map (bank 2 of a
+ * 1MB dual bank device under a 2MB build) is refused.
+ */
+
+#include "flash_test.h"
+#include "flash_regs.h"
+
+#if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+
+/* reboot on another device: flash_init() result */
+static int boot_device(uint32_t size, bool db1m)
+{
+    flash_sim_set_device(size, db1m);
+    flash_sim_reset();
+    return flash_init();
+}
+
+/* the 2MB device of the build configuration */
+static void check_2m(void)
+{
+    TEST_ASSERT(flash_geometry.size == 0x200000);
+    TEST_ASSERT(flash_geometry.bank2 == 0x100000);
+    TEST_ASSERT(flash_geometry.sectors == 0xffffff);
+    TEST_ASSERT(flash_sector_addr(12) == FLASH_SIM_BASE + 0x100000);
+    TEST_ASSERT(flash_select_sector(FLASH_SIM_BASE + 0x1fffff) == 23);
+}
+
+static void test_single_1m(void)
+{
+    test_setup();
+    check_2m();
+    /* DB1M is meaningless on a 2MB device */
+    TEST_ASSERT(boot_device(0x200000, true) == 0);
+    check_2m();
+
+    TEST_ASSERT(boot_device(0x100000, false) == 0);
+    TEST_ASSERT(flash_geometry.size == 0x100000);
+    TEST_ASSERT(flash_geometry.bank2 == 0);
+    TEST_ASSERT(flash_geometry.sectors == 0xfff);
+    TEST_ASSERT(flash_sector_addr(8) == FLASH_SIM_BASE + 0x80000);
+    TEST_ASSERT(flash_sector_addr(11) == FLASH_SIM_BASE + 0xe0000);
+    TEST_ASSERT(flash_sector_size(11) == 0x20000);
+    TEST_ASSERT(flash_select_sector(FLASH_SIM_BASE + 0x80000) == 8);
+    TEST_ASSERT(flash_select_sector(FLASH_SIM_BASE + 0xfffff) == 11);
+    TEST_ASSERT(!IS_IN_FLASH(FLASH_SIM_BASE + 0x100000));
+    /* no bank 2 */
+    TEST_ASSERT(flash_bank_erase(1) != FLASH_ERR_NONE);
+    TEST_ASSERT(flash_sector_erase(flash_sector_addr(11)) != 0xff);
+
+    TEST_ASSERT(boot_device(0x80000, false) == 0);
+    TEST_ASSERT(flash_geometry.size == 0x80000);
+    TEST_ASSERT(flash_geometry.sectors == 0xff);
+}
+
+static void test_dual_1m(void)
+{
+    test_setup();
+    /* bank 2 at 0x08080000, the bank 2 device being at 0x08100000 */
+    TEST_ASSERT(boot_device(0x100000, true) == -1);
+    /* the geometry is left unchanged */
+    check_2m();
+    /* unsupported sizes */
+    TEST_ASSERT(boot_device(0x180000, false) == -1);
+    TEST_ASSERT(boot_device(0, false) == -1);
+    check_2m();
+    TEST_ASSERT(boot_device(0x200000, false) == 0);
+    check_2m();
+}
+
+int main(void)
+{
+    test_single_1m();
+    test_dual_1m();
+    flash_sim_exit();
+    return test_done("geometry");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("geometry");
+}
+
+#endif
@@ -0,0 +1,131 @@
+/** @file test_hash.c
+ * \brief Digest primitives known answers
+ *
+ * CRC-32 and SHA-256 of the usual test vectors, computed at once, by
+ * chunks of any size, and from the flash content, give the known digests.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+#include "api/flash_hash.h"
+
+#define MILLION         1000000
+
+typedef struct {
+    const char *msg;    /* NULL: one million 'a' */
+    uint32_t crc32;
+    uint8_t sha256[32];
+} vector_t;
+
+static const vector_t vectors[] = {
+    { "", 0x00000000, {
+        0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14,
+        0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+        0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c,
+        0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55 } },
+    { "abc", 0x352441c2, {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+        0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+        0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad } },
+    /* 448 bits: the length doesn't fit in the last block */
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 0x171a3f5f, {
+        0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8,
+        0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+        0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+        0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1 } },
+    { NULL, 0xdc25bfbc, {
+        0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92,
+        0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+        0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e,
+        0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0 } },
+};
+
+static uint8_t million[MILLION];
+
+/* sizes of the hashed chunks, cycled through */
+static const uint32_t chunks[] = { 1, 63, 64, 65, 7, 1000, 55, 4096 };
+
+/* CRC-32 digests are little endian */
+static inline uint32_t le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static void digest(const t_flash_hash_alg *alg, const uint8_t *msg, uint32_t len,
+                   uint32_t first_chunk, uint8_t *out)
+{
+    t_flash_hash_ctx ctx;
+    uint32_t chunk;
+
+    flash_hash_init(&ctx, alg);
+    for (uint32_t off = 0, i = first_chunk; off < len; off += chunk, ++i) {
+        chunk = chunks[i % (sizeof(chunks) / sizeof(chunks[0]))];
+        chunk = len - off < chunk ? len - off : chunk;
+        flash_hash_update(&ctx, msg + off, chunk);
+    }
+    flash_hash_final(&ctx, out);
+}
+
+static void test_vectors(void)
+{
+    uint8_t out[FLASH_HASH_MAX_DIGEST];
+    t_flash_hash_ctx ctx;
+    const uint8_t *msg;
+    uint32_t len;
+
+    memset(million, 'a', sizeof(million));
+    TEST_ASSERT(flash_crc32(0, (const uint8_t*)"123456789", 9) == 0xcbf43926);
+    TEST_ASSERT(flash_hash_crc32.digest_size == 4);
+    TEST_ASSERT(flash_hash_sha256.digest_size == 32);
+    for (uint32_t v = 0; v < sizeof(vectors) / sizeof(vectors[0]); ++v) {
+        msg = vectors[v].msg ? (const uint8_t*)vectors[v].msg : million;
+        len = vectors[v].msg ? (uint32_t)strlen(vectors[v].msg) : MILLION;
+        TEST_ASSERT(flash_crc32(0, msg, len) == vectors[v].crc32);
+        /* at once, then by chunks from each size */
+        flash_hash_init(&ctx, &flash_hash_sha256);
+        flash_hash_update(&ctx, msg, len);
+        flash_hash_final(&ctx, out);
+        TEST_ASSERT(memcmp(out, vectors[v].sha256, 32) == 0);
+        for (uint32_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c) {
+            digest(&flash_hash_sha256, msg, len, c, out);
+            TEST_ASSERT(memcmp(out, vectors[v].sha256, 32) == 0);
+            digest(&flash_hash_crc32, msg, len, c, out);
+            TEST_ASSERT(le32(out) == vectors[v].crc32);
+        }
+    }
+}
+
+/* the same digests computed from the flash content */
+static void test_region(void)
+{
+    const uint32_t size = 128 * 1024;
+    physaddr_t addr = FLASH_SECTOR_5;
+    uint8_t out[FLASH_HASH_MAX_DIGEST];
+    uint8_t ref[FLASH_HASH_MAX_DIGEST];
+    t_flash_hash_ctx ctx;
+
+    test_setup();
+    for (uint32_t i = 0; i < size; ++i) {
+        million[i] = (uint8_t)(i * 31 + (i >> 9));
+    }
+    flash_sim_poke(addr, million, size);
+    flash_hash_init(&ctx, &flash_hash_sha256);
+    TEST_ASSERT(flash_hash_region(&ctx, addr, size) == FLASH_ERR_NONE);
+    flash_hash_final(&ctx, out);
+    digest(&flash_hash_sha256, million, size, 0, ref);
+    TEST_ASSERT(memcmp(out, ref, 32) == 0);
+    flash_hash_init(&ctx, &flash_hash_crc32);
+    TEST_ASSERT(flash_hash_region(&ctx, addr + 3, size - 5) == FLASH_ERR_NONE);
+    flash_hash_final(&ctx, out);
+    TEST_ASSERT(le32(out) == flash_crc32(0, million + 3, size - 5));
+}
+
+int main(void)
+{
+    test_vectors();
+    test_region();
+    flash_sim_exit();
+    return test_done("hash");
+}
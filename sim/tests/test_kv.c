@@ -0,0 +1,243 @@
+/** @file test_kv.c
+ * \brief Key/value store under power cuts
+ *
+ * After a power cut at any point of an update, of a collection, or of the
+ * recovery itself, each key holds its value before or after the interrupted
+ * update, and the store still accepts updates.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+#if CONFIG_USR_DRV_FLASH_KV
+
+#include "api/flash_kv.h"
+
+static const uint8_t sectors[] = { 1, 2, 3 };
+
+#define NB_KEYS         8
+/* keys only set by the first updates, moved by each collection */
+#define NB_COLD         4
+/* enough updates for two collections */
+#define NB_UPDATES      2000
+#define NB_CHECK        50
+
+typedef struct {
+    uint32_t nb_ops;
+    uint32_t done;      /* updates completed */
+} workload_t;
+
+/* update i sets or deletes a key, to a value depending on i */
+static inline uint16_t update_key(uint32_t i)
+{
+    if (i < NB_COLD) {
+        return (uint16_t)i;
+    }
+    return (uint16_t)(NB_COLD + (i * 5) % (NB_KEYS - NB_COLD));
+}
+
+static inline bool update_is_delete(uint32_t i)
+{
+    return i >= NB_COLD && i % 11 == 10;
+}
+
+static uint16_t value(uint32_t i, uint8_t *buf)
+{
+    uint16_t len = 1 + (i * 13) % 60;
+
+    for (uint16_t j = 0; j < len; ++j) {
+        buf[j] = (uint8_t)(i * 7 + j);
+    }
+    return len;
+}
+
+/* last update of each key after the first nb updates, -1 if not set */
+static void model(uint32_t nb, int32_t *last)
+{
+    for (uint16_t key = 0; key < NB_KEYS; ++key) {
+        last[key] = -1;
+    }
+    for (uint32_t i = 0; i < nb; ++i) {
+        last[update_key(i)] = update_is_delete(i) ? -1 : (int32_t)i;
+    }
+}
+
+static void update(uint32_t i)
+{
+    uint8_t buf[FLASH_KV_MAX_VALUE];
+    uint16_t len;
+    t_flash_err err;
+
+    if (update_is_delete(i)) {
+        err = flash_kv_delete(update_key(i));
+        TEST_ASSERT(err == FLASH_ERR_NONE || err == FLASH_ERR_NOENT);
+    } else {
+        len = value(i, buf);
+        TEST_ASSERT(flash_kv_set(update_key(i), buf, len) == FLASH_ERR_NONE);
+    }
+}
+
+static void run(void *ctx)
+{
+    workload_t *w = ctx;
+
+    while (w->done < w->nb_ops) {
+        update(w->done);
+        w->done++;
+    }
+}
+
+static bool key_is(uint16_t key, int32_t last)
+{
+    uint8_t buf[FLASH_KV_MAX_VALUE];
+    uint8_t expected[FLASH_KV_MAX_VALUE];
+    uint16_t len = sizeof(buf);
+    t_flash_err err;
+
+    err = flash_kv_get(key, buf, &len);
+    if (last < 0) {
+        return err == FLASH_ERR_NOENT;
+    }
+    return err == FLASH_ERR_NONE && len == value((uint32_t)last, expected) &&
+           memcmp(buf, expected, len) == 0;
+}
+
+static void init(void *ctx)
+{
+    (void)ctx;
+    flash_kv_init(sectors, sizeof(sectors));
+}
+
+/* the store recovers the state before or after the interrupted update */
+static void check_recovery(uint32_t done, uint32_t seed)
+{
+    int32_t before[NB_KEYS];
+    int32_t after[NB_KEYS];
+    workload_t w = { .nb_ops = done + NB_CHECK, .done = done + 1 };
+
+    for (uint32_t m = 1; ; ++m) {
+        test_reboot();
+        if (!test_cut_run(m, seed + m, init, NULL)) {
+            break;
+        }
+    }
+    test_reboot();
+    TEST_ASSERT(flash_kv_init(sectors, sizeof(sectors)) == FLASH_ERR_NONE);
+    model(done, before);
+    model(done + 1, after);
+    for (uint16_t key = 0; key < NB_KEYS; ++key) {
+        TEST_ASSERT(key_is(key, before[key]) || key_is(key, after[key]));
+    }
+    /* the interrupted update is done again, then the next ones */
+    update(done);
+    run(&w);
+    model(w.nb_ops, after);
+    for (uint16_t key = 0; key < NB_KEYS; ++key) {
+        TEST_ASSERT(key_is(key, after[key]));
+    }
+}
+
+/* flash operations count at the start of each update, updates erasing */
+static uint32_t op_start[NB_UPDATES + 1];
+static bool collecting[NB_UPDATES];
+
+static inline uint32_t op_count(void)
+{
+    return (uint32_t)(flash_sim_program_count() + flash_sim_erase_count());
+}
+
+static void profile(void)
+{
+    uint64_t erases;
+
+    test_setup();
+    TEST_ASSERT(flash_kv_init(sectors, sizeof(sectors)) == FLASH_ERR_NONE);
+    erases = flash_sim_erase_count();
+    for (uint32_t i = 0; i < NB_UPDATES; ++i) {
+        op_start[i] = op_count();
+        update(i);
+        collecting[i] = flash_sim_erase_count() != erases;
+        erases = flash_sim_erase_count();
+    }
+    op_start[NB_UPDATES] = op_count();
+}
+
+/*
+ * Power cut at each operation of the first updates, of the collections and
+ * of the updates following them, of one update in a hundred, and at spread
+ * operations of the others.
+ */
+static void test_updates(void)
+{
+    workload_t w;
+    uint32_t n;
+    uint32_t base;
+    bool exhaustive;
+    uint32_t nb_collections = 0;
+
+    profile();
+    base = op_start[0];
+    for (uint32_t i = 0; i < NB_UPDATES; ++i) {
+        nb_collections += collecting[i];
+        exhaustive = i < 2 || collecting[i] || collecting[i - 1] || i % 100 == 0;
+        for (n = op_start[i] - base + 1; n <= op_start[i + 1] - base; ++n) {
+            if (!exhaustive && n % 97 != 0) {
+                continue;
+            }
+            test_setup();
+            TEST_ASSERT(flash_kv_init(sectors, sizeof(sectors)) == FLASH_ERR_NONE);
+            w.nb_ops = NB_UPDATES;
+            w.done = 0;
+            TEST_ASSERT(test_cut_run(n, n, run, &w));
+            TEST_ASSERT(w.done == i);
+            check_recovery(w.done, n);
+        }
+    }
+    TEST_ASSERT(nb_collections >= 2);
+}
+
+/* a full store refuses new values, but still deletes and collects */
+static void test_full(void)
+{
+    uint8_t buf[FLASH_KV_MAX_VALUE];
+    uint16_t key;
+    t_flash_err err;
+
+    memset(buf, 0x5a, sizeof(buf));
+    test_setup();
+    TEST_ASSERT(flash_kv_init(sectors, sizeof(sectors)) == FLASH_ERR_NONE);
+    for (key = 0; key < CONFIG_USR_DRV_FLASH_KV_MAX_KEYS; ++key) {
+        err = flash_kv_set(key, buf, sizeof(buf));
+        if (err != FLASH_ERR_NONE) {
+            break;
+        }
+    }
+    TEST_ASSERT(err == FLASH_ERR_NOSPACE);
+    TEST_ASSERT(key > 1);
+    TEST_ASSERT(flash_kv_delete(key - 1) == FLASH_ERR_NONE);
+    /* each update of the remaining keys fits, across many collections */
+    for (uint32_t i = 0; i < 500; ++i) {
+        buf[0] = (uint8_t)i;
+        TEST_ASSERT(flash_kv_set(i % (key - 1), buf, sizeof(buf)) == FLASH_ERR_NONE);
+    }
+    test_reboot();
+    TEST_ASSERT(flash_kv_init(sectors, sizeof(sectors)) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_kv_set(0, buf, sizeof(buf)) == FLASH_ERR_NONE);
+}
+
+int main(void)
+{
+    test_updates();
+    test_full();
+    flash_sim_exit();
+    return test_done("kv");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("kv");
+}
+
+#endif
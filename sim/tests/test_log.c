@@ -0,0 +1,214 @@
+/** @file test_log.c
+ * \brief Circular log under power cuts
+ *
+ * After a power cut at any point of an append, of a sector switch, or of
+ * the recovery itself, the write head is recovered: the log holds the
+ * completed records, the interrupted one possibly, and no corrupted record.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+#if CONFIG_USR_DRV_FLASH_LOG
+
+#include "api/flash_log.h"
+
+#define FIRST_SECTOR    1
+#define NB_SECTORS      3
+#define SLOT_SIZE       64
+/* enough appends for the ring to wrap */
+#define NB_APPENDS      1000
+#define NB_CHECK        50
+
+typedef struct {
+    uint32_t nb_ops;
+    uint32_t done;      /* appends completed */
+} workload_t;
+
+/* record i: its index, then a pattern, of a length depending on i */
+static uint16_t record(uint32_t i, uint8_t *buf)
+{
+    uint16_t len = 4 + (i * 13) % (SLOT_SIZE - 8);
+
+    memcpy(buf, &i, 4);
+    for (uint16_t j = 4; j < len; ++j) {
+        buf[j] = (uint8_t)(i * 7 + j);
+    }
+    return len;
+}
+
+static void append(uint32_t i)
+{
+    uint8_t buf[SLOT_SIZE];
+    uint16_t len = record(i, buf);
+
+    TEST_ASSERT(flash_log_append(buf, len) == FLASH_ERR_NONE);
+}
+
+static void run(void *ctx)
+{
+    workload_t *w = ctx;
+
+    while (w->done < w->nb_ops) {
+        append(w->done);
+        w->done++;
+    }
+}
+
+typedef struct {
+    uint32_t nb;        /* records found */
+    uint32_t first;     /* index of the first one */
+    uint32_t last_pos;
+    bool valid;
+} scan_t;
+
+/* records are found in order, without gap, and uncorrupted */
+static bool scan_cb(uint32_t pos, const uint8_t *rec, uint16_t len, void *ctx)
+{
+    scan_t *scan = ctx;
+    uint8_t buf[SLOT_SIZE];
+    uint32_t i;
+
+    if (len < 4) {
+        scan->valid = false;
+        return false;
+    }
+    memcpy(&i, rec, 4);
+    if (scan->nb == 0) {
+        scan->first = i;
+    } else if (i != scan->first + scan->nb || pos <= scan->last_pos) {
+        scan->valid = false;
+        return false;
+    }
+    if (i >= NB_APPENDS + NB_CHECK || record(i, buf) != len ||
+        memcmp(buf, rec, len) != 0) {
+        scan->valid = false;
+        return false;
+    }
+    scan->last_pos = pos;
+    scan->nb++;
+    return true;
+}
+
+static void scan(scan_t *s)
+{
+    memset(s, 0, sizeof(*s));
+    s->valid = true;
+    TEST_ASSERT(flash_log_iterate(flash_log_first(), flash_log_end(), scan_cb, s) ==
+                FLASH_ERR_NONE);
+    TEST_ASSERT(s->valid);
+}
+
+static void init(void *ctx)
+{
+    (void)ctx;
+    flash_log_init(FIRST_SECTOR, NB_SECTORS, SLOT_SIZE);
+}
+
+static void check_recovery(uint32_t done, uint32_t seed)
+{
+    /* records kept when the oldest sector is erased */
+    uint32_t kept = (NB_SECTORS - 1) * (flash_sector_size(FIRST_SECTOR) / SLOT_SIZE - 1);
+    workload_t w;
+    scan_t s;
+
+    for (uint32_t m = 1; ; ++m) {
+        test_reboot();
+        if (!test_cut_run(m, seed + m, init, NULL)) {
+            break;
+        }
+    }
+    test_reboot();
+    TEST_ASSERT(flash_log_init(FIRST_SECTOR, NB_SECTORS, SLOT_SIZE) == FLASH_ERR_NONE);
+    scan(&s);
+    /* the completed records, and possibly the interrupted one */
+    TEST_ASSERT(s.first + s.nb == done || s.first + s.nb == done + 1);
+    TEST_ASSERT(s.nb >= (done < kept ? done : kept));
+    /* the log still appends */
+    w.done = s.first + s.nb;
+    w.nb_ops = w.done + NB_CHECK;
+    run(&w);
+    scan(&s);
+    TEST_ASSERT(s.first + s.nb == w.nb_ops);
+}
+
+/* flash operations count at the start of each append, sector switches */
+static uint32_t op_start[NB_APPENDS + 1];
+static bool switching[NB_APPENDS];
+static uint32_t nb_erases;
+
+static inline uint32_t op_count(void)
+{
+    return (uint32_t)(flash_sim_program_count() + flash_sim_erase_count());
+}
+
+static void profile(void)
+{
+    uint64_t erases;
+
+    test_setup();
+    TEST_ASSERT(flash_log_init(FIRST_SECTOR, NB_SECTORS, SLOT_SIZE) == FLASH_ERR_NONE);
+    erases = flash_sim_erase_count();
+    for (uint32_t i = 0; i < NB_APPENDS; ++i) {
+        op_start[i] = op_count();
+        /* the head sector is full */
+        switching[i] = flash_log_end() % (flash_sector_size(FIRST_SECTOR) / SLOT_SIZE) == 0;
+        append(i);
+        nb_erases += flash_sim_erase_count() != erases;
+        erases = flash_sim_erase_count();
+    }
+    op_start[NB_APPENDS] = op_count();
+    /* the ring wrapped */
+    TEST_ASSERT(nb_erases >= 1);
+}
+
+/*
+ * Power cut at each operation of the first appends, of the sector switches
+ * and of the appends following them, of one append in a hundred, and
+ * at spread operations of the others.
+ */
+static void test_appends(void)
+{
+    workload_t w;
+    uint32_t base;
+    uint32_t nb_seeds;
+    bool exhaustive;
+
+    profile();
+    base = op_start[0];
+    for (uint32_t i = 0; i < NB_APPENDS; ++i) {
+        exhaustive = i < 2 || switching[i] || switching[i - 1] || i % 100 == 0;
+        for (uint32_t n = op_start[i] - base + 1; n <= op_start[i + 1] - base; ++n) {
+            if (!exhaustive && n % 37 != 0) {
+                continue;
+            }
+            /* the erase of the oldest sector, at various progress */
+            nb_seeds = switching[i] && n == op_start[i] - base + 1 ? 32 : 1;
+            for (uint32_t seed = n; seed < n + nb_seeds; ++seed) {
+                test_setup();
+                TEST_ASSERT(flash_log_init(FIRST_SECTOR, NB_SECTORS, SLOT_SIZE) == FLASH_ERR_NONE);
+                w.nb_ops = NB_APPENDS;
+                w.done = 0;
+                TEST_ASSERT(test_cut_run(n, seed, run, &w));
+                TEST_ASSERT(w.done == i);
+                check_recovery(w.done, seed);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    test_appends();
+    flash_sim_exit();
+    return test_done("log");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("log");
+}
+
+#endif
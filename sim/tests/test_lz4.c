@@ -0,0 +1,136 @@
+/** @file test_lz4.c
+ * \brief LZ4 compressed firmware update
+ *
+ * Frames written by the lz4 tool (lz4_frames.h, see gen_lz4_frames.py),
+ * received in chunks of any size, are decompressed into the expected image,
+ * matches being read back from the programmed image. Truncated or altered
+ * frames are refused.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+#if CONFIG_USR_DRV_FLASH_LZ4
+
+#include "api/flash_fw.h"
+#include "api/flash_lz4.h"
+#include "lz4_frames.h"
+
+/* image of gen_lz4_frames.py */
+#define IMG_SIZE        (72 * 1024)
+#define RANDOM_SIZE     1024
+#define IMG_VERSION     2
+
+static const uint32_t distances[] = { 1024, 4099, 65000 };
+
+static uint8_t img[IMG_SIZE];
+
+static void image(void)
+{
+    uint32_t state = 0x12345678;
+    uint32_t dist;
+
+    for (uint32_t i = 0; i < IMG_SIZE; ++i) {
+        if (i < RANDOM_SIZE) {
+            state = state * 1103515245 + 12345;
+            img[i] = (uint8_t)(state >> 24);
+        } else if (i % 997 == 0) {
+            img[i] = (uint8_t)i;
+        } else {
+            dist = distances[(i / 4096) % (sizeof(distances) / sizeof(distances[0]))];
+            img[i] = img[i - (dist <= i ? dist : RANDOM_SIZE)];
+        }
+    }
+}
+
+typedef struct {
+    const uint8_t *data;
+    uint32_t size;
+} frame_t;
+
+static const frame_t frames[] = {
+    { lz4_frame_default, sizeof(lz4_frame_default) },
+    { lz4_frame_linked, sizeof(lz4_frame_linked) },
+    { lz4_frame_block_crc, sizeof(lz4_frame_block_crc) },
+};
+
+/* sizes of the received chunks, cycled through */
+static const uint32_t chunks[] = { 1, 3, 17, 256, 1000 };
+
+/* decompress the frame into the inactive bank, received by chunks */
+static t_flash_err update(const uint8_t *frame, uint32_t size, uint32_t first_chunk)
+{
+    t_flash_err err;
+    uint32_t len;
+
+    TEST_ASSERT(flash_fw_begin(IMG_SIZE, IMG_VERSION) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_lz4_begin() == FLASH_ERR_NONE);
+    for (uint32_t off = 0, i = first_chunk; off < size; off += len, ++i) {
+        len = chunks[i % (sizeof(chunks) / sizeof(chunks[0]))];
+        len = size - off < len ? size - off : len;
+        if ((err = flash_lz4_write(frame + off, len)) != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    return flash_lz4_finish();
+}
+
+static void check_image(void)
+{
+    t_flash_fw_bank bank;
+    t_flash_fw_header hdr;
+
+    TEST_ASSERT(flash_fw_get_active(&bank, &hdr) == FLASH_ERR_NONE);
+    TEST_ASSERT(bank == FLASH_FW_FLOP);
+    TEST_ASSERT(hdr.version == IMG_VERSION && hdr.size == IMG_SIZE);
+    TEST_ASSERT(memcmp((const void*)flash_fw_get_image(FLASH_FW_FLOP), img, IMG_SIZE) == 0);
+}
+
+/* each frame, by chunks of each size first */
+static void test_frames(void)
+{
+    for (uint32_t f = 0; f < sizeof(frames) / sizeof(frames[0]); ++f) {
+        for (uint32_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c) {
+            test_setup();
+            TEST_ASSERT(update(frames[f].data, frames[f].size, c) == FLASH_ERR_NONE);
+            TEST_ASSERT(flash_fw_finish(flash_crc32(0, img, IMG_SIZE)) == FLASH_ERR_NONE);
+            check_image();
+        }
+    }
+}
+
+/* a truncated frame, or a frame with an altered header, is refused */
+static void test_errors(void)
+{
+    uint8_t frame[sizeof(lz4_frame_default)];
+
+    test_setup();
+    TEST_ASSERT(update(lz4_frame_default, sizeof(lz4_frame_default) - 5, 0) ==
+                FLASH_ERR_INVAL);
+    memcpy(frame, lz4_frame_default, sizeof(frame));
+    frame[0] ^= 1;
+    TEST_ASSERT(update(frame, sizeof(frame), 0) == FLASH_ERR_INVAL);
+    /* no more data is accepted once an error is found */
+    TEST_ASSERT(flash_lz4_write(frame, 1) == FLASH_ERR_INVAL);
+    memcpy(frame, lz4_frame_default, sizeof(frame));
+    frame[4] ^= 0x40;
+    TEST_ASSERT(update(frame, sizeof(frame), 0) == FLASH_ERR_INVAL);
+}
+
+int main(void)
+{
+    image();
+    test_frames();
+    test_errors();
+    flash_sim_exit();
+    return test_done("lz4");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("lz4");
+}
+
+#endif
@@ -0,0 +1,177 @@
+/** @file test_merkle.c
+ * \brief Merkle tree index under resets and power cuts
+ *
+ * After a reset or a power cut at any point of the region modifications,
+ * or of a tree update, the tree loaded at startup matches the region: its
+ * root is the one of a tree built from scratch.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+#if CONFIG_USR_DRV_FLASH_MERKLE
+
+#include "api/flash_merkle.h"
+
+/* the first blocks of a 64KB sector */
+static const t_flash_merkle_conf conf = {
+    .base = 0x08010000,
+    .nb_blocks = 8,
+    .meta = { 2, 3 },
+};
+
+#define WRITE_SIZE      64
+#define NB_WRITES       6
+/* the tree is updated after every UPDATE_WRITES modifications */
+#define UPDATE_WRITES   3
+
+typedef struct {
+    uint32_t done;      /* modifications completed */
+} workload_t;
+
+/* modification i programs a pattern into a block */
+static void modify(uint32_t i)
+{
+    uint8_t buf[WRITE_SIZE];
+    physaddr_t addr = conf.base + ((i * 5) % conf.nb_blocks) * FLASH_MERKLE_BLOCK_SIZE +
+                      i * WRITE_SIZE;
+
+    for (uint32_t j = 0; j < WRITE_SIZE; ++j) {
+        buf[j] = (uint8_t)(i * 0x3b + j);
+    }
+    TEST_ASSERT(flash_write(addr, buf, sizeof(buf)) == FLASH_ERR_NONE);
+}
+
+static void run(void *ctx)
+{
+    workload_t *w = ctx;
+
+    while (w->done < NB_WRITES) {
+        modify(w->done);
+        w->done++;
+        if (w->done % UPDATE_WRITES == 0) {
+            TEST_ASSERT(flash_merkle_update() == FLASH_ERR_NONE);
+        }
+    }
+}
+
+static void setup(void)
+{
+    test_setup();
+    TEST_ASSERT(flash_merkle_init(&conf) == FLASH_ERR_NONE);
+}
+
+static void init(void *ctx)
+{
+    (void)ctx;
+    flash_merkle_init(&conf);
+}
+
+/* the loaded tree is the one built from the region, and checks its blocks */
+static void check_tree(void)
+{
+    uint8_t root[FLASH_MERKLE_NODE_SIZE];
+    uint8_t built[FLASH_MERKLE_NODE_SIZE];
+
+    TEST_ASSERT(flash_merkle_init(&conf) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_merkle_root(root) == FLASH_ERR_NONE);
+    for (uint32_t block = 0; block < conf.nb_blocks; ++block) {
+        TEST_ASSERT(flash_merkle_verify(block, root) == FLASH_ERR_NONE);
+    }
+    TEST_ASSERT(flash_merkle_build() == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_merkle_root(built) == FLASH_ERR_NONE);
+    TEST_ASSERT(memcmp(root, built, sizeof(root)) == 0);
+}
+
+/* reset after modifications, before the tree update */
+static void test_reset(void)
+{
+    uint8_t root[FLASH_MERKLE_NODE_SIZE];
+
+    setup();
+    TEST_ASSERT(flash_merkle_root(root) == FLASH_ERR_NONE);
+    modify(0);
+    test_reboot();
+    check_tree();
+    /* without modification, the tree is loaded as is */
+    test_reboot();
+    TEST_ASSERT(flash_merkle_init(&conf) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_merkle_root(root) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_merkle_verify(0, root) == FLASH_ERR_NONE);
+}
+
+/* flash operations count at the start of each modification, and at the end */
+static uint32_t op_start[NB_WRITES + 1];
+
+static inline uint32_t op_count(void)
+{
+    return (uint32_t)(flash_sim_program_count() + flash_sim_erase_count());
+}
+
+static void profile(void)
+{
+    setup();
+    for (uint32_t i = 0; i < NB_WRITES; ++i) {
+        op_start[i] = op_count();
+        modify(i);
+        if ((i + 1) % UPDATE_WRITES == 0) {
+            TEST_ASSERT(flash_merkle_update() == FLASH_ERR_NONE);
+        }
+    }
+    op_start[NB_WRITES] = op_count();
+}
+
+/*
+ * Power cut at each operation of the modifications, of the updates start
+ * and end, and at spread operations of the updates. The startup is then cut
+ * at its first operations, and at spread ones, until it completes.
+ */
+static void test_cuts(void)
+{
+    workload_t w;
+    uint32_t base;
+    uint32_t end;
+    bool exhaustive;
+
+    profile();
+    base = op_start[0];
+    for (uint32_t i = 0; i < NB_WRITES; ++i) {
+        /* the modification, then the update, if any */
+        end = op_start[i + 1] - base;
+        for (uint32_t n = op_start[i] - base + 1; n <= end; ++n) {
+            exhaustive = n <= op_start[i] - base + 24 || n > end - 8;
+            if (!exhaustive && n % 29 != 0) {
+                continue;
+            }
+            setup();
+            w.done = 0;
+            TEST_ASSERT(test_cut_run(n, n, run, &w));
+            TEST_ASSERT(w.done == i || (w.done == i + 1 && w.done % UPDATE_WRITES == 0));
+            for (uint32_t m = 1; ; m += m < 8 ? 1 : 31) {
+                test_reboot();
+                if (!test_cut_run(m, n + m, init, NULL)) {
+                    break;
+                }
+            }
+            test_reboot();
+            check_tree();
+        }
+    }
+}
+
+int main(void)
+{
+    test_reset();
+    test_cuts();
+    flash_sim_exit();
+    return test_done("merkle");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("merkle");
+}
+
+#endif
@@ -0,0 +1,155 @@
+/** @file test_otp.c
+ * \brief One time programmable area
+ *
+ * OTP writes are refused without any flash operation when the block is
+ * locked, or when a programmed bit would have to be set back. Bytes already
+ * holding their value are not programmed again. The RAM copy of the OTP
+ * area read by the driver always matches the OTP area, including after an
+ * interrupted programming.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+#include "flash_backend.h"
+
+#define BLOCK           2
+#define LOCKED_BLOCK    5
+#define OFFSET          4
+
+static const uint8_t data[8] = { 0x00, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde };
+
+/* OTP area read by the driver, and read from the simulated flash */
+static void check_coherent(void)
+{
+    uint8_t cached[FLASH_OTP_BLOCK_SIZE];
+    uint8_t otp[FLASH_OTP_SIZE];
+
+    flash_be_mem_read(otp, FLASH_SECTOR_OTP_AREA, sizeof(otp));
+    for (uint8_t block = 0; block < FLASH_OTP_BLOCKS; ++block) {
+        TEST_ASSERT(flash_otp_read(block, 0, cached, sizeof(cached)) == FLASH_ERR_NONE);
+        TEST_ASSERT(memcmp(cached, &otp[block * FLASH_OTP_BLOCK_SIZE], sizeof(cached)) == 0);
+        TEST_ASSERT(flash_otp_is_locked(block) == (otp[FLASH_OTP_LOCK_OFFSET + block] == 0));
+    }
+}
+
+static inline uint64_t op_count(void)
+{
+    return flash_sim_program_count() + flash_sim_erase_count();
+}
+
+/* the OTP area is loaded at its first use: blocks programmed beforehand */
+static void setup(void)
+{
+    uint8_t zero = 0;
+
+    test_setup();
+    flash_sim_poke(FLASH_SECTOR_OTP_AREA + BLOCK * FLASH_OTP_BLOCK_SIZE, data, 2);
+    flash_sim_poke(FLASH_SECTOR_OTP_AREA + LOCKED_BLOCK * FLASH_OTP_BLOCK_SIZE, data, 4);
+    flash_sim_poke(FLASH_SECTOR_OTP_AREA + FLASH_OTP_LOCK_OFFSET + LOCKED_BLOCK, &zero, 1);
+}
+
+static void test_write(void)
+{
+    uint8_t buf[sizeof(data)];
+    uint64_t ops;
+
+    TEST_ASSERT(!flash_otp_is_locked(BLOCK));
+    TEST_ASSERT(flash_otp_is_locked(LOCKED_BLOCK));
+    ops = op_count();
+    TEST_ASSERT(flash_otp_write(BLOCK, OFFSET, data, sizeof(data)) == FLASH_ERR_NONE);
+    /* data[0] is 0x00 */
+    TEST_ASSERT(op_count() == ops + sizeof(data));
+    TEST_ASSERT(flash_otp_read(BLOCK, OFFSET, buf, sizeof(buf)) == FLASH_ERR_NONE);
+    TEST_ASSERT(memcmp(buf, data, sizeof(data)) == 0);
+    check_coherent();
+
+    /* unchanged bytes are not programmed again */
+    ops = op_count();
+    TEST_ASSERT(flash_otp_write(BLOCK, OFFSET, data, sizeof(data)) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_otp_write(BLOCK, 0, data, 2) == FLASH_ERR_NONE);
+    TEST_ASSERT(op_count() == ops);
+    memcpy(buf, data, sizeof(buf));
+    buf[3] &= 0x0f;
+    buf[6] = 0x00;
+    TEST_ASSERT(flash_otp_write(BLOCK, OFFSET, buf, sizeof(buf)) == FLASH_ERR_NONE);
+    TEST_ASSERT(op_count() == ops + 2);
+    check_coherent();
+}
+
+/* a bit set back (0 -> 1) in the last byte: none of the bytes is programmed */
+static void test_invalid(void)
+{
+    uint8_t buf[sizeof(data)];
+    uint64_t ops = op_count();
+
+    memset(buf, 0x00, sizeof(buf));
+    buf[sizeof(buf) - 1] = 0xff;
+    TEST_ASSERT(flash_otp_write(BLOCK, OFFSET, buf, sizeof(buf)) == FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_get_last_error() == FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_otp_read(BLOCK, OFFSET, buf, sizeof(buf)) == FLASH_ERR_NONE);
+    TEST_ASSERT(memcmp(buf, data, 3) == 0 && buf[7] == data[7]);
+    /* out of the block */
+    TEST_ASSERT(flash_otp_write(BLOCK, FLASH_OTP_BLOCK_SIZE - 1, buf, 2) == FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_otp_write(FLASH_OTP_BLOCKS, 0, buf, 1) == FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_otp_write(BLOCK, 0, NULL, 1) == FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_otp_read(BLOCK, FLASH_OTP_BLOCK_SIZE + 1, buf, 0) == FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_otp_lock(FLASH_OTP_BLOCKS) == FLASH_ERR_INVAL);
+    TEST_ASSERT(op_count() == ops);
+    check_coherent();
+}
+
+static void test_lock(void)
+{
+    uint8_t zero = 0;
+    uint64_t ops = op_count();
+
+    /* locked before the first use */
+    TEST_ASSERT(flash_otp_write(LOCKED_BLOCK, 8, &zero, 1) == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_get_last_error() == FLASH_ERR_WRP);
+    TEST_ASSERT(op_count() == ops);
+
+    TEST_ASSERT(flash_otp_lock(BLOCK) == FLASH_ERR_NONE);
+    TEST_ASSERT(op_count() == ops + 1);
+    TEST_ASSERT(flash_otp_is_locked(BLOCK));
+    TEST_ASSERT(!flash_otp_is_locked(BLOCK + 1));
+    /* locked again, or written, without any flash operation */
+    TEST_ASSERT(flash_otp_lock(BLOCK) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_otp_write(BLOCK, 0, &zero, 1) == FLASH_ERR_WRP);
+    TEST_ASSERT(op_count() == ops + 1);
+    check_coherent();
+    /* the lock is in the OTP area */
+    test_reboot();
+    TEST_ASSERT(flash_otp_is_locked(BLOCK));
+    check_coherent();
+}
+
+static void write_block(void *ctx)
+{
+    (void)ctx;
+    flash_otp_write(BLOCK + 1, 0, data, sizeof(data));
+}
+
+/* a byte partially programmed by a power cut is read from the flash again */
+static void test_cut(void)
+{
+    uint8_t buf[sizeof(data)];
+
+    for (uint32_t n = 2; n <= 4; ++n) {
+        TEST_ASSERT(test_cut_run(n, n, write_block, NULL));
+        test_reboot();
+        check_coherent();
+    }
+    TEST_ASSERT(flash_otp_read(BLOCK + 1, 0, buf, sizeof(buf)) == FLASH_ERR_NONE);
+    TEST_ASSERT(memcmp(buf, data, 2) == 0);
+}
+
+int main(void)
+{
+    setup();
+    test_write();
+    test_invalid();
+    test_lock();
+    test_cut();
+    flash_sim_exit();
+    return test_done("otp");
+}
@@ -0,0 +1,271 @@
+/** @file test_patch.c
+ * \brief Delta patch update
+ *
+ * A patch of COPY, ADD and INSERT operations, received in chunks of any
+ * size, splitting the header, the operation arguments and data, gives the
+ * expected image in the inactive bank, which becomes the active one. A patch
+ * of another base image, or a malformed or truncated patch, is refused, the
+ * base image staying active.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+#if CONFIG_USR_DRV_FLASH_PATCH
+
+#include "api/flash_fw.h"
+#include "api/flash_patch.h"
+
+#define BASE_SIZE       (40 * 1024)
+#define BASE_VERSION    1
+#define NEW_VERSION     2
+#define PATCH_HDR_SIZE  20
+#define MAX_SIZE        (64 * 1024)
+
+static uint8_t base[BASE_SIZE];
+static uint32_t base_crc;
+
+/* patch being built, and the image it gives */
+static uint8_t patch[MAX_SIZE];
+static uint32_t patch_len;
+static uint8_t img[MAX_SIZE];
+static uint32_t img_len;
+
+static void put_word(uint32_t pos, uint32_t word)
+{
+    for (uint32_t i = 0; i < 4; ++i) {
+        patch[pos + i] = (uint8_t)(word >> (8 * i));
+    }
+}
+
+static void put_op(uint8_t op, uint32_t arg0, uint32_t arg1)
+{
+    patch[patch_len++] = op;
+    put_word(patch_len, arg0);
+    patch_len += 4;
+    if (op != FLASH_PATCH_INSERT) {
+        put_word(patch_len, arg1);
+        patch_len += 4;
+    }
+}
+
+static void op_copy(uint32_t off, uint32_t len)
+{
+    put_op(FLASH_PATCH_COPY, off, len);
+    memcpy(&img[img_len], &base[off], len);
+    img_len += len;
+}
+
+static void op_add(uint32_t off, uint32_t len)
+{
+    uint8_t delta;
+
+    put_op(FLASH_PATCH_ADD, off, len);
+    for (uint32_t i = 0; i < len; ++i) {
+        delta = (uint8_t)(i * 7 + 1);
+        patch[patch_len++] = delta;
+        img[img_len++] = (uint8_t)(base[off + i] + delta);
+    }
+}
+
+static void op_insert(uint32_t len)
+{
+    put_op(FLASH_PATCH_INSERT, len, 0);
+    for (uint32_t i = 0; i < len; ++i) {
+        patch[patch_len++] = (uint8_t)((i * 13) ^ 0xa5);
+        img[img_len++] = (uint8_t)((i * 13) ^ 0xa5);
+    }
+}
+
+/* the patch header, once the operations are known */
+static void put_header(uint32_t size, uint32_t crc, uint32_t base_crc32)
+{
+    put_word(0, FLASH_PATCH_MAGIC);
+    put_word(4, size);
+    put_word(8, NEW_VERSION);
+    put_word(12, crc);
+    put_word(16, base_crc32);
+}
+
+/* each operation, some of them larger than the patch output buffer */
+static void build_patch(void)
+{
+    patch_len = PATCH_HDR_SIZE;
+    img_len = 0;
+    op_copy(0, 5000);
+    op_add(5000, 3000);
+    op_insert(2000);
+    op_copy(30000, 10000);
+    op_insert(0);
+    op_copy(1000, 300);
+    op_add(BASE_SIZE - 1000, 1000);
+    op_add(17, 0);
+    op_insert(300);
+    put_header(img_len, flash_crc32(0, img, img_len), base_crc);
+}
+
+/* the base image, installed by a full update into the flop bank */
+static void setup(void)
+{
+    t_flash_fw_bank bank;
+
+    test_setup();
+    TEST_ASSERT(flash_fw_begin(BASE_SIZE, BASE_VERSION) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_fw_write(base, BASE_SIZE) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_fw_finish(base_crc) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_fw_get_active(&bank, NULL) == FLASH_ERR_NONE);
+    TEST_ASSERT(bank == FLASH_FW_FLOP);
+}
+
+/* sizes of the received chunks, cycled through */
+static const uint32_t byte_chunks[] = { 1 };
+static const uint32_t odd_chunks[] = { 3, 7, 13, 2, 301, 5, 1000, 11 };
+
+static t_flash_err apply(uint32_t len, const uint32_t *chunks, uint32_t nb_chunks)
+{
+    t_flash_err err;
+    uint32_t chunk;
+
+    TEST_ASSERT(flash_patch_begin() == FLASH_ERR_NONE);
+    for (uint32_t off = 0, i = 0; off < len; off += chunk, ++i) {
+        chunk = chunks[i % nb_chunks];
+        chunk = len - off < chunk ? len - off : chunk;
+        if ((err = flash_patch_write(&patch[off], chunk)) != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    return FLASH_ERR_NONE;
+}
+
+static void check_active(t_flash_fw_bank expected)
+{
+    t_flash_fw_bank bank;
+    t_flash_fw_header hdr;
+
+    TEST_ASSERT(flash_fw_get_active(&bank, &hdr) == FLASH_ERR_NONE);
+    TEST_ASSERT(bank == expected);
+    if (expected == FLASH_FW_FLOP) {
+        TEST_ASSERT(hdr.version == BASE_VERSION && hdr.size == BASE_SIZE);
+        TEST_ASSERT(hdr.crc32 == base_crc);
+        TEST_ASSERT(memcmp((const void*)flash_fw_get_image(bank), base, BASE_SIZE) == 0);
+    } else {
+        TEST_ASSERT(hdr.version == NEW_VERSION && hdr.size == img_len);
+        TEST_ASSERT(hdr.crc32 == flash_crc32(0, img, img_len));
+        TEST_ASSERT(memcmp((const void*)flash_fw_get_image(bank), img, img_len) == 0);
+    }
+}
+
+/* the patch byte by byte, then by odd sized chunks from each start */
+static void test_apply(void)
+{
+    build_patch();
+    setup();
+    TEST_ASSERT(apply(patch_len, byte_chunks, 1) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_patch_finish() == FLASH_ERR_NONE);
+    check_active(FLASH_FW_FLIP);
+    for (uint32_t c = 0; c < sizeof(odd_chunks) / sizeof(odd_chunks[0]); ++c) {
+        setup();
+        TEST_ASSERT(apply(patch_len, &odd_chunks[c],
+                          sizeof(odd_chunks) / sizeof(odd_chunks[0]) - c) == FLASH_ERR_NONE);
+        TEST_ASSERT(flash_patch_finish() == FLASH_ERR_NONE);
+        check_active(FLASH_FW_FLIP);
+    }
+}
+
+/* a patch of another base image */
+static void test_base_mismatch(void)
+{
+    build_patch();
+    put_word(16, base_crc ^ 1);
+    setup();
+    TEST_ASSERT(apply(patch_len, odd_chunks, 1) == FLASH_ERR_VERIFY);
+    /* no more data is accepted once an error is found */
+    TEST_ASSERT(flash_patch_write(patch, 1) == FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_patch_finish() == FLASH_ERR_INVAL);
+    check_active(FLASH_FW_FLOP);
+}
+
+/* a header and a single operation */
+static void build_op(uint8_t op, uint32_t arg0, uint32_t arg1, uint32_t size)
+{
+    patch_len = PATCH_HDR_SIZE;
+    put_op(op, arg0, arg1);
+    put_header(size, 0, base_crc);
+}
+
+static void check_invalid(void)
+{
+    setup();
+    TEST_ASSERT(apply(patch_len, byte_chunks, 1) == FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_patch_finish() == FLASH_ERR_INVAL);
+    check_active(FLASH_FW_FLOP);
+}
+
+static void test_malformed(void)
+{
+    /* unknown operations */
+    build_op(0x00, 0, 16, 16);
+    check_invalid();
+    build_op(FLASH_PATCH_INSERT + 1, 0, 16, 16);
+    check_invalid();
+    /* COPY and ADD out of the base image */
+    build_op(FLASH_PATCH_COPY, BASE_SIZE - 10, 11, 16);
+    check_invalid();
+    build_op(FLASH_PATCH_COPY, BASE_SIZE + 1, 0, 16);
+    check_invalid();
+    build_op(FLASH_PATCH_COPY, 16, 0xfffffff8, 16);
+    check_invalid();
+    build_op(FLASH_PATCH_ADD, BASE_SIZE, 1, 16);
+    check_invalid();
+    /* an operation past the new image size */
+    build_op(FLASH_PATCH_INSERT, 17, 0, 16);
+    check_invalid();
+    build_op(FLASH_PATCH_COPY, 0, 17, 16);
+    check_invalid();
+}
+
+/*
+ * A patch truncated in its header, an operation arguments or data, or
+ * after a complete operation, is only refused by flash_patch_finish().
+ */
+static void test_truncated(void)
+{
+    static const uint32_t cut[] = {
+        1, PATCH_HDR_SIZE, PATCH_HDR_SIZE + 1, PATCH_HDR_SIZE + 5,
+        /* the first COPY complete, half of the ADD data */
+        PATCH_HDR_SIZE + 9, PATCH_HDR_SIZE + 9 + 9 + 1500,
+    };
+
+    build_patch();
+    for (uint32_t i = 0; i <= sizeof(cut) / sizeof(cut[0]); ++i) {
+        setup();
+        TEST_ASSERT(apply(i < sizeof(cut) / sizeof(cut[0]) ? cut[i] : patch_len - 1,
+                          odd_chunks, sizeof(odd_chunks) / sizeof(odd_chunks[0])) ==
+                    FLASH_ERR_NONE);
+        TEST_ASSERT(flash_patch_finish() == FLASH_ERR_INVAL);
+        check_active(FLASH_FW_FLOP);
+    }
+}
+
+int main(void)
+{
+    for (uint32_t i = 0; i < BASE_SIZE; ++i) {
+        base[i] = (uint8_t)(i * 31 + (i >> 8) + (i >> 13) * 0x5b);
+    }
+    base_crc = flash_crc32(0, base, BASE_SIZE);
+    test_apply();
+    test_base_mismatch();
+    test_malformed();
+    test_truncated();
+    flash_sim_exit();
+    return test_done("patch");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("patch");
+}
+
+#endif
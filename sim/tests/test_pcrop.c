@@ -0,0 +1,107 @@
+/** @file test_pcrop.c
+ * \brief PCROP (SPRMOD) read protection
+ *
+ * Data reads of a PCROP protected sector are refused with FLASH_ERR_PCROP,
+ * the buffer being zeroed, and the sector can't be copied: its content
+ * never leaves the flash through the driver.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+#if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)
+
+#include "api/flash_hash.h"
+
+/* a 128KB protected sector, between two readable ones */
+#define PCROP_SECTOR    6
+#define SECTOR_SIZE     (128 * 1024)
+
+static uint8_t buf[SECTOR_SIZE];
+
+static void fill(uint8_t sector)
+{
+    for (uint32_t i = 0; i < SECTOR_SIZE; ++i) {
+        buf[i] = (uint8_t)(i * 13 + sector) | 0x01;
+    }
+    flash_sim_poke(flash_sector_addr(sector), buf, SECTOR_SIZE);
+}
+
+static inline uint64_t op_count(void)
+{
+    return flash_sim_program_count() + flash_sim_erase_count();
+}
+
+static void test_pcrop(void)
+{
+    physaddr_t addr = flash_sector_addr(PCROP_SECTOR);
+    uint8_t next[64];
+    t_flash_opt opt;
+    t_flash_hash_ctx ctx;
+    uint64_t ops;
+
+    test_setup();
+    fill(PCROP_SECTOR - 1);
+    fill(PCROP_SECTOR);
+    fill(PCROP_SECTOR + 1);
+    flash_unlock_opt();
+    TEST_ASSERT(flash_pcrop_set_range(addr + 100, 1) == FLASH_ERR_NONE);
+    test_reboot();
+    TEST_ASSERT(flash_pcrop_query() == 1u << PCROP_SECTOR);
+    TEST_ASSERT(flash_wrp_query() == 1u << PCROP_SECTOR);
+
+    /* reads of the sector, or across its boundaries, are zeroed */
+    memset(buf, 0x5a, sizeof(buf));
+    TEST_ASSERT(flash_read(buf, addr + 4, 64) == FLASH_ERR_PCROP);
+    for (uint32_t i = 0; i < 64; ++i) {
+        TEST_ASSERT(buf[i] == 0);
+    }
+    memset(buf, 0x5a, sizeof(buf));
+    TEST_ASSERT(flash_read(buf, addr - 32, 64) == FLASH_ERR_PCROP);
+    TEST_ASSERT(flash_read(buf + 64, addr + SECTOR_SIZE - 32, 64) == FLASH_ERR_PCROP);
+    for (uint32_t i = 0; i < 128; ++i) {
+        TEST_ASSERT(buf[i] == 0);
+    }
+    TEST_ASSERT(buf[128] == 0x5a);
+    /* the neighbour sectors are readable */
+    TEST_ASSERT(flash_read(buf, addr - 64, 64) == FLASH_ERR_NONE);
+    TEST_ASSERT(memcmp(buf, (const void*)(addr - 64), 64) == 0);
+    TEST_ASSERT(flash_read(next, addr + SECTOR_SIZE, 64) == FLASH_ERR_NONE);
+    TEST_ASSERT(next[0] == (uint8_t)((PCROP_SECTOR + 1) | 0x01));
+    /* nor hashed */
+    flash_hash_init(&ctx, &flash_hash_sha256);
+    TEST_ASSERT(flash_hash_region(&ctx, addr, SECTOR_SIZE) == FLASH_ERR_PCROP);
+
+    /* copied out of the sector: refused before erasing the destination */
+    ops = op_count();
+    memcpy(buf, (const void*)flash_sector_addr(PCROP_SECTOR + 1), SECTOR_SIZE);
+    TEST_ASSERT(flash_copy_sector(flash_sector_addr(PCROP_SECTOR + 1), addr) ==
+                FLASH_ERR_PCROP);
+    TEST_ASSERT(op_count() == ops);
+    TEST_ASSERT(memcmp(buf, (const void*)flash_sector_addr(PCROP_SECTOR + 1), SECTOR_SIZE) == 0);
+    /* into it: write protected */
+    TEST_ASSERT(flash_copy_sector(addr, flash_sector_addr(PCROP_SECTOR + 1)) == FLASH_ERR_WRP);
+    TEST_ASSERT(op_count() == ops);
+
+    /* PCROP sectors can't be unprotected by nWRP */
+    flash_unlock_opt();
+    TEST_ASSERT(flash_opt_read(&opt) == FLASH_ERR_NONE);
+    TEST_ASSERT(opt.sprmod);
+    TEST_ASSERT(flash_wrp_stage_range(&opt, addr, 1, false) == FLASH_ERR_INVAL);
+}
+
+int main(void)
+{
+    test_pcrop();
+    flash_sim_exit();
+    return test_done("pcrop");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("pcrop");
+}
+
+#endif
@@ -0,0 +1,127 @@
+/** @file test_power_cut.c
+ * \brief Power loss injection of the simulator, seen through the driver
+ */
+
+#include "flash_test.h"
+#include "flash_regs.h"
+
+#define TEST_ADDR       FLASH_SECTOR_1
+/* flash_program_word() erases the sector when given its start address */
+#define TEST_WORD_ADDR  ((uint32_t*)(FLASH_SECTOR_1 + 0x100))
+#define TEST_WORD       0x12345678
+
+static void erase_sector(void *ctx)
+{
+    (void)ctx;
+    flash_sector_erase(TEST_ADDR);
+}
+
+static void commit_opt(void *ctx)
+{
+    flash_opt_commit((t_flash_opt*)ctx);
+}
+
+static bool is_blank(physaddr_t addr, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i) {
+        if (((volatile uint8_t*)addr)[i] != 0xff) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* an interrupted program only clears bits cleared in the programmed value */
+static void test_program(void)
+{
+    uint32_t word;
+
+    for (uint32_t seed = 1; seed <= 32; ++seed) {
+        test_setup();
+        flash_sim_set_cut_handler(NULL);
+        flash_sim_set_seed(seed);
+        flash_sim_cut_after_ops(1);
+        TEST_ASSERT(flash_program_word(TEST_WORD_ADDR, TEST_WORD) != FLASH_ERR_NONE);
+        TEST_ASSERT(!flash_sim_is_powered());
+        test_reboot();
+        TEST_ASSERT(flash_sim_is_powered());
+        word = *(volatile uint32_t*)TEST_WORD_ADDR;
+        TEST_ASSERT((~word & TEST_WORD) == 0);
+        /* programming again completes the word */
+        TEST_ASSERT(flash_program_word(TEST_WORD_ADDR, TEST_WORD) == FLASH_ERR_NONE);
+        TEST_ASSERT(*(volatile uint32_t*)TEST_WORD_ADDR == TEST_WORD);
+    }
+}
+
+/* an interrupted erase leaves the sector partially erased */
+static void test_erase(void)
+{
+    uint32_t size = flash_sector_size(flash_select_sector(TEST_ADDR));
+    uint32_t zero = 0;
+
+    test_setup();
+    for (uint32_t off = 0; off < size; off += 4) {
+        flash_sim_poke(TEST_ADDR + off, &zero, sizeof(zero));
+    }
+    TEST_ASSERT(test_cut_run(1, 1, erase_sector, NULL));
+    test_reboot();
+    TEST_ASSERT(!is_blank(TEST_ADDR, size));
+    TEST_ASSERT(flash_sector_erase(TEST_ADDR) != 0xff);
+    TEST_ASSERT(is_blank(TEST_ADDR, size));
+}
+
+/* without cut handler, the driver fails immediately */
+static void test_no_handler(void)
+{
+    test_setup();
+    flash_sim_set_cut_handler(NULL);
+    flash_sim_cut_after_ops(1);
+    TEST_ASSERT(flash_sector_erase(TEST_ADDR) == 0xff);
+    TEST_ASSERT(flash_get_last_error() != FLASH_ERR_NONE);
+    TEST_ASSERT(flash_program_word(TEST_WORD_ADDR, TEST_WORD) != FLASH_ERR_NONE);
+    test_reboot();
+    TEST_ASSERT(flash_sector_erase(TEST_ADDR) != 0xff);
+    TEST_ASSERT(flash_program_word(TEST_WORD_ADDR, TEST_WORD) == FLASH_ERR_NONE);
+}
+
+/* a cut at a given time interrupts the running erase */
+static void test_cut_at(void)
+{
+    test_setup();
+    flash_sim_cut_at(flash_sim_clock_us() + 1000);
+    flash_sim_set_cut_handler(NULL);
+    TEST_ASSERT(flash_sector_erase(TEST_ADDR) == 0xff);
+    TEST_ASSERT(!flash_sim_is_powered());
+    test_reboot();
+}
+
+/* an interrupted option bytes programming is not applied */
+static void test_opt(void)
+{
+    t_flash_opt opt, check;
+
+    test_setup();
+    flash_unlock_opt();
+    TEST_ASSERT(flash_opt_read(&opt) == FLASH_ERR_NONE);
+    opt.nwrp &= ~(1u << flash_select_sector(TEST_ADDR));
+    TEST_ASSERT(test_cut_run(1, 1, commit_opt, &opt));
+    test_reboot();
+    TEST_ASSERT(flash_opt_read(&check) == FLASH_ERR_NONE);
+    TEST_ASSERT(check.nwrp & (1u << flash_select_sector(TEST_ADDR)));
+    flash_unlock_opt();
+    TEST_ASSERT(!test_cut_run(2, 2, commit_opt, &opt));
+    test_reboot();
+    TEST_ASSERT(flash_opt_read(&check) == FLASH_ERR_NONE);
+    TEST_ASSERT(!(check.nwrp & (1u << flash_select_sector(TEST_ADDR))));
+}
+
+int main(void)
+{
+    test_program();
+    test_erase();
+    test_no_handler();
+    test_cut_at();
+    test_opt();
+    flash_sim_exit();
+    return test_done("power_cut");
+}
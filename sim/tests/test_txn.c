@@ -0,0 +1,203 @@
+/** @file test_txn.c
+ * \brief Transactional region update under power cuts
+ *
+ * After a power cut at any point of a transaction, and of the journal
+ * sector switch, the region holds either the old or the new content.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+#if CONFIG_USR_DRV_FLASH_TXN
+
+#include "api/flash_txn.h"
+
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+static const t_flash_txn_region region = {
+    .journal = { 3, 15 },
+    .nb_sectors = 2,
+    .sectors = { 1, 2 },
+    .shadows = { 13, 14 },
+};
+#else
+static const t_flash_txn_region region = {
+    .journal = { 0, 3 },
+    .nb_sectors = 1,
+    .sectors = { 1 },
+    .shadows = { 2 },
+};
+#endif
+
+/* journal layout of flash_txn.c */
+#define TXN_MAGIC       0x54584A31
+#define TXN_BEGIN       0x54584E31
+#define TXN_HDR_SIZE    16
+#define TXN_REC_SIZE    16
+
+/* each generation of the region content is a pattern at the sector starts */
+#define PATTERN_SIZE    64
+#define NB_GEN          4
+
+static void pattern(uint8_t gen, uint8_t idx, uint8_t *buf)
+{
+    for (uint32_t i = 0; i < PATTERN_SIZE; ++i) {
+        buf[i] = (uint8_t)(gen * 0x35 + idx * 0x11 + i);
+    }
+}
+
+static void poke_gen(const uint8_t *sectors, uint8_t gen)
+{
+    uint8_t buf[PATTERN_SIZE];
+
+    for (uint8_t i = 0; i < region.nb_sectors; ++i) {
+        pattern(gen, i, buf);
+        flash_sim_poke(flash_sector_addr(sectors[i]), buf, sizeof(buf));
+    }
+}
+
+/* generation held by the region, -1 if mixed or unknown */
+static int region_gen(void)
+{
+    uint8_t buf[PATTERN_SIZE];
+    int gen = -1;
+    physaddr_t addr;
+
+    for (uint8_t i = 0; i < region.nb_sectors; ++i) {
+        addr = flash_sector_addr(region.sectors[i]);
+        for (uint32_t off = PATTERN_SIZE; off < flash_sector_size(region.sectors[i]); ++off) {
+            if (((volatile uint8_t*)addr)[off] != 0xff) {
+                return -1;
+            }
+        }
+        for (uint8_t g = 0; g < NB_GEN; ++g) {
+            pattern(g, i, buf);
+            if (memcmp((const void*)addr, buf, sizeof(buf)) == 0) {
+                if (i != 0 && g != gen) {
+                    return -1;
+                }
+                gen = g;
+            }
+        }
+        if (gen < 0) {
+            return -1;
+        }
+    }
+    return gen;
+}
+
+static void update(void *ctx)
+{
+    uint8_t gen = *(uint8_t*)ctx;
+    uint8_t buf[PATTERN_SIZE];
+
+    TEST_ASSERT(flash_txn_begin() == FLASH_ERR_NONE);
+    for (uint8_t i = 0; i < region.nb_sectors; ++i) {
+        pattern(gen, i, buf);
+        TEST_ASSERT(flash_txn_write(flash_sector_addr(region.sectors[i]), buf,
+                                    sizeof(buf)) == FLASH_ERR_NONE);
+    }
+    TEST_ASSERT(flash_txn_commit() == FLASH_ERR_NONE);
+}
+
+/* the store recovers, and still completes transactions */
+static void check_recovery(uint8_t old_gen, uint8_t new_gen)
+{
+    uint8_t gen = NB_GEN - 1;
+    int cur;
+
+    test_reboot();
+    TEST_ASSERT(flash_txn_init(&region) == FLASH_ERR_NONE);
+    cur = region_gen();
+    TEST_ASSERT(cur == old_gen || cur == new_gen);
+    update(&gen);
+    TEST_ASSERT(region_gen() == gen);
+}
+
+static void init(void *ctx)
+{
+    (void)ctx;
+    flash_txn_init(&region);
+}
+
+/*
+ * Power cut at each operation of a transaction, then at each operation of
+ * its recovery, until the recovery completes.
+ */
+static void test_commit(void)
+{
+    uint8_t gen;
+    bool cut = true;
+
+    for (uint32_t n = 1; cut; ++n) {
+        test_setup();
+        poke_gen(region.sectors, 0);
+        TEST_ASSERT(flash_txn_init(&region) == FLASH_ERR_NONE);
+        gen = 1;
+        update(&gen);
+        gen = 2;
+        cut = test_cut_run(n, n, update, &gen);
+        for (uint32_t m = 1; cut; ++m) {
+            test_reboot();
+            if (!test_cut_run(m, n + m, init, NULL)) {
+                break;
+            }
+        }
+        check_recovery(1, 2);
+    }
+}
+
+static void poke_journal(uint8_t idx, uint32_t seq, uint32_t done)
+{
+    uint32_t hdr[4] = { TXN_MAGIC, seq, ~seq, 0xffffffff };
+    uint32_t mask = (1u << region.nb_sectors) - 1;
+    uint32_t rec[4] = { TXN_BEGIN, mask | ((~mask & 0xffff) << 16), 0, done };
+    physaddr_t addr = flash_sector_addr(region.journal[idx]);
+    uint32_t size = flash_sector_size(region.journal[idx]);
+
+    flash_sim_poke(addr, hdr, sizeof(hdr));
+    for (uint32_t off = TXN_HDR_SIZE; off + TXN_REC_SIZE <= size; off += TXN_REC_SIZE) {
+        flash_sim_poke(addr + off, rec, sizeof(rec));
+    }
+}
+
+/*
+ * Power cut while switching to the other journal sector, whose records
+ * are all committed: partially erased, they must not be replayed, the
+ * shadow sectors holding an older content.
+ */
+static void test_journal_switch(void)
+{
+    uint8_t gen = 2;
+    bool cut = true;
+
+    for (uint32_t n = 1; cut; ++n) {
+        for (uint32_t seed = 1; seed <= (n == 1 ? 32 : 1); ++seed) {
+            test_setup();
+            poke_gen(region.sectors, 1);
+            poke_gen(region.shadows, 3);
+            poke_journal(0, 7, 0);
+            poke_journal(1, 8, 0);
+            TEST_ASSERT(flash_txn_init(&region) == FLASH_ERR_NONE);
+            TEST_ASSERT(region_gen() == 1);
+            cut = test_cut_run(n, seed, update, &gen);
+            check_recovery(1, 2);
+        }
+    }
+}
+
+int main(void)
+{
+    test_commit();
+    test_journal_switch();
+    flash_sim_exit();
+    return test_done("txn");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("txn");
+}
+
+#endif
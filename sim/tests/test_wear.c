@@ -0,0 +1,184 @@
+/** @file test_wear.c
+ * \brief Erase counters compaction under power cuts
+ *
+ * After a power cut at any point of a sector erase, and of the counters
+ * compaction it triggers, no counter is lost: each one holds its value
+ * before or after the interrupted erase.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "flash_test.h"
+
+#if CONFIG_USR_DRV_FLASH_WEAR
+
+#include "api/flash_wear.h"
+
+/* counters layout of flash_wear.c */
+#define WEAR_MAGIC      0x57454132
+#define WEAR_HDR_SIZE   16
+#define WEAR_TAG(s)     (0x57450000 | ((uint32_t)(uint8_t)~(s) << 8) | (s))
+
+#define ERASED_SECTOR   1
+#define OTHER_SECTOR    5
+#define OTHER_COUNT     1000
+#define ERASED_COUNT    7
+/* free records left in the current counters sector */
+#define NB_FREE         3
+#define NB_ERASES       8
+
+typedef struct {
+    uint32_t done;      /* erases completed */
+} workload_t;
+
+/*
+ * The first counters sector is current and nearly full, holding old
+ * records of OTHER_SECTOR, then the counter of ERASED_SECTOR. The second
+ * one holds the previous copy of the counters.
+ */
+static void setup(void)
+{
+    physaddr_t base = flash_sector_addr(CONFIG_USR_DRV_FLASH_WEAR_SECTOR);
+    uint32_t size = flash_sector_size(CONFIG_USR_DRV_FLASH_WEAR_SECTOR);
+    uint32_t hdr[4] = { WEAR_MAGIC, 5, ~5u, 0xffffffff };
+    uint32_t prev[6] = { WEAR_MAGIC, 4, ~4u, 0xffffffff, WEAR_TAG(OTHER_SECTOR), 1 };
+    uint32_t nb = (size - WEAR_HDR_SIZE) / 8 - NB_FREE;
+    uint32_t *rec = malloc(nb * 8);
+
+    TEST_ASSERT(rec != NULL);
+    for (uint32_t i = 0; i < nb; ++i) {
+        rec[2 * i] = WEAR_TAG(OTHER_SECTOR);
+        rec[2 * i + 1] = OTHER_COUNT - nb + i + 1;
+    }
+    rec[2 * (nb - 1)] = WEAR_TAG(ERASED_SECTOR);
+    rec[2 * (nb - 1) + 1] = ERASED_COUNT;
+    test_setup();
+    flash_sim_poke(base, hdr, sizeof(hdr));
+    flash_sim_poke(base + WEAR_HDR_SIZE, rec, nb * 8);
+    flash_sim_poke(flash_sector_addr(CONFIG_USR_DRV_FLASH_WEAR_SECTOR2), prev, sizeof(prev));
+    free(rec);
+    TEST_ASSERT(flash_wear_init() == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_wear_get_count(OTHER_SECTOR) == OTHER_COUNT - 1);
+    TEST_ASSERT(flash_wear_get_count(ERASED_SECTOR) == ERASED_COUNT);
+}
+
+static void run(void *ctx)
+{
+    workload_t *w = ctx;
+
+    while (w->done < NB_ERASES) {
+        TEST_ASSERT(flash_sector_erase(flash_sector_addr(ERASED_SECTOR)) != 0xff);
+        w->done++;
+    }
+}
+
+static void init(void *ctx)
+{
+    (void)ctx;
+    flash_wear_init();
+}
+
+static void check_recovery(uint32_t done, uint32_t seed)
+{
+    uint32_t count;
+
+    for (uint32_t m = 1; ; ++m) {
+        test_reboot();
+        if (!test_cut_run(m, seed + m, init, NULL)) {
+            break;
+        }
+    }
+    test_reboot();
+    TEST_ASSERT(flash_wear_init() == FLASH_ERR_NONE);
+    count = flash_wear_get_count(ERASED_SECTOR);
+    TEST_ASSERT(count == ERASED_COUNT + done || count == ERASED_COUNT + done + 1);
+    TEST_ASSERT(flash_wear_get_count(OTHER_SECTOR) == OTHER_COUNT - 1);
+    /* the counters are still saved */
+    TEST_ASSERT(flash_sector_erase(flash_sector_addr(ERASED_SECTOR)) != 0xff);
+    test_reboot();
+    TEST_ASSERT(flash_wear_init() == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_wear_get_count(ERASED_SECTOR) == count + 1);
+}
+
+/* the compaction counts the erase of the other counters sector once */
+static void test_compaction(void)
+{
+    workload_t w = { 0 };
+
+    setup();
+    run(&w);
+    test_reboot();
+    TEST_ASSERT(flash_wear_init() == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_wear_get_count(ERASED_SECTOR) == ERASED_COUNT + NB_ERASES);
+    TEST_ASSERT(flash_wear_get_count(OTHER_SECTOR) == OTHER_COUNT - 1);
+    TEST_ASSERT(flash_wear_get_count(CONFIG_USR_DRV_FLASH_WEAR_SECTOR) == 0);
+    TEST_ASSERT(flash_wear_get_count(CONFIG_USR_DRV_FLASH_WEAR_SECTOR2) == 1);
+}
+
+/*
+ * A record of ERASED_SECTOR, its tag partially programmed: some bits of the
+ * sector number, or of its complement, are still set. The record is
+ * skipped, and doesn't change the counter of another sector.
+ */
+static void test_torn_tag(void)
+{
+    static const uint32_t torn[] = {
+        /* sector number 1 read as 5, 3 or 0xff */
+        0xfe05, 0xfe03, 0xfeff,
+        /* complement partially programmed */
+        0xff01, 0xff81,
+    };
+    uint32_t size = flash_sector_size(CONFIG_USR_DRV_FLASH_WEAR_SECTOR);
+    physaddr_t free_rec = flash_sector_addr(CONFIG_USR_DRV_FLASH_WEAR_SECTOR) + WEAR_HDR_SIZE +
+                          ((size - WEAR_HDR_SIZE) / 8 - NB_FREE) * 8;
+    uint32_t rec[2];
+
+    for (uint32_t i = 0; i < sizeof(torn) / sizeof(torn[0]); ++i) {
+        setup();
+        rec[0] = 0x57450000 | torn[i];
+        rec[1] = 3;
+        flash_sim_poke(free_rec, rec, sizeof(rec));
+        test_reboot();
+        TEST_ASSERT(flash_wear_get_count(ERASED_SECTOR) == ERASED_COUNT);
+        TEST_ASSERT(flash_wear_get_count(OTHER_SECTOR) == OTHER_COUNT - 1);
+        TEST_ASSERT(flash_wear_get_count(3) == 0);
+        /* the next record is appended after it */
+        TEST_ASSERT(flash_sector_erase(flash_sector_addr(ERASED_SECTOR)) != 0xff);
+        test_reboot();
+        TEST_ASSERT(flash_wear_get_count(ERASED_SECTOR) == ERASED_COUNT + 1);
+    }
+}
+
+/* power cut at each operation, and at various progress of the erases */
+static void test_cuts(void)
+{
+    workload_t w;
+    bool cut = true;
+
+    for (uint32_t n = 1; cut; ++n) {
+        for (uint32_t seed = n; cut && seed < n + 4; ++seed) {
+            setup();
+            w.done = 0;
+            cut = test_cut_run(n, seed, run, &w);
+            check_recovery(w.done, seed);
+        }
+    }
+}
+
+int main(void)
+{
+    test_compaction();
+    test_torn_tag();
+    test_cuts();
+    flash_sim_exit();
+    return test_done("wear");
+}
+
+#else
+
+int main(void)
+{
+    return test_skip("wear");
+}
+
+#endif
@@ -0,0 +1,214 @@
+/** @file test_wrp.c
+ * \brief Write protection
+ *
+ * Erases and writes touching a write protected sector are refused with
+ * FLASH_ERR_WRP before any flash operation, the flash content being left
+ * unchanged.
+ *
+ * A protected range covers all the sectors it overlaps, across the banks,
+ * and the protection is effective as soon as it is committed.
+ */
+
+#include <string.h>
+#include "flash_test.h"
+
+/* protected sectors: a 128KB one, and one of bank 2 */
+#define WRP_SECTOR      5
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+# define WRP_SECTOR2    13
+#endif
+
+static uint8_t before[FLASH_SIM_SIZE];
+static uint64_t ops;
+
+static void fill(uint8_t sector)
+{
+    static uint8_t buf[128 * 1024];
+    uint32_t size = flash_sector_size(sector);
+
+    for (uint32_t i = 0; i < size; ++i) {
+        buf[i] = (uint8_t)(i * 13 + sector) | 0x01;
+    }
+    flash_sim_poke(flash_sector_addr(sector), buf, size);
+}
+
+static inline uint64_t op_count(void)
+{
+    return flash_sim_program_count() + flash_sim_erase_count();
+}
+
+/* no flash operation, nor content change, since the snapshot */
+static void snapshot(void)
+{
+    memcpy(before, (const void*)FLASH_SIM_BASE, sizeof(before));
+    ops = op_count();
+}
+
+static void check_unchanged(void)
+{
+    TEST_ASSERT(op_count() == ops);
+    TEST_ASSERT(memcmp(before, (const void*)FLASH_SIM_BASE, sizeof(before)) == 0);
+}
+
+static void setup_protected(void)
+{
+    test_setup();
+    fill(WRP_SECTOR);
+    fill(WRP_SECTOR - 1);
+    fill(WRP_SECTOR + 1);
+    flash_unlock_opt();
+    TEST_ASSERT(flash_wrp_set_range(flash_sector_addr(WRP_SECTOR), 1, true) == FLASH_ERR_NONE);
+#ifdef WRP_SECTOR2
+    fill(WRP_SECTOR2);
+    TEST_ASSERT(flash_wrp_set_range(flash_sector_addr(WRP_SECTOR2), 1, true) == FLASH_ERR_NONE);
+#endif
+    test_reboot();
+}
+
+static void check_refused(physaddr_t addr)
+{
+    uint8_t buf[16] = { 0 };
+
+    snapshot();
+    TEST_ASSERT(flash_sector_erase(addr) == 0xff);
+    TEST_ASSERT(flash_get_last_error() == FLASH_ERR_WRP);
+    check_unchanged();
+    TEST_ASSERT(flash_write(addr + 0x100, buf, sizeof(buf)) == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_get_last_error() == FLASH_ERR_WRP);
+    check_unchanged();
+    /* the implicit erase at a sector start, and within the sector */
+    TEST_ASSERT(flash_program_word((uint32_t*)addr, 0) == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_program_word((uint32_t*)(addr + 4), 0) == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_program_hword((uint16_t*)(addr + 8), 0) == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_program_byte((uint8_t*)(addr + 11), 0) == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_program_dword((uint64_t*)(addr + 16), 0) == FLASH_ERR_WRP);
+    check_unchanged();
+}
+
+static void test_refused(void)
+{
+    uint8_t buf[64];
+    physaddr_t end = flash_sector_addr(WRP_SECTOR + 1);
+
+    setup_protected();
+    check_refused(flash_sector_addr(WRP_SECTOR));
+#ifdef WRP_SECTOR2
+    check_refused(flash_sector_addr(WRP_SECTOR2));
+#endif
+    /* a write across an unprotected and the protected sector is refused */
+    memset(buf, 0, sizeof(buf));
+    snapshot();
+    TEST_ASSERT(flash_write(end - 32, buf, sizeof(buf)) == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_write(flash_sector_addr(WRP_SECTOR) - 32, buf, sizeof(buf)) ==
+                FLASH_ERR_WRP);
+    /* into it, or out of it */
+    TEST_ASSERT(flash_copy_sector(flash_sector_addr(WRP_SECTOR),
+                                  flash_sector_addr(WRP_SECTOR + 1)) == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_bank_erase(0) == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_mass_erase() == FLASH_ERR_WRP);
+    check_unchanged();
+    TEST_ASSERT(flash_copy_sector(flash_sector_addr(WRP_SECTOR + 1),
+                                  flash_sector_addr(WRP_SECTOR)) == FLASH_ERR_NONE);
+    TEST_ASSERT(memcmp((const void*)flash_sector_addr(WRP_SECTOR + 1),
+                       (const void*)flash_sector_addr(WRP_SECTOR), 128 * 1024) == 0);
+
+    /* the neighbour sectors, and the sector once unprotected, are writable */
+    TEST_ASSERT(flash_sector_erase(flash_sector_addr(WRP_SECTOR - 1)) != 0xff);
+    flash_unlock_opt();
+    TEST_ASSERT(flash_wrp_set_range(flash_sector_addr(WRP_SECTOR), 1, false) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_sector_erase(flash_sector_addr(WRP_SECTOR)) != 0xff);
+    TEST_ASSERT(*(volatile uint32_t*)flash_sector_addr(WRP_SECTOR) == 0xffffffff);
+#ifdef WRP_SECTOR2
+    TEST_ASSERT(flash_wrp_set_range(flash_sector_addr(WRP_SECTOR2), 1, false) == FLASH_ERR_NONE);
+#endif
+    TEST_ASSERT(flash_wrp_query() == 0);
+}
+
+/* nWRP bits cleared by staging the protection of [addr, addr + len[ */
+static uint32_t staged(physaddr_t addr, uint32_t len)
+{
+    t_flash_opt opt;
+    uint32_t nwrp;
+    uint32_t map;
+
+    TEST_ASSERT(flash_opt_read(&opt) == FLASH_ERR_NONE);
+    nwrp = opt.nwrp;
+    TEST_ASSERT(flash_wrp_stage_range(&opt, addr, len, true) == FLASH_ERR_NONE);
+    TEST_ASSERT((opt.nwrp & ~nwrp) == 0);
+    map = nwrp & ~opt.nwrp;
+    /* and set again by staging its unprotection */
+    TEST_ASSERT(flash_wrp_stage_range(&opt, addr, len, false) == FLASH_ERR_NONE);
+    TEST_ASSERT(opt.nwrp == nwrp);
+    return map;
+}
+
+static void test_ranges(void)
+{
+    physaddr_t s4 = flash_sector_addr(4);
+    t_flash_opt opt;
+    t_flash_opt ref;
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+    physaddr_t bank2;
+    uint8_t last1;
+#endif
+
+    test_setup();
+    flash_unlock_opt();
+    TEST_ASSERT(flash_wrp_query() == 0);
+    /* rounded to the sectors at both ends */
+    TEST_ASSERT(staged(s4, 64 * 1024) == 1u << 4);
+    TEST_ASSERT(staged(s4 + 1, 64 * 1024 - 2) == 1u << 4);
+    TEST_ASSERT(staged(s4 - 1, 2) == (1u << 3 | 1u << 4));
+    TEST_ASSERT(staged(s4 - 1, 64 * 1024 + 2) == (1u << 3 | 1u << 4 | 1u << 5));
+    TEST_ASSERT(staged(FLASH_SECTOR_0, 3 * 16 * 1024 + 1) == 0xf);
+    /* out of the flash, or empty */
+    TEST_ASSERT(flash_opt_read(&opt) == FLASH_ERR_NONE);
+    ref = opt;
+    TEST_ASSERT(flash_wrp_stage_range(&opt, s4, 0, true) == FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_wrp_stage_range(&opt, FLASH_SECTOR_0 - 1, 2, true) == FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_wrp_stage_range(&opt, FLASH_SIM_BASE + FLASH_SIM_SIZE - 1, 2, true) ==
+                FLASH_ERR_INVAL);
+    TEST_ASSERT(flash_wrp_stage_range(NULL, s4, 1, true) == FLASH_ERR_INVAL);
+    TEST_ASSERT(memcmp(&opt, &ref, sizeof(opt)) == 0);
+    /* staging doesn't protect */
+    TEST_ASSERT(flash_wrp_query() == 0);
+
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+    /* the last bank 1 sector and the first bank 2 one */
+    bank2 = flash_sector_addr(12);
+    last1 = flash_select_sector(bank2 - 1);
+    TEST_ASSERT(staged(bank2 - 16, 32) == (1u << last1 | 1u << 12));
+    TEST_ASSERT(flash_wrp_set_range(bank2 - 16, 32, true) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_wrp_query() == (1u << last1 | 1u << 12));
+    TEST_ASSERT(flash_sector_erase(bank2) == 0xff);
+    TEST_ASSERT(flash_get_last_error() == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_sector_erase(flash_sector_addr(last1)) == 0xff);
+    TEST_ASSERT(flash_sector_erase(flash_sector_addr(13)) != 0xff);
+    TEST_ASSERT(flash_opt_read(&opt) == FLASH_ERR_NONE);
+    TEST_ASSERT((opt.nwrp & (1u << last1 | 1u << 12)) == 0);
+    TEST_ASSERT(flash_wrp_set_range(bank2 - 16, 32, false) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_wrp_query() == 0);
+#endif
+
+    /* the cached protection follows each commit, without reset */
+    TEST_ASSERT(flash_wrp_set_range(s4 - 1, 2, true) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_wrp_query() == (1u << 3 | 1u << 4));
+    TEST_ASSERT(flash_sector_erase(s4) == 0xff);
+    TEST_ASSERT(flash_get_last_error() == FLASH_ERR_WRP);
+    TEST_ASSERT(flash_wrp_set_range(s4, 1, false) == FLASH_ERR_NONE);
+    TEST_ASSERT(flash_wrp_query() == 1u << 3);
+    TEST_ASSERT(flash_sector_erase(s4) != 0xff);
+    /* and is reloaded from the option bytes at reset */
+    test_reboot();
+    TEST_ASSERT(flash_wrp_query() == 1u << 3);
+    TEST_ASSERT(flash_sector_erase(flash_sector_addr(3)) == 0xff);
+    TEST_ASSERT(flash_get_last_error() == FLASH_ERR_WRP);
+}
+
+int main(void)
+{
+    test_refused();
+    test_ranges();
+    flash_sim_exit();
+    return test_done("wrp");
+}
@@ -12,6 +12,8 @@
 #include "libc/string.h"
 #include "libc/regutils.h"
 #include "flash_regs.h"
+#include "flash_backend.h"
+#include "flash_hooks.h"
 
 #define FLASH_DEBUG 0
 
@@ -92,7 +94,9 @@ static const flash_device_tab_base flash_device_tab[] = {
 # endif
 #endif
     {"flash_ctrl",      0x40023C00,    0x400},
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
     {"flash_ctrl_2",    0x40023C00,    0x100},
+#endif
     {"flash_system",    0x1FFF0000,   0x7800},
     {"flash_otp",       0x1FFF7800,    0x400},
     {"flash_opb_bk1",   0x1FFFC000,     0x20},
@@ -166,7 +170,7 @@ int flash_device_early_init(t_device_mapping *devmap)
             return -1;
         }
 #if FLASH_DEBUG
-        printf("registering %s\n", flash_devicename);
+        printf("registering %s\n", flash_device.name);
 #endif
         ret = sys_init(INIT_DEVACCESS, &flash_device,
                                        &flash_device_desc_tab[FLIP]);
@@ -202,7 +206,7 @@ int flash_device_early_init(t_device_mapping *devmap)
     }
 #else
 # if CONFIG_USR_DRV_FLASH_DUAL_BANK
-    if (devmap->map_bank1) {
+    if (devmap->map_mem_bank1) {
         if(create_flash_device(BANK1, &flash_device)){
             return -1;
         }
@@ -215,7 +219,7 @@ int flash_device_early_init(t_device_mapping *devmap)
             goto err;
         }
     }
-    if (devmap->map_bank2) {
+    if (devmap->map_mem_bank2) {
         if(create_flash_device(BANK2, &flash_device)){
             return -1;
         }
@@ -336,17 +340,392 @@ err:
 	return -1;
 }
 
+#if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+/* geometry of the build configuration, until detected by flash_init() */
+t_flash_geometry flash_geometry = {
+# if CONFIG_USR_DRV_FLASH_2M
+    .size = 0x200000, .bank2 = 0x100000, .sectors = 0xffffff,
+# elif CONFIG_USR_DRV_FLASH_DUAL_BANK
+    .size = 0x100000, .bank2 = 0x80000, .sectors = 0x0ff0ff,
+# else
+    .size = 0x100000, .bank2 = 0, .sectors = 0xfff,
+# endif
+};
+
+/* sector index in its bank, from the offset in the bank */
+static inline uint8_t flash_geo_sector(uint32_t off)
+{
+    if (off < 0x10000) {
+        return off >> 14;
+    }
+    if (off < 0x20000) {
+        return 4;
+    }
+    return 4 + (off >> 17);
+}
+
+/* offset and size of a sector in its bank, from its index */
+static inline uint32_t flash_geo_sector_off(uint8_t idx)
+{
+    return idx < 5 ? (uint32_t)idx << 14 : (uint32_t)(idx - 4) << 17;
+}
+
+static inline uint32_t flash_geo_sector_size(uint8_t idx)
+{
+    return idx < 4 ? 0x4000 : (idx == 4 ? 0x10000 : 0x20000);
+}
+
+/*
+ * The devices are registered by flash_device_early_init(), before the
+ * geometry is detected (the size register being in the OTP device), at the
+ * addresses of the configured geometry. A detected flash must be covered
+ * by them: the single bank by the first bank device, or bank 2 starting at
+ * the second bank device address.
+ */
+static bool flash_geometry_is_mapped(uint32_t size, uint32_t bank2)
+{
+#if CONFIG_WOOKEY
+    const flash_device_tab_base *dev1 = &flash_device_tab[FLIP];
+    const flash_device_tab_base *dev2 = &flash_device_tab[FLOP];
+#elif CONFIG_USR_DRV_FLASH_DUAL_BANK
+    const flash_device_tab_base *dev1 = &flash_device_tab[BANK1];
+    const flash_device_tab_base *dev2 = &flash_device_tab[BANK2];
+#else
+    const flash_device_tab_base *dev1 = &flash_device_tab[MEM];
+    const flash_device_tab_base *dev2 = NULL;
+#endif
+
+    if (bank2 == 0) {
+        return size <= dev1->size;
+    }
+    return dev2 != NULL && dev2->base_addr == dev1->base_addr + bank2 &&
+           bank2 <= dev1->size && size - bank2 <= dev2->size;
+}
+
+/*
+ * Select the geometry from the flash size register and, for 1MB devices,
+ * the DB1M option bit (reading 0 on f40xxx/41xxx, which have no dual bank
+ * mode). 2MB devices are always in dual bank mode.
+ */
+static int flash_detect_geometry(void)
+{
+    uint32_t size, bank_size, sectors;
+    bool dual;
+
+    size = ((flash_be_read_reg(r_CORTEX_M_FLASH_SIZE) & FLASH_SIZE_KB_Msk)
+            >> FLASH_SIZE_KB_Pos) << 10;
+    switch (size) {
+        case 0x80000:
+            dual = false;
+            break;
+        case 0x100000:
+#if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)
+            dual = flash_get_reg(r_CORTEX_M_FLASH_OPTCR, FLASH_OPTCR_DB1M) != 0;
+#else
+            dual = false;
+#endif
+            break;
+        case 0x200000:
+            dual = true;
+            break;
+        default:
+            log_printf("unsupported flash size %x\n", size);
+            return -1;
+    }
+#if !CONFIG_USR_DRV_FLASH_DUAL_BANK
+    if (dual) {
+        log_printf("dual bank flash, not supported by this build\n");
+        return -1;
+    }
+#endif
+    bank_size = dual ? size / 2 : size;
+    if (!flash_geometry_is_mapped(size, dual ? bank_size : 0)) {
+        log_printf("%s bank flash layout not mapped by this build\n",
+                   dual ? "dual" : "single");
+        return -1;
+    }
+    sectors = (1u << (flash_geo_sector(bank_size - 1) + 1)) - 1;
+    if (dual) {
+        sectors |= sectors << 12;
+    }
+    flash_geometry.size = size;
+    flash_geometry.bank2 = dual ? bank_size : 0;
+    flash_geometry.sectors = sectors;
+    log_printf("flash: %d kB, %s bank\n", size >> 10, dual ? "dual" : "single");
+    return 0;
+}
+#endif
+
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+/*
+ * Bank booted from: BFB2 as loaded at reset, before any option bytes
+ * commit. When booting from bank 2, the system memory bootloader maps it
+ * at 0x08000000, bank 1 being then at the bank 2 addresses.
+ */
+static t_flash_bank_id flash_boot_bank = FLASH_BANK_0;
+static bool flash_boot_bank_latched = false;
+#endif
+
+/*
+ * Sector numbers are physical: they are the ones of the SNB field, of the
+ * nWRP/SPRMOD bits and of the bank erase, whatever the bank mapping.
+ * Addresses are the ones of the bus. Both are the same, except when booted
+ * from bank 2, the banks being then swapped in the address space: the
+ * sector numbers of both banks are exchanged when converting between
+ * addresses and sectors.
+ */
+static inline uint8_t flash_bank_swap(uint8_t sector)
+{
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+# if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+    if (flash_geometry.bank2 == 0) {
+        return sector;
+    }
+# endif
+    if (sector < 24 && flash_boot_get_bank() == FLASH_BANK_1) {
+        return sector < 12 ? sector + 12 : sector - 12;
+    }
+#endif
+    return sector;
+}
+
+/*
+ * OTP area content (data blocks, then lock bytes), read once from the
+ * flash and kept up to date by the OTP programming functions: the OTP area
+ * is only modified through them.
+ */
+static uint8_t flash_otp_cache[FLASH_OTP_SIZE];
+static bool flash_otp_loaded = false;
+
 int flash_init(void)
 {
+    /* RAM copies, read again: a programming may have been cut before reset */
+    flash_otp_loaded = false;
+#if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+    if (flash_detect_geometry() != 0) {
+        return -1;
+    }
+#endif
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+    /* bank mapping set at reset */
+    flash_boot_bank_latched = false;
+    flash_boot_get_bank();
+#endif
     return 0;
 }
 
+/*
+ * Maximum busy durations, in microseconds, indexed by PSIZE (x8, x16, x32,
+ * x64). Values are the max figures of the STM32F42x/43x datasheet flash
+ * programming characteristics (x64 being only usable with external Vpp, the
+ * x32 maximum is used for it). A 25% margin is added when used as timeout
+ * to absorb the systick granularity.
+ */
+static const uint32_t flash_tmo_prog[4]      = {      100,      100,      100,      100 };
+static const uint32_t flash_tmo_erase_16k[4] = {   800000,   600000,   500000,   500000 };
+static const uint32_t flash_tmo_erase_64k[4] = {  2400000,  1400000,  1100000,  1100000 };
+static const uint32_t flash_tmo_erase_128k[4]= {  4000000,  2600000,  2000000,  2000000 };
+static const uint32_t flash_tmo_erase_bank[4]= { 16000000, 11000000,  8000000,  8000000 };
+static const uint32_t flash_tmo_erase_mass[4]= { 32000000, 22000000, 16000000, 16000000 };
+
+#define FLASH_TMO(max_us)       ((max_us) + ((max_us) >> 2))
+
+/* PSIZE used for erase operations (x32, 2.7V-3.6V) */
+#define FLASH_ERASE_PSIZE       2
+
+static t_flash_progress_hook flash_progress_hook = NULL;
+static uint32_t flash_progress_period = 0;
+
+static t_flash_err flash_last_err = FLASH_ERR_NONE;
+
+/**
+ * \brief Register a hook called periodically while waiting for the flash
+ *
+ * The hook is called at most every period_us microseconds during long
+ * busy waits (typically sector, bank or mass erase), so that the
+ * application can refresh its watchdog.
+ *
+ * @param hook      hook to call, NULL to disable
+ * @param period_us minimum delay between two successive hook calls
+ */
+void flash_set_progress_hook(t_flash_progress_hook hook, uint32_t period_us)
+{
+    flash_progress_hook = hook;
+    flash_progress_period = period_us;
+}
+
+/**
+ * \brief Return the cause of the last failed flash operation
+ */
+t_flash_err flash_get_last_error(void)
+{
+    return flash_last_err;
+}
+
+/* returns false if the systick can't be read (e.g. no timer permission) */
+static inline bool flash_get_time_us(uint64_t *us)
+{
+    return sys_get_systick(us, PREC_MICRO) == SYS_E_DONE;
+}
+
 static inline int flash_is_busy(void){
-	return !!(read_reg_value(r_CORTEX_M_FLASH_SR) & FLASH_SR_BSY);
+	return !!(flash_be_read_reg(r_CORTEX_M_FLASH_SR) & FLASH_SR_BSY);
+}
+
+/*
+ * Number of BSY polls between two systick reads. Reading the systick is a
+ * syscall, costing more than a whole program operation: short operations
+ * complete within the first polls, without any systick read, and long ones
+ * only read it every FLASH_BUSY_POLLS polls.
+ */
+#define FLASH_BUSY_POLLS        128
+
+/*
+ * Lower bound of a BSY poll duration, in nanoseconds: a peripheral register
+ * read and a loop iteration take more than one cycle at the max core
+ * frequency (180MHz). When the systick can't be read, the elapsed time is
+ * bounded from the number of polls: the timeouts are then longer than
+ * required, but still expire.
+ */
+#define FLASH_POLL_MIN_NS       6
+#define FLASH_POLLS_US(rounds)  ((rounds) * FLASH_BUSY_POLLS * FLASH_POLL_MIN_NS / 1000)
+
+/*
+ * Wait for the BSY flag to be cleared, at most timeout_us microseconds.
+ * The timeout starts after the first FLASH_BUSY_POLLS polls (a few
+ * microseconds), which the timeouts margin covers. The progress hook, if
+ * any, is called during the wait.
+ */
+static t_flash_err flash_busy_wait(uint32_t timeout_us)
+{
+    uint64_t start = 0, now = 0, next_hook;
+    uint64_t rounds = 0;
+    uint32_t polls;
+    bool systick;
+
+    for (polls = 0; polls < FLASH_BUSY_POLLS; ++polls) {
+        if (!flash_is_busy()) {
+            return FLASH_ERR_NONE;
+        }
+    }
+    if (!(systick = flash_get_time_us(&start))) {
+        start = 0;
+    }
+    next_hook = start + flash_progress_period;
+    while (flash_is_busy()) {
+        if (++polls < FLASH_BUSY_POLLS) {
+            continue;
+        }
+        polls = 0;
+        rounds++;
+        if (!systick || !flash_get_time_us(&now)) {
+            systick = false;
+            now = start + FLASH_POLLS_US(rounds);
+        }
+        if (now - start > timeout_us) {
+            /* last chance, the operation may have completed meanwhile */
+            if (!flash_is_busy()) {
+                break;
+            }
+            log_printf("flash still busy after %d us, giving up\n", timeout_us);
+            return FLASH_ERR_TIMEOUT;
+        }
+        if (flash_progress_hook != NULL && now >= next_hook) {
+            flash_progress_hook((uint32_t)(now - start));
+            next_hook = now + flash_progress_period;
+        }
+    }
+    return FLASH_ERR_NONE;
+}
+
+/*
+ * Timeout of the sector erase, depending on the sector size. Sectors are
+ * 16k for 0-3, 64k for 4 and 128k for the others, identically in each bank.
+ */
+static inline uint32_t flash_erase_timeout(uint8_t sector)
+{
+    uint8_t idx = sector % 12;
+
+    if (idx < 4) {
+        return FLASH_TMO(flash_tmo_erase_16k[FLASH_ERASE_PSIZE]);
+    }
+    if (idx == 4) {
+        return FLASH_TMO(flash_tmo_erase_64k[FLASH_ERASE_PSIZE]);
+    }
+    return FLASH_TMO(flash_tmo_erase_128k[FLASH_ERASE_PSIZE]);
+}
+
+/*
+ * An operation should never be pending when starting a new one. As the
+ * pending operation is unknown, wait for the longest possible one.
+ */
+static inline t_flash_err flash_check_not_busy(void)
+{
+	if (flash_is_busy()) {
+		log_printf("Flash busy. Should not happen\n");
+        return flash_busy_wait(FLASH_TMO(flash_tmo_erase_mass[FLASH_ERASE_PSIZE]));
+	}
+    return FLASH_ERR_NONE;
+}
+
+/*
+ * Write protected sectors (bit n for sector n), from the nWRP option bytes.
+ * Loaded at the first check and reloaded after an option bytes
+ * programming, so that writes and erases to protected sectors are rejected
+ * without a failed program or erase operation.
+ */
+static uint32_t flash_wrp_map = 0;
+/* PCROP protected sectors, not readable by data accesses */
+static uint32_t flash_pcrop_map = 0;
+static bool flash_wrp_loaded = false;
+
+static void flash_wrp_load(void)
+{
+    uint32_t optcr = flash_be_read_reg(r_CORTEX_M_FLASH_OPTCR);
+    uint32_t nwrp;
+
+    nwrp = (optcr & FLASH_OPTCR_nWRP_Msk) >> FLASH_OPTCR_nWRP_Pos;
+#if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)
+    nwrp |= ((flash_be_read_reg(r_CORTEX_M_FLASH_OPTCR1) & FLASH_OPTCR1_nWRP_Msk)
+             >> FLASH_OPTCR1_nWRP_Pos) << 12;
+    if (optcr & FLASH_OPTCR_SPRMOD_Msk) {
+        /* PCROP: nWRP set for a protected sector, also write protected */
+        flash_wrp_map = nwrp;
+        flash_pcrop_map = nwrp;
+    } else {
+        flash_wrp_map = ~nwrp & 0xffffff;
+        flash_pcrop_map = 0;
+    }
+#else
+    flash_wrp_map = ~nwrp & 0xfff;
+    flash_pcrop_map = 0;
+#endif
+#if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+    /* nWRP bits of missing sectors are meaningless */
+    flash_wrp_map &= flash_geometry.sectors;
+    flash_pcrop_map &= flash_geometry.sectors;
+#endif
+    flash_wrp_loaded = true;
 }
 
-static inline void flash_busy_wait(void){
-	while (flash_is_busy()) {};
+static inline bool flash_is_sector_protected(uint8_t sector)
+{
+    if (!flash_wrp_loaded) {
+        flash_wrp_load();
+    }
+    return sector < 24 && (flash_wrp_map & (1u << sector));
+}
+
+/* return true if a sector of [addr, addr + size[ is write protected */
+static bool flash_is_range_protected(physaddr_t addr, uint32_t size)
+{
+    if (!flash_wrp_loaded) {
+        flash_wrp_load();
+    }
+    if (flash_wrp_map == 0) {
+        return false;
+    }
+    return (flash_range_sectors(addr, size) & flash_wrp_map) != 0;
 }
 
 /**
@@ -357,15 +736,15 @@ static inline void flash_busy_wait(void){
 void flash_unlock(void)
 {
 	log_printf("Unlocking flash\n");
-	write_reg_value(r_CORTEX_M_FLASH_KEYR, KEY1);
-	write_reg_value(r_CORTEX_M_FLASH_KEYR, KEY2);
+	flash_be_write_reg(r_CORTEX_M_FLASH_KEYR, KEY1);
+	flash_be_write_reg(r_CORTEX_M_FLASH_KEYR, KEY2);
 
     /*
      * when unlocking flash for the first time after reset, the PGSERR flag
      * is active and need to be cleared.
      * errata: this is *not* described in the datasheet !
      */
-    set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_PGSERR);
+    flash_set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_PGSERR);
 }
 
 /**
@@ -374,8 +753,8 @@ void flash_unlock(void)
 void flash_unlock_opt(void)
 {
 	log_printf("Unlocking flash option bytes register\n");
-	write_reg_value(r_CORTEX_M_FLASH_OPTKEYR, OPTKEY1);
-	write_reg_value(r_CORTEX_M_FLASH_OPTKEYR, OPTKEY2);
+	flash_be_write_reg(r_CORTEX_M_FLASH_OPTKEYR, OPTKEY1);
+	flash_be_write_reg(r_CORTEX_M_FLASH_OPTKEYR, OPTKEY2);
 }
 
 /**
@@ -384,8 +763,8 @@ void flash_unlock_opt(void)
 void flash_lock(void)
 {
 	log_printf("Locking flash\n");
-	write_reg_value(r_CORTEX_M_FLASH_CR, 0x00000000);
-	set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_LOCK);	/* Write only to 1, unlock is
+	flash_be_write_reg(r_CORTEX_M_FLASH_CR, 0x00000000);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_LOCK);	/* Write only to 1, unlock is
 							 * done by the previous
 							 * sequence (RM0090
 							 * DocID018909
@@ -399,11 +778,14 @@ void flash_lock(void)
 void flash_lock_opt(void)
 {
 	log_printf("Locking flash option bytes register\n");
-	set_reg(r_CORTEX_M_FLASH_OPTCR, 1, FLASH_OPTCR_OPTLOCK); /* Same as previously */
+	flash_set_reg(r_CORTEX_M_FLASH_OPTCR, 1, FLASH_OPTCR_OPTLOCK); /* Same as previously */
 }
 
 static bool is_sector_start(physaddr_t addr)
 {
+#if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+    return IS_IN_FLASH(addr) && flash_sector_addr(flash_select_sector(addr)) == addr;
+#else
     switch (addr) {
 
         case FLASH_SECTOR_0:
@@ -445,20 +827,32 @@ static bool is_sector_start(physaddr_t addr)
             return false;
     }
 	return false;
+#endif
 }
 
-/**
- * \brief Select the sector to erase
- *
+/*
+ * Sector at an address, with bank 1 mapped at 0x08000000.
  * Sector address and size size depends on the configured flash device.
  * See flash_regs.h for more information about how these macros are defined.
- *
- * \param   addr Address pointing to sector
- *
- * \return sector number to erase
  */
-uint8_t flash_select_sector(physaddr_t addr)
+static uint8_t flash_map_sector(physaddr_t addr)
 {
+#if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+	uint32_t off;
+
+	if (addr < FLASH_SECTOR_0) {
+		return 0;
+	}
+	off = addr - FLASH_SECTOR_0;
+	if (off >= flash_geometry.size) {
+		log_printf("Error: %x Wrong address case, can't happen.\n", addr);
+		return 255;
+	}
+	if (flash_geometry.bank2 && off >= flash_geometry.bank2) {
+		return 12 + flash_geo_sector(off - flash_geometry.bank2);
+	}
+	return flash_geo_sector(off);
+#else
 	uint8_t sector = 255;
 	/* First 8 sectors are the same in single/dual mem config */
 	if (addr <= FLASH_SECTOR_0_END) {
@@ -547,6 +941,49 @@ uint8_t flash_select_sector(physaddr_t addr)
 		log_printf("Error: %x Wrong address case, can't happen.\n", addr);
 	}
 	return sector;
+#endif
+}
+
+/**
+ * \brief Select the sector to erase
+ *
+ * When booted from bank 2, the sector returned for a bank 2 address is the
+ * physical sector of bank 1 mapped there, and conversely.
+ *
+ * \param   addr Address pointing to sector
+ *
+ * \return sector number to erase
+ */
+uint8_t flash_select_sector(physaddr_t addr)
+{
+    uint8_t sector = flash_map_sector(addr);
+
+    if (addr < FLASH_SECTOR_0 || sector == 255) {
+        return sector;
+    }
+    return flash_bank_swap(sector);
+}
+
+/**
+ * \brief Return the sectors holding an address range
+ *
+ * @return bitmap of the (physical) sectors, bit n for sector n
+ */
+uint32_t flash_range_sectors(physaddr_t addr, uint32_t size)
+{
+    uint32_t map = 0;
+    physaddr_t end = addr + size;
+    uint8_t sector;
+
+    while (addr < end && IS_IN_FLASH(addr)) {
+        sector = flash_select_sector(addr);
+        if (sector >= 24) {
+            break;
+        }
+        map |= 1u << sector;
+        addr = flash_sector_addr(sector) + flash_sector_size(sector);
+    }
+    return map;
 }
 
 
@@ -556,7 +993,7 @@ uint8_t flash_select_sector(physaddr_t addr)
 static inline bool flash_has_programming_errors(void)
 {
     uint32_t reg;
-    reg = read_reg_value(r_CORTEX_M_FLASH_SR);
+    reg = flash_be_read_reg(r_CORTEX_M_FLASH_SR);
 #if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)      /*  Dual blank only on f42xxx/43xxx */
     uint32_t err_mask = 0x1f2;
 #else
@@ -565,33 +1002,33 @@ static inline bool flash_has_programming_errors(void)
     if (reg & err_mask) {
         if (reg & FLASH_SR_OPERR_Msk) {
             log_printf("flash write error: OPERR\n");
-            set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_OPERR);
+            flash_set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_OPERR);
             goto err;
         }
         if (reg & FLASH_SR_WRPERR_Msk) {
             log_printf("flash write error: WRPERR\n");
-            set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_WRPERR);
+            flash_set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_WRPERR);
             goto err;
         }
         if (reg & FLASH_SR_PGAERR_Msk) {
             log_printf("flash write error: PGAERR\n");
-            set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_PGAERR);
+            flash_set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_PGAERR);
             goto err;
         }
         if (reg & FLASH_SR_PGPERR_Msk) {
             log_printf("flash write error: PGPERR\n");
-            set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_PGPERR);
+            flash_set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_PGPERR);
             goto err;
         }
         if (reg & FLASH_SR_PGSERR_Msk) {
             log_printf("flash write error: PGSERR\n");
-            set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_PGSERR);
+            flash_set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_PGSERR);
             goto err;
         }
 #if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)			/* RDERR (only on f42xxx/43xxx) */
         if (reg & FLASH_SR_RDERR_Msk) {
             log_printf("flash write error: RDERR\n");
-            set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_RDERR);
+            flash_set_reg(r_CORTEX_M_FLASH_SR, 1, FLASH_SR_RDERR);
             goto err;
         }
 #endif
@@ -606,25 +1043,36 @@ err:
 /**
  * \brief Erase a sector on the flash memory.
  *
+ * On error, 0xff is returned and the cause is given by flash_get_last_error().
+ *
  * @param sector Sector to erase (from 16 to 128 kB)
  * @return Erased sector number
  */
 uint8_t flash_sector_erase(physaddr_t addr)
 {
 	uint8_t sector = 255;
+	uint8_t num;
+	uint32_t timeout;
+	t_flash_err err = FLASH_ERR_INVAL;
 	/* Check that we're looking into the flash */
 	if (!(IS_IN_FLASH(addr))) {
         goto err;
     }
 
 	/* Check that the BSY bit in the FLASH_SR reg is not set */
-	if(flash_is_busy()){
-		log_printf("Flash busy. Should not happen\n");
-        flash_busy_wait();
+	if ((err = flash_check_not_busy()) != FLASH_ERR_NONE) {
+        goto err;
     }
 
 	/* Select sector to erase */
 	sector = flash_select_sector(addr);
+	num = sector;
+	if (flash_is_sector_protected(num)) {
+        log_printf("sector %d is write protected\n", num);
+        err = FLASH_ERR_WRP;
+        goto err;
+    }
+	timeout = flash_erase_timeout(sector);
 #if defined(CONFIG_USR_DRV_FLASH_DUAL_BANK)
     if (sector > 11) {
         /* updating sector number for SNB[4:0] field instead of SNB[3:0] */
@@ -633,124 +1081,195 @@ uint8_t flash_sector_erase(physaddr_t addr)
 #endif
 	log_printf("Erasing flash sector #%d\n", sector);
 
+	flash_hook_sector_erase(num);
+
 	/* Set PSIZE to 0b10 (see STM-RM00090 chap. 3.6.2, PSIZE must be set) */
-	set_reg(r_CORTEX_M_FLASH_CR, 2, FLASH_CR_PSIZE);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, FLASH_ERASE_PSIZE, FLASH_CR_PSIZE);
 
 	/* Set SER bit */
-	set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_SER);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_SER);
 
 	/* Erase sector */
-	set_reg(r_CORTEX_M_FLASH_CR, sector, FLASH_CR_SNB);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, sector, FLASH_CR_SNB);
 
 	/* Set STRT bit in FLASH_CR reg */
-	set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_STRT);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_STRT);
 
 	/* Wait for BSY bit to be cleared */
-	flash_busy_wait();
+	if ((err = flash_busy_wait(timeout)) != FLASH_ERR_NONE) {
+        /* CR can't be modified while the erase is still running */
+        goto err;
+    }
 
 	/* Clean sector */
-	set_reg(r_CORTEX_M_FLASH_CR, 0, FLASH_CR_SNB);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 0, FLASH_CR_SNB);
 
 	/* Unset SER bit */
-	set_reg(r_CORTEX_M_FLASH_CR, 0, FLASH_CR_SER);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 0, FLASH_CR_SER);
 
     if (flash_has_programming_errors()) {
+        err = FLASH_ERR_PROG;
         goto err;
     }
+    flash_hook_sector_erased(num);
+    flash_last_err = FLASH_ERR_NONE;
 	return sector;
 err:
     log_printf("error while erasing sector at addr %x\n", addr);
+    flash_last_err = err;
     return 0xff;
 }
 
 /**
  * \brief Erase a whole bank
  *
+ * The bank is the physical one: when booted from bank 2, bank 1 is the
+ * bank mapped at the bank 2 addresses.
+ *
  * @param bank Bank to erase (0 bank 1, 1 bank 2)
  */
-void flash_bank_erase(uint8_t bank)
+t_flash_err flash_bank_erase(uint8_t bank)
 {
+	t_flash_err err;
 	/* Check that the BSY bit in the FLASH_SR reg is not set */
-	if(flash_is_busy()){
-		log_printf("Flash busy. Should not happen\n");
-        flash_busy_wait();
+	if ((err = flash_check_not_busy()) != FLASH_ERR_NONE) {
+        goto err;
 	}
 
+	/* a protected sector would make the whole bank erase fail */
+	if (!flash_wrp_loaded) {
+        flash_wrp_load();
+    }
+	if (flash_wrp_map & (bank ? 0xfff000 : 0xfff)) {
+        err = FLASH_ERR_WRP;
+        goto err;
+    }
+
 	/* Set MER or MER1 bit accordingly */
 	if (bank) {
 #if !(defined(CONFIG_USR_DRV_FLASH_DUAL_BANK)) /*  Dual blank only on f42xxx/43xxx */
 		log_printf("Can't acess bank 2 on a single bank memory!\n");
+        err = FLASH_ERR_INVAL;
         goto err;
 #else
-		set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_MER1);
+# if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+		if (flash_geometry.bank2 == 0) {
+            err = FLASH_ERR_INVAL;
+            goto err;
+        }
+# endif
+		flash_hook_bank_erase(bank);
+		flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_MER1);
 #endif
 	}
-	else
-		set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_MER);
+	else {
+		flash_hook_bank_erase(bank);
+		flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_MER);
+	}
 
 	/* Set STRT bit in FLASH_CR reg */
-	set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_STRT);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_STRT);
 
 	/* Wait for BSY bit to be cleared */
-	flash_busy_wait();
+	if ((err = flash_busy_wait(FLASH_TMO(flash_tmo_erase_bank[FLASH_ERASE_PSIZE]))) != FLASH_ERR_NONE) {
+        goto err;
+    }
+
+	/* Unset MER/MER1 bits, programming is refused while they are set */
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 0, FLASH_CR_MER);
+#if defined(CONFIG_USR_DRV_FLASH_DUAL_BANK)
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 0, FLASH_CR_MER1);
+#endif
 
     if (flash_has_programming_errors()) {
+        err = FLASH_ERR_PROG;
         goto err;
     }
-	return;
+    flash_hook_bank_erased(bank);
+    flash_last_err = FLASH_ERR_NONE;
+	return FLASH_ERR_NONE;
 err:
     log_printf("error while erasing bank\n");
-    return;
+    flash_last_err = err;
+    return err;
 }
 
 /**
  * \brief Mass erase (erase the whole flash)
  */
-void flash_mass_erase(void)
+t_flash_err flash_mass_erase(void)
 {
+	t_flash_err err;
 	/* Check that the BSY bit in the FLASH_SR reg is not set */
-	if(flash_is_busy()){
-        log_printf("Flash busy. Should not happen\n");
-        flash_busy_wait();
+	if ((err = flash_check_not_busy()) != FLASH_ERR_NONE) {
+        goto err;
 	}
 
+	if (!flash_wrp_loaded) {
+        flash_wrp_load();
+    }
+	if (flash_wrp_map != 0) {
+        err = FLASH_ERR_WRP;
+        goto err;
+    }
+
+	flash_hook_bank_erase(0);
+#if defined(CONFIG_USR_DRV_FLASH_DUAL_BANK)
+	flash_hook_bank_erase(1);
+#endif
+
 	/* Set MER and MER1 bit */
-	set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_MER);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_MER);
 #if defined(CONFIG_USR_DRV_FLASH_DUAL_BANK) /*  Dual blank only on f42xxx/43xxx */
-	set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_MER1);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_MER1);
 #endif
+
 	/* Set STRT bit in FLASH_CR reg */
-	set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_STRT);
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_STRT);
 
 	/* Wait for BSY bit to be cleared */
-	flash_busy_wait();
+	if ((err = flash_busy_wait(FLASH_TMO(flash_tmo_erase_mass[FLASH_ERASE_PSIZE]))) != FLASH_ERR_NONE) {
+        goto err;
+    }
+
+	/* Unset MER/MER1 bits, programming is refused while they are set */
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 0, FLASH_CR_MER);
+#if defined(CONFIG_USR_DRV_FLASH_DUAL_BANK)
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 0, FLASH_CR_MER1);
+#endif
 
     if (flash_has_programming_errors()) {
+        err = FLASH_ERR_PROG;
         goto err;
     }
-	return;
+    flash_hook_bank_erased(0);
+#if defined(CONFIG_USR_DRV_FLASH_DUAL_BANK)
+    flash_hook_bank_erased(1);
+#endif
+    flash_last_err = FLASH_ERR_NONE;
+	return FLASH_ERR_NONE;
 err:
     log_printf("error while mass-erasing\n");
-    return;
+    flash_last_err = err;
+    return err;
 
 }
 
 
-/* Macro for programming factorization */
-#define flash_program(addr, elem, elem_cfg) do {\
+/* Macro for programming factorization, err receiving the wait status */
+#define flash_program(addr, elem, elem_cfg, width, err) do {\
 	/* Check that the BSY bit in the FLASH_SR reg is not set */\
-	if (flash_is_busy()) {\
-		log_printf("Flash busy. Should not happen\n");\
-        flash_busy_wait();\
+	if (((err) = flash_check_not_busy()) != FLASH_ERR_NONE) {\
+        break;\
 	}\
 	/* Set PSIZE for 64 bits writing */\
-	set_reg(r_CORTEX_M_FLASH_CR, (elem_cfg), FLASH_CR_PSIZE);\
+	flash_set_reg(r_CORTEX_M_FLASH_CR, (elem_cfg), FLASH_CR_PSIZE);\
 	/* Set PG bit */\
-	set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_PG);\
+	flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_PG);\
 	/* Perform data write op */\
-	*(addr) = (elem);\
+	flash_be_mem_write_##width((physaddr_t)(addr), (elem));\
 	/* Wait for BSY bit to be cleared */\
-	flash_busy_wait();\
+	(err) = flash_busy_wait(FLASH_TMO(flash_tmo_prog[(elem_cfg)]));\
 } while(0);
 
 /**
@@ -761,21 +1280,34 @@ err:
  * As today, need an extern lock and erase. May be
  * integrated in this function in the future ?
  */
-void flash_program_dword(uint64_t *addr, uint64_t value)
+t_flash_err flash_program_dword(uint64_t *addr, uint64_t value)
 {
+    t_flash_err err;
     if (is_sector_start((physaddr_t)addr) == true) {
         if (flash_sector_erase((physaddr_t)addr) == 0xff) {
+            err = flash_last_err;
             goto err;
         }
     }
-	flash_program(addr, value, 3);
+    if (flash_is_sector_protected(flash_select_sector((physaddr_t)addr))) {
+        err = FLASH_ERR_WRP;
+        goto err;
+    }
+    flash_hook_program((physaddr_t)addr, sizeof(*addr));
+	flash_program(addr, value, 3, 64, err);
+    if (err != FLASH_ERR_NONE) {
+        goto err;
+    }
     if (flash_has_programming_errors()) {
+        err = FLASH_ERR_PROG;
         goto err;
     }
-    return;
+    flash_last_err = FLASH_ERR_NONE;
+    return FLASH_ERR_NONE;
 err:
     log_printf("error while programming sector at addr %x\n", addr);
-    return;
+    flash_last_err = err;
+    return err;
 }
 
 /**
@@ -786,22 +1318,35 @@ err:
  * As today, need an extern lock and erase. May be
  * integrated in this function in the future ?
  */
-void flash_program_word(uint32_t *addr, uint32_t value)
+t_flash_err flash_program_word(uint32_t *addr, uint32_t value)
 {
+    t_flash_err err;
     if (is_sector_start((physaddr_t)addr) == true) {
         printf("starting programing new sector (@%x)\n", addr);
         if (flash_sector_erase((physaddr_t)addr) == 0xff) {
+            err = flash_last_err;
             goto err;
         }
     }
-	flash_program(addr, value, 2);
+    if (flash_is_sector_protected(flash_select_sector((physaddr_t)addr))) {
+        err = FLASH_ERR_WRP;
+        goto err;
+    }
+    flash_hook_program((physaddr_t)addr, sizeof(*addr));
+	flash_program(addr, value, 2, 32, err);
+    if (err != FLASH_ERR_NONE) {
+        goto err;
+    }
     if (flash_has_programming_errors()) {
+        err = FLASH_ERR_PROG;
         goto err;
     }
-    return;
+    flash_last_err = FLASH_ERR_NONE;
+    return FLASH_ERR_NONE;
 err:
     log_printf("error while programming sector at addr %x\n", addr);
-    return;
+    flash_last_err = err;
+    return err;
 
 }
 
@@ -813,21 +1358,34 @@ err:
  * As today, need an extern lock and erase. May be
  * integrated in this function in the future ?
  */
-void flash_program_hword(uint16_t *addr, uint16_t value)
+t_flash_err flash_program_hword(uint16_t *addr, uint16_t value)
 {
+    t_flash_err err;
     if (is_sector_start((physaddr_t)addr) == true) {
         if (flash_sector_erase((physaddr_t)addr) == 0xff) {
+            err = flash_last_err;
             goto err;
         }
     }
-	flash_program(addr, value, 1);
+    if (flash_is_sector_protected(flash_select_sector((physaddr_t)addr))) {
+        err = FLASH_ERR_WRP;
+        goto err;
+    }
+    flash_hook_program((physaddr_t)addr, sizeof(*addr));
+	flash_program(addr, value, 1, 16, err);
+    if (err != FLASH_ERR_NONE) {
+        goto err;
+    }
     if (flash_has_programming_errors()) {
+        err = FLASH_ERR_PROG;
         goto err;
     }
-    return;
+    flash_last_err = FLASH_ERR_NONE;
+    return FLASH_ERR_NONE;
 err:
     log_printf("error while programming sector at addr %x\n", addr);
-    return;
+    flash_last_err = err;
+    return err;
 }
 
 /**
@@ -838,43 +1396,177 @@ err:
  * As today, need an extern lock and erase. May be
  * integrated in this function in the future ?
  */
-void flash_program_byte(uint8_t *addr, uint8_t value)
+t_flash_err flash_program_byte(uint8_t *addr, uint8_t value)
 {
+    t_flash_err err;
     if (is_sector_start((physaddr_t)addr) == true) {
         if (flash_sector_erase((physaddr_t)addr) == 0xff) {
+            err = flash_last_err;
             goto err;
         }
     }
-	flash_program(addr, value, 0);
+    if (flash_is_sector_protected(flash_select_sector((physaddr_t)addr))) {
+        err = FLASH_ERR_WRP;
+        goto err;
+    }
+    flash_hook_program((physaddr_t)addr, sizeof(*addr));
+	flash_program(addr, value, 0, 8, err);
+    if (err != FLASH_ERR_NONE) {
+        goto err;
+    }
     if (flash_has_programming_errors()) {
+        err = FLASH_ERR_PROG;
         goto err;
     }
-    return;
+    flash_last_err = FLASH_ERR_NONE;
+    return FLASH_ERR_NONE;
 err:
     log_printf("error while programming sector at addr %x\n", addr);
-    return;
+    flash_last_err = err;
+    return err;
 }
 
-
-/**
- * \brief Read from flash memory
- *
- * @param addr		Adress to read from
- * @param size		Size to read
- * @param buffer	Buffer to write in
+/*
+ * Program words in a single burst: PSIZE and PG are set once, then each
+ * word only costs its store and the BSY wait. Programming errors are
+ * sticky in FLASH_SR and checked once at the end of the burst.
  */
-void flash_read(uint8_t *buffer, physaddr_t addr, uint32_t size)
+static t_flash_err flash_program_burst32(physaddr_t addr, const uint8_t *buf, uint32_t nwords)
 {
-	if (!IS_IN_FLASH(addr)) {
-		log_printf("Read not authorized (not in flash memory)\n");
-        goto err;
-	}
-	/* Copy data into buffer */
-	memcpy(buffer, (void*)addr, size);
-err:
-    return;
-}
-
+    t_flash_err err;
+    uint32_t word;
+
+    if ((err = flash_check_not_busy()) != FLASH_ERR_NONE) {
+        return err;
+    }
+    flash_set_reg(r_CORTEX_M_FLASH_CR, 2, FLASH_CR_PSIZE);
+    flash_set_reg(r_CORTEX_M_FLASH_CR, 1, FLASH_CR_PG);
+    for (uint32_t i = 0; i < nwords; ++i) {
+        memcpy(&word, buf + (i << 2), sizeof(word));
+        if (word == 0xffffffff) {
+            /* nothing to program on erased flash */
+            continue;
+        }
+        flash_be_mem_write_32(addr + (i << 2), word);
+        if ((err = flash_busy_wait(FLASH_TMO(flash_tmo_prog[2]))) != FLASH_ERR_NONE) {
+            return err;
+        }
+    }
+    if (flash_has_programming_errors()) {
+        return FLASH_ERR_PROG;
+    }
+    return FLASH_ERR_NONE;
+}
+
+static t_flash_err flash_program_bytes(physaddr_t addr, const uint8_t *buf, uint32_t size)
+{
+    t_flash_err err = FLASH_ERR_NONE;
+
+    for (uint32_t i = 0; i < size; ++i) {
+        if (buf[i] == 0xff) {
+            continue;
+        }
+        flash_program(addr + i, buf[i], 0, 8, err);
+        if (err != FLASH_ERR_NONE) {
+            return err;
+        }
+        if (flash_has_programming_errors()) {
+            return FLASH_ERR_PROG;
+        }
+    }
+    return FLASH_ERR_NONE;
+}
+
+/**
+ * \brief Program a buffer into already erased flash
+ *
+ * Contrary to the flash_program_*() functions, no sector is implicitly
+ * erased. Data is programmed by words, in a single burst, on the aligned
+ * part, and by bytes on the unaligned head and tail. Erased (0xff) data
+ * is not programmed.
+ *
+ * @param addr Destination address
+ * @param buf  Data to program
+ * @param size Size of the data
+ */
+t_flash_err flash_write(physaddr_t addr, const uint8_t *buf, uint32_t size)
+{
+    t_flash_err err = FLASH_ERR_INVAL;
+    uint32_t head, body;
+
+    if (size == 0) {
+        return FLASH_ERR_NONE;
+    }
+    if (buf == NULL || !IS_IN_FLASH(addr) || !IS_IN_FLASH(addr + size - 1)) {
+        goto err;
+    }
+    if (flash_is_range_protected(addr, size)) {
+        err = FLASH_ERR_WRP;
+        goto err;
+    }
+    flash_hook_program(addr, size);
+    head = (4 - (addr & 3)) & 3;
+    if (head > size) {
+        head = size;
+    }
+    body = (size - head) & ~3;
+    if ((err = flash_program_bytes(addr, buf, head)) != FLASH_ERR_NONE) {
+        goto err;
+    }
+    if (body && (err = flash_program_burst32(addr + head, buf + head, body >> 2)) != FLASH_ERR_NONE) {
+        goto err;
+    }
+    err = flash_program_bytes(addr + head + body, buf + head + body, size - head - body);
+    if (err != FLASH_ERR_NONE) {
+        goto err;
+    }
+    flash_last_err = FLASH_ERR_NONE;
+    return FLASH_ERR_NONE;
+err:
+    log_printf("error while writing flash at addr %x\n", addr);
+    flash_last_err = err;
+    return err;
+}
+
+/* return true if a sector of [addr, addr + size[ is PCROP protected */
+static bool flash_is_range_pcrop(physaddr_t addr, uint32_t size)
+{
+    if (!flash_wrp_loaded) {
+        flash_wrp_load();
+    }
+    if (flash_pcrop_map == 0 || size == 0) {
+        return false;
+    }
+    return (flash_range_sectors(addr, size) & flash_pcrop_map) != 0;
+}
+
+/**
+ * \brief Read from flash memory
+ *
+ * Reading a PCROP protected sector would set RDERR (and fault if the read
+ * error interrupt is enabled): such reads are refused, the buffer being
+ * zeroed.
+ *
+ * @param addr		Adress to read from
+ * @param size		Size to read
+ * @param buffer	Buffer to write in
+ */
+t_flash_err flash_read(uint8_t *buffer, physaddr_t addr, uint32_t size)
+{
+	if (!IS_IN_FLASH(addr)) {
+		log_printf("Read not authorized (not in flash memory)\n");
+        return FLASH_ERR_INVAL;
+	}
+	if (flash_is_range_pcrop(addr, size)) {
+		log_printf("Read not authorized (PCROP sector)\n");
+        memset(buffer, 0, size);
+        return FLASH_ERR_PCROP;
+	}
+	/* Copy data into buffer */
+	flash_be_mem_read(buffer, addr, size);
+    return FLASH_ERR_NONE;
+}
+
 
 #if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)      /*  Dual blank only on f42xxx/43xxx */
 /**
@@ -887,7 +1579,7 @@ err:
 uint8_t flash_get_bank_conf(void)
 {
 #if CONFIG_USR_DRV_FLASH_1M
-	return get_reg(r_CORTEX_M_FLASH_OPTCR, FLASH_OPTCR_DB1M) == 0 ? 0 : 1;
+	return flash_get_reg(r_CORTEX_M_FLASH_OPTCR, FLASH_OPTCR_DB1M) == 0 ? 0 : 1;
 #else
     /* always in dual bank in 2M mode */
     return 1;
@@ -907,12 +1599,568 @@ void flash_set_bank_conf(uint8_t conf __attribute__((unused)))
 	if (conf){
 		conf = 1;
 	}
-	set_reg(r_CORTEX_M_FLASH_OPTCR, conf, FLASH_OPTCR_DB1M);
+	flash_set_reg(r_CORTEX_M_FLASH_OPTCR, conf, FLASH_OPTCR_DB1M);
 #endif
     /* with 2Mbytes flash mode, only dual bank mode is supported */
 }
 #endif
 
+#if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)      /*  Dual blank only on f42xxx/43xxx */
+# define FLASH_OPTCR_USER_MSK   (FLASH_OPTCR_BOR_LEV_Msk | FLASH_OPTCR_BFB2_Msk |\
+                                 FLASH_OPTCR_WDG_SW_Msk | FLASH_OPTCR_nRST_STOP_Msk |\
+                                 FLASH_OPTCR_nRST_STDBY_Msk | FLASH_OPTCR_RDP_Msk |\
+                                 FLASH_OPTCR_nWRP_Msk | FLASH_OPTCR_DB1M_Msk |\
+                                 FLASH_OPTCR_SPRMOD_Msk)
+#else
+# define FLASH_OPTCR_USER_MSK   (FLASH_OPTCR_BOR_LEV_Msk | FLASH_OPTCR_WDG_SW_Msk |\
+                                 FLASH_OPTCR_nRST_STOP_Msk | FLASH_OPTCR_nRST_STDBY_Msk |\
+                                 FLASH_OPTCR_RDP_Msk | FLASH_OPTCR_nWRP_Msk)
+#endif
+
+/* nWRP bits of the device sectors */
+#if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)
+# define FLASH_OPT_NWRP_MSK     0xffffff
+#else
+# define FLASH_OPT_NWRP_MSK     0xfff
+#endif
+
+/**
+ * \brief Read the current option bytes
+ *
+ * The returned structure is the staging area of an option bytes
+ * transaction: any set of fields can be modified, then programmed with a
+ * single flash_opt_commit().
+ *
+ * @param opt Option bytes
+ */
+t_flash_err flash_opt_read(t_flash_opt *opt)
+{
+    uint32_t optcr;
+
+    if (opt == NULL) {
+        return FLASH_ERR_INVAL;
+    }
+    optcr = flash_be_read_reg(r_CORTEX_M_FLASH_OPTCR);
+    memset(opt, 0, sizeof(*opt));
+    opt->rdp = (optcr & FLASH_OPTCR_RDP_Msk) >> FLASH_OPTCR_RDP_Pos;
+    opt->bor_lev = (optcr & FLASH_OPTCR_BOR_LEV_Msk) >> FLASH_OPTCR_BOR_LEV_Pos;
+    opt->wdg_sw = !!(optcr & FLASH_OPTCR_WDG_SW_Msk);
+    opt->nrst_stop = !!(optcr & FLASH_OPTCR_nRST_STOP_Msk);
+    opt->nrst_stdby = !!(optcr & FLASH_OPTCR_nRST_STDBY_Msk);
+    opt->nwrp = (optcr & FLASH_OPTCR_nWRP_Msk) >> FLASH_OPTCR_nWRP_Pos;
+#if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)
+    opt->nwrp |= ((flash_be_read_reg(r_CORTEX_M_FLASH_OPTCR1) & FLASH_OPTCR1_nWRP_Msk)
+                  >> FLASH_OPTCR1_nWRP_Pos) << 12;
+    opt->db1m = !!(optcr & FLASH_OPTCR_DB1M_Msk);
+    opt->bfb2 = !!(optcr & FLASH_OPTCR_BFB2_Msk);
+    opt->sprmod = !!(optcr & FLASH_OPTCR_SPRMOD_Msk);
+#endif
+    return FLASH_ERR_NONE;
+}
+
+static bool flash_opt_equal(const t_flash_opt *a, const t_flash_opt *b)
+{
+    return a->rdp == b->rdp && a->bor_lev == b->bor_lev &&
+           a->wdg_sw == b->wdg_sw && a->nrst_stop == b->nrst_stop &&
+           a->nrst_stdby == b->nrst_stdby && a->nwrp == b->nwrp &&
+           a->db1m == b->db1m && a->bfb2 == b->bfb2 && a->sprmod == b->sprmod;
+}
+
+/*
+ * Program the option bytes. The RDP level 2 is only set when explicitly
+ * allowed, as it can't be undone.
+ */
+static t_flash_err flash_opt_program(const t_flash_opt *opt, bool allow_rdp2)
+{
+    uint32_t optcr, cur, timeout;
+    t_flash_opt check;
+    bool regression;
+    t_flash_err err = FLASH_ERR_INVAL;
+
+    if (opt == NULL || opt->bor_lev > 3 || (opt->nwrp & ~FLASH_OPT_NWRP_MSK)) {
+        goto err;
+    }
+    cur = flash_be_read_reg(r_CORTEX_M_FLASH_OPTCR);
+    if (cur & FLASH_OPTCR_OPTLOCK_Msk) {
+        log_printf("option bytes register is locked\n");
+        goto err;
+    }
+    optcr = ((uint32_t)opt->rdp << FLASH_OPTCR_RDP_Pos) |
+            ((uint32_t)opt->bor_lev << FLASH_OPTCR_BOR_LEV_Pos) |
+            ((opt->nwrp & 0xfff) << FLASH_OPTCR_nWRP_Pos);
+    if (opt->wdg_sw) {
+        optcr |= FLASH_OPTCR_WDG_SW_Msk;
+    }
+    if (opt->nrst_stop) {
+        optcr |= FLASH_OPTCR_nRST_STOP_Msk;
+    }
+    if (opt->nrst_stdby) {
+        optcr |= FLASH_OPTCR_nRST_STDBY_Msk;
+    }
+#if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)
+    if (opt->db1m) {
+        optcr |= FLASH_OPTCR_DB1M_Msk;
+    }
+    if (opt->bfb2) {
+        optcr |= FLASH_OPTCR_BFB2_Msk;
+    }
+    if (opt->sprmod) {
+        optcr |= FLASH_OPTCR_SPRMOD_Msk;
+    }
+#else
+    if (opt->db1m || opt->bfb2 || opt->sprmod) {
+        goto err;
+    }
+#endif
+    if (flash_opt_read(&check) != FLASH_ERR_NONE) {
+        goto err;
+    }
+    if (flash_opt_equal(&check, opt)) {
+        /* unmodified, spare an option bytes programming */
+        flash_last_err = FLASH_ERR_NONE;
+        return FLASH_ERR_NONE;
+    }
+    if (opt->rdp == FLASH_RDP_LEVEL_2 && !allow_rdp2) {
+        log_printf("RDP level 2 is only set by flash_opt_set_rdp_level2()\n");
+        goto err;
+    }
+    if ((err = flash_check_not_busy()) != FLASH_ERR_NONE) {
+        goto err;
+    }
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+    /* BFB2 is about to change, keep the bank booted from */
+    flash_boot_get_bank();
+#endif
+    /* leaving RDP level 1 mass erases the flash */
+    regression = check.rdp != FLASH_RDP_LEVEL_0 && opt->rdp == FLASH_RDP_LEVEL_0;
+    timeout = regression ? FLASH_TMO(flash_tmo_erase_mass[FLASH_ERASE_PSIZE])
+                         : FLASH_TMO(flash_tmo_erase_16k[FLASH_ERASE_PSIZE]);
+    if (regression) {
+        flash_hook_bank_erase(0);
+#if defined(CONFIG_USR_DRV_FLASH_DUAL_BANK)
+        flash_hook_bank_erase(1);
+#endif
+    }
+    log_printf("programming option bytes %x\n", optcr);
+#if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)
+    flash_be_write_reg(r_CORTEX_M_FLASH_OPTCR1,
+                       (flash_be_read_reg(r_CORTEX_M_FLASH_OPTCR1) & ~FLASH_OPTCR1_nWRP_Msk) |
+                       ((opt->nwrp >> 12) << FLASH_OPTCR1_nWRP_Pos));
+#endif
+    optcr |= cur & ~FLASH_OPTCR_USER_MSK;
+    /* the write protection is reloaded from the new option bytes */
+    flash_wrp_loaded = false;
+    flash_be_write_reg(r_CORTEX_M_FLASH_OPTCR, optcr);
+    flash_be_write_reg(r_CORTEX_M_FLASH_OPTCR, optcr | FLASH_OPTCR_OPTSTRT_Msk);
+    if ((err = flash_busy_wait(timeout)) != FLASH_ERR_NONE) {
+        goto err;
+    }
+    if (flash_has_programming_errors()) {
+        err = FLASH_ERR_PROG;
+        goto err;
+    }
+    if (regression) {
+        flash_hook_bank_erased(0);
+#if defined(CONFIG_USR_DRV_FLASH_DUAL_BANK)
+        flash_hook_bank_erased(1);
+#endif
+    }
+    flash_opt_read(&check);
+    if (!flash_opt_equal(&check, opt)) {
+        err = FLASH_ERR_VERIFY;
+        goto err;
+    }
+    flash_last_err = FLASH_ERR_NONE;
+    return FLASH_ERR_NONE;
+err:
+    log_printf("error while programming option bytes\n");
+    flash_last_err = err;
+    return err;
+}
+
+/**
+ * \brief Program the option bytes
+ *
+ * All the option bytes are programmed at once, with a single OPTSTRT:
+ * option bytes programming is long and stalls the flash, so that all the
+ * modifications of a provisioning step should be committed together.
+ * Nothing is programmed when the option bytes are unmodified.
+ *
+ * The option bytes register must have been unlocked (flash_unlock_opt()).
+ * Leaving the RDP level 1 mass erases the flash. Setting the RDP level 2 is
+ * refused (FLASH_ERR_INVAL), see flash_opt_set_rdp_level2().
+ *
+ * @param opt Option bytes, from flash_opt_read()
+ */
+t_flash_err flash_opt_commit(const t_flash_opt *opt)
+{
+    return flash_opt_program(opt, false);
+}
+
+/**
+ * \brief Set the RDP level 2, keeping the other option bytes
+ *
+ * The RDP level 2 is permanent: the debug interface and the system memory
+ * bootloader are disabled, and the option bytes can't be modified anymore.
+ * The option bytes register must have been unlocked (flash_unlock_opt()).
+ */
+t_flash_err flash_opt_set_rdp_level2(void)
+{
+    t_flash_opt opt;
+
+    flash_opt_read(&opt);
+    opt.rdp = FLASH_RDP_LEVEL_2;
+    return flash_opt_program(&opt, true);
+}
+
+/**
+ * \brief Stage the write protection of an address range
+ *
+ * The nWRP bits of all the sectors overlapping the range are modified in
+ * the staged option bytes, so that several ranges (e.g. protecting the
+ * bootloader while unprotecting the update bank) are applied by a single
+ * flash_opt_commit().
+ *
+ * @param opt     Option bytes, from flash_opt_read()
+ * @param addr    Range start address
+ * @param len     Range size
+ * @param protect true to write protect, false to unprotect
+ */
+t_flash_err flash_wrp_stage_range(t_flash_opt *opt, physaddr_t addr, uint32_t len,
+                                  bool protect)
+{
+    uint32_t map;
+
+    if (opt == NULL || len == 0 || !IS_IN_FLASH(addr) || !IS_IN_FLASH(addr + len - 1)) {
+        return FLASH_ERR_INVAL;
+    }
+    if (opt->sprmod) {
+        /* nWRP bits select PCROP sectors, which can't be unprotected */
+        return FLASH_ERR_INVAL;
+    }
+    map = flash_range_sectors(addr, len);
+    if (protect) {
+        opt->nwrp &= ~map;
+    } else {
+        opt->nwrp |= map;
+    }
+    return FLASH_ERR_NONE;
+}
+
+/**
+ * \brief Write protect or unprotect an address range
+ *
+ * All the sectors overlapping the range are modified, across both banks,
+ * with a single option bytes programming. The option bytes register must
+ * have been unlocked (flash_unlock_opt()).
+ *
+ * @param addr    Range start address
+ * @param len     Range size
+ * @param protect true to write protect, false to unprotect
+ */
+t_flash_err flash_wrp_set_range(physaddr_t addr, uint32_t len, bool protect)
+{
+    t_flash_opt opt;
+    t_flash_err err;
+
+    flash_opt_read(&opt);
+    if ((err = flash_wrp_stage_range(&opt, addr, len, protect)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    return flash_opt_commit(&opt);
+}
+
+/**
+ * \brief Return the write protected sectors
+ *
+ * @return sectors bitmap, bit n being set if sector n is write protected
+ */
+uint32_t flash_wrp_query(void)
+{
+    if (!flash_wrp_loaded) {
+        flash_wrp_load();
+    }
+    return flash_wrp_map;
+}
+
+/**
+ * \brief Stage the PCROP protection of an address range
+ *
+ * PCROP sectors can only be executed: data reads and writes are refused.
+ * Switching to PCROP mode (SPRMOD) changes the nWRP bits meaning, a set
+ * bit selecting a protected sector: the sectors write protected so far
+ * are then unprotected. PCROP can only be removed by an RDP level
+ * regression.
+ *
+ * @param opt  Option bytes, from flash_opt_read()
+ * @param addr Range start address
+ * @param len  Range size
+ */
+t_flash_err flash_pcrop_stage_range(t_flash_opt *opt, physaddr_t addr, uint32_t len)
+{
+    if (opt == NULL || len == 0 || !IS_IN_FLASH(addr) || !IS_IN_FLASH(addr + len - 1)) {
+        return FLASH_ERR_INVAL;
+    }
+#if defined(CONFIG_STM32F439) || defined(CONFIG_STM32F429)
+    if (!opt->sprmod) {
+        opt->sprmod = true;
+        opt->nwrp = 0;
+    }
+    opt->nwrp |= flash_range_sectors(addr, len);
+    return FLASH_ERR_NONE;
+#else
+    /* PCROP only exists on f42xxx/43xxx */
+    return FLASH_ERR_INVAL;
+#endif
+}
+
+/**
+ * \brief PCROP protect an address range
+ *
+ * All the sectors overlapping the range are protected with a single option
+ * bytes programming. The option bytes register must have been unlocked
+ * (flash_unlock_opt()).
+ *
+ * @param addr Range start address
+ * @param len  Range size
+ */
+t_flash_err flash_pcrop_set_range(physaddr_t addr, uint32_t len)
+{
+    t_flash_opt opt;
+    t_flash_err err;
+
+    flash_opt_read(&opt);
+    if ((err = flash_pcrop_stage_range(&opt, addr, len)) != FLASH_ERR_NONE) {
+        return err;
+    }
+    return flash_opt_commit(&opt);
+}
+
+/**
+ * \brief Return the PCROP protected sectors
+ *
+ * @return sectors bitmap, bit n being set if sector n is PCROP protected
+ */
+uint32_t flash_pcrop_query(void)
+{
+    if (!flash_wrp_loaded) {
+        flash_wrp_load();
+    }
+    return flash_pcrop_map;
+}
+
+#if CONFIG_USR_DRV_FLASH_DUAL_BANK
+/*
+ * Contiguous SRAM (SRAM1, SRAM2 and SRAM3: 192 KB on f42xxx/43xxx) and CCM
+ * RAM (64 KB): start, and end + 1
+ */
+#define FLASH_BOOT_SRAM         0x20000000
+#define FLASH_BOOT_SRAM_END     0x20030000
+#define FLASH_BOOT_CCM          0x10000000
+#define FLASH_BOOT_CCM_END      0x10010000
+
+/*
+ * Check the vector table of a bank image, as the system memory bootloader
+ * does before jumping to it: the initial stack pointer must be in SRAM (or
+ * CCM RAM) and the reset handler a thumb address in flash. The stack being
+ * full descending, the initial stack pointer can be the end of the RAM.
+ */
+static bool flash_is_bank_bootable(t_flash_bank_id bank)
+{
+    uint32_t vectors[2];
+    physaddr_t base;
+
+    base = flash_sector_addr(bank == FLASH_BANK_1 ? 12 : 0);
+    if (flash_read((uint8_t*)vectors, base, sizeof(vectors)) != FLASH_ERR_NONE) {
+        return false;
+    }
+    if (!(vectors[0] > FLASH_BOOT_SRAM && vectors[0] <= FLASH_BOOT_SRAM_END) &&
+        !(vectors[0] > FLASH_BOOT_CCM && vectors[0] <= FLASH_BOOT_CCM_END)) {
+        return false;
+    }
+    return (vectors[1] & 1) && IS_IN_FLASH(vectors[1] & ~1u);
+}
+
+/**
+ * \brief Return the bank the device booted from
+ *
+ * This is the bank selected by BFB2 at reset, even if BFB2 has been
+ * modified since.
+ */
+t_flash_bank_id flash_boot_get_bank(void)
+{
+    if (!flash_boot_bank_latched) {
+        flash_boot_bank = flash_get_reg(r_CORTEX_M_FLASH_OPTCR, FLASH_OPTCR_BFB2) ?
+                          FLASH_BANK_1 : FLASH_BANK_0;
+        flash_boot_bank_latched = true;
+    }
+    return flash_boot_bank;
+}
+
+/**
+ * \brief Select the bank to boot from at the next reset
+ *
+ * The bank image vector table is checked, then BFB2 is programmed with a
+ * single option bytes commit: switching images only takes this commit and
+ * a reset, instead of copying the image between banks. The option bytes
+ * register must have been unlocked (flash_unlock_opt()).
+ *
+ * @param bank Bank to boot from
+ */
+t_flash_err flash_boot_set_bank(t_flash_bank_id bank)
+{
+    t_flash_opt opt;
+
+    if (bank != FLASH_BANK_0 && bank != FLASH_BANK_1) {
+        return FLASH_ERR_INVAL;
+    }
+    if (!flash_is_bank_bootable(bank)) {
+        log_printf("bank %d doesn't hold a bootable image\n", bank);
+        return FLASH_ERR_VERIFY;
+    }
+    flash_opt_read(&opt);
+    opt.bfb2 = (bank == FLASH_BANK_1);
+    return flash_opt_commit(&opt);
+}
+#endif
+
+static inline void flash_otp_load(void)
+{
+    if (!flash_otp_loaded) {
+        flash_be_mem_read(flash_otp_cache, FLASH_SECTOR_OTP_AREA, sizeof(flash_otp_cache));
+        flash_otp_loaded = true;
+    }
+}
+
+static inline bool flash_otp_is_valid(uint8_t block, uint32_t offset, uint32_t size)
+{
+    return block < FLASH_OTP_BLOCKS && offset <= FLASH_OTP_BLOCK_SIZE &&
+           size <= FLASH_OTP_BLOCK_SIZE - offset;
+}
+
+/* program one OTP byte, the cache being updated on success */
+static t_flash_err flash_otp_program(uint32_t off, uint8_t value)
+{
+    t_flash_err err;
+
+	flash_program(FLASH_SECTOR_OTP_AREA + off, value, 0, 8, err);
+    if (err == FLASH_ERR_NONE && flash_has_programming_errors()) {
+        err = FLASH_ERR_PROG;
+    }
+    if (err != FLASH_ERR_NONE) {
+        /* the byte may be partially programmed */
+        flash_otp_loaded = false;
+        return err;
+    }
+    flash_otp_cache[off] = value;
+    return FLASH_ERR_NONE;
+}
+
+/**
+ * \brief Read from an OTP block
+ *
+ * The OTP area is read from the flash at the first call only, then from
+ * its RAM copy. The OTP device must be mapped at the first call.
+ *
+ * @param block  OTP block (0 to 15)
+ * @param offset Offset in the block
+ */
+t_flash_err flash_otp_read(uint8_t block, uint32_t offset, uint8_t *buf, uint32_t size)
+{
+    if (buf == NULL || !flash_otp_is_valid(block, offset, size)) {
+        return FLASH_ERR_INVAL;
+    }
+    flash_otp_load();
+    memcpy(buf, &flash_otp_cache[block * FLASH_OTP_BLOCK_SIZE + offset], size);
+    return FLASH_ERR_NONE;
+}
+
+/**
+ * \brief Return true if an OTP block is locked
+ */
+bool flash_otp_is_locked(uint8_t block)
+{
+    if (block >= FLASH_OTP_BLOCKS) {
+        return false;
+    }
+    flash_otp_load();
+    return flash_otp_cache[FLASH_OTP_LOCK_OFFSET + block] == 0x00;
+}
+
+/**
+ * \brief Program an OTP block
+ *
+ * OTP bits can only be programmed (cleared) once: the write is refused,
+ * without any flash access, if the block is locked (FLASH_ERR_WRP) or if
+ * it would require setting a programmed bit back (FLASH_ERR_INVAL). Bytes
+ * already holding the requested value are not programmed again. The flash
+ * must have been unlocked (flash_unlock()).
+ *
+ * @param block  OTP block (0 to 15)
+ * @param offset Offset in the block
+ */
+t_flash_err flash_otp_write(uint8_t block, uint32_t offset, const uint8_t *buf, uint32_t size)
+{
+    uint32_t off = block * FLASH_OTP_BLOCK_SIZE + offset;
+    t_flash_err err;
+
+    if (buf == NULL || !flash_otp_is_valid(block, offset, size)) {
+        err = FLASH_ERR_INVAL;
+        goto err;
+    }
+    if (flash_otp_is_locked(block)) {
+        err = FLASH_ERR_WRP;
+        goto err;
+    }
+    for (uint32_t i = 0; i < size; ++i) {
+        if ((flash_otp_cache[off + i] & buf[i]) != buf[i]) {
+            log_printf("OTP byte %x can't be programmed to %x\n", off + i, buf[i]);
+            err = FLASH_ERR_INVAL;
+            goto err;
+        }
+    }
+    for (uint32_t i = 0; i < size; ++i) {
+        if (flash_otp_cache[off + i] == buf[i]) {
+            continue;
+        }
+        if ((err = flash_otp_program(off + i, buf[i])) != FLASH_ERR_NONE) {
+            goto err;
+        }
+    }
+    flash_last_err = FLASH_ERR_NONE;
+    return FLASH_ERR_NONE;
+err:
+    flash_last_err = err;
+    return err;
+}
+
+/**
+ * \brief Lock an OTP block
+ *
+ * Locking is irreversible: the block can't be programmed anymore. The
+ * flash must have been unlocked (flash_unlock()).
+ *
+ * @param block  OTP block (0 to 15)
+ */
+t_flash_err flash_otp_lock(uint8_t block)
+{
+    t_flash_err err;
+
+    if (block >= FLASH_OTP_BLOCKS) {
+        err = FLASH_ERR_INVAL;
+        goto err;
+    }
+    if (!flash_otp_is_locked(block) &&
+        (err = flash_otp_program(FLASH_OTP_LOCK_OFFSET + block, 0x00)) != FLASH_ERR_NONE) {
+        goto err;
+    }
+    flash_last_err = FLASH_ERR_NONE;
+    return FLASH_ERR_NONE;
+err:
+    flash_last_err = err;
+    return err;
+}
+
 /**
  * \brief Return sector size in bytes
  *
@@ -922,6 +2170,13 @@ void flash_set_bank_conf(uint8_t conf __attribute__((unused)))
  */
 uint32_t flash_sector_size(uint8_t sector)
 {
+#if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+	if (sector >= 24 || !(flash_geometry.sectors & (1u << sector))) {
+		log_printf("[Flash] Error: bad sector %d\n", sector);
+		return 0;
+	}
+	return flash_geo_sector_size(sector % 12);
+#else
 	switch(sector){
 		case 0:
 			return FLASH_SECTOR_SIZE(0);
@@ -984,56 +2239,163 @@ uint32_t flash_sector_size(uint8_t sector)
 			log_printf("[Flash] Error: bad sector %d\n", sector);
 			return 0;
 	}
+#endif
+}
+
+/* sector start address, with bank 1 mapped at 0x08000000 */
+static physaddr_t flash_map_addr(uint8_t sector)
+{
+#if CONFIG_USR_DRV_FLASH_RUNTIME_GEOMETRY
+	if (sector >= 24 || !(flash_geometry.sectors & (1u << sector))) {
+		log_printf("[Flash] Error: bad sector %d\n", sector);
+		return 0;
+	}
+	return FLASH_SECTOR_0 + (sector >= 12 ? flash_geometry.bank2 : 0) +
+	       flash_geo_sector_off(sector % 12);
+#else
+	switch(sector){
+		case 0:
+			return FLASH_SECTOR_0;
+		case 1:
+			return FLASH_SECTOR_1;
+		case 2:
+			return FLASH_SECTOR_2;
+		case 3:
+			return FLASH_SECTOR_3;
+		case 4:
+			return FLASH_SECTOR_4;
+		case 5:
+			return FLASH_SECTOR_5;
+		case 6:
+			return FLASH_SECTOR_6;
+		case 7:
+			return FLASH_SECTOR_7;
+# if (CONFIG_USR_DRV_FLASH_1M && !CONFIG_USR_DRV_FLASH_DUAL_BANK) || CONFIG_USR_DRV_FLASH_2M
+		case 8:
+			return FLASH_SECTOR_8;
+		case 9:
+			return FLASH_SECTOR_9;
+		case 10:
+			return FLASH_SECTOR_10;
+		case 11:
+			return FLASH_SECTOR_11;
+#endif
+#if (CONFIG_USR_DRV_FLASH_1M && CONFIG_USR_DRV_FLASH_DUAL_BANK) || CONFIG_USR_DRV_FLASH_2M
+		case 12:
+			return FLASH_SECTOR_12;
+		case 13:
+			return FLASH_SECTOR_13;
+		case 14:
+			return FLASH_SECTOR_14;
+		case 15:
+			return FLASH_SECTOR_15;
+		case 16:
+			return FLASH_SECTOR_16;
+		case 17:
+			return FLASH_SECTOR_17;
+		case 18:
+			return FLASH_SECTOR_18;
+		case 19:
+			return FLASH_SECTOR_19;
+#endif
+# if CONFIG_USR_DRV_FLASH_2M
+		case 20:
+			return FLASH_SECTOR_20;
+		case 21:
+			return FLASH_SECTOR_21;
+		case 22:
+			return FLASH_SECTOR_22;
+		case 23:
+			return FLASH_SECTOR_23;
+#endif
+		default:
+			log_printf("[Flash] Error: bad sector %d\n", sector);
+			return 0;
+	}
+#endif
+}
+
+/**
+ * \brief Return sector start address
+ *
+ * When booted from bank 2, the address of a bank 1 sector is in the bank 2
+ * address range, and conversely.
+ *
+ * @return Sector start address, 0 if the sector doesn't exist
+ */
+physaddr_t flash_sector_addr(uint8_t sector)
+{
+    return flash_map_addr(flash_bank_swap(sector));
 }
 
 
-/* [RB] FIXME: do we really need such a complex function here?? */
 /**
  * \brief Copy one flash sector into another
  *
- * FIXME Verify size of both sectors accessed !
+ * Both addresses must be sector starts, and both sectors must have the
+ * same size. The destination sector is erased first, erased (0xffffffff)
+ * source words are not programmed.
  *
  * @param dest Destination address
  * @param src Sourcr address
  */
-void flash_copy_sector(physaddr_t dest, physaddr_t src)
+t_flash_err flash_copy_sector(physaddr_t dest, physaddr_t src)
 {
 	/* Set up variables */
-	uint8_t sector = 20;
-	uint8_t buffer[64];
-	uint32_t i = 0, j = 0, k = 0, sector_size = 0;
+	uint32_t buffer[16];
+	uint32_t i = 0, j = 0, sector_size = 0;
+	t_flash_err err = FLASH_ERR_INVAL;
 	if ((!IS_IN_FLASH(dest)) || (!IS_IN_FLASH(src))) {
 		log_printf("Read not authorized (not in flash memory)\n");
         goto err;
 	}
-	memset(buffer, 0, 64);
-	/* Erase sector */
-	sector = flash_sector_erase((physaddr_t)dest);
+	if (!is_sector_start(dest) || !is_sector_start(src)) {
+		log_printf("copy must be done from and to sectors start\n");
+        goto err;
+	}
 	/* Get sector size */
-	sector_size = flash_sector_size(sector);
-	/* Perform copy */
-	for (i = 0; i < sector_size; i++) { /* Go through each kB of the sector */
-		log_printf("#%d ", i);
-		for (j = 0; j < 16; j++) { /* Go through each 64B packet of each kB */
-			/* Read packet to copy */
-			flash_read(buffer, (src+(i<<8)+(j<<4)), 64); /* !!  sigh 32 bit addr, >>2  */
-			log_printf("Buffer #%d:\n", j+i*2);
-			for (k = 0; k < 64; k++)
-				log_printf("%x ", buffer[k]);
-			log_printf("\n");
-			/* Write packet by 1B */
-			for (k = 0; k < 64; k++)
-				flash_program_byte((uint8_t *)(dest)+(i<<10)+(j<<6)+k, buffer[k]);
-			flash_read(buffer,(dest+(i<<8)+(j<<4)), 64);
-			log_printf("Dest:\n");
-			for (k = 0; k < 64; k++)
-				log_printf("%x ", buffer[k]);
-			log_printf("\n");
-		} /* j loop */
-	} /* i loop */
+	sector_size = flash_sector_size(flash_select_sector(dest));
+	if (sector_size != flash_sector_size(flash_select_sector(src))) {
+		log_printf("sectors size mismatch\n");
+        goto err;
+	}
+	if (flash_is_range_pcrop(src, sector_size)) {
+		log_printf("source sector is PCROP protected\n");
+        err = FLASH_ERR_PCROP;
+        goto err;
+	}
+	/* Erase sector */
+	if (flash_sector_erase(dest) == 0xff) {
+        err = flash_last_err;
+        goto err;
+    }
+    flash_hook_program(dest, sector_size);
+	/* Perform copy, by 64 bytes packets */
+	for (i = 0; i < sector_size; i += sizeof(buffer)) {
+		if ((err = flash_read((uint8_t*)buffer, src + i, sizeof(buffer))) != FLASH_ERR_NONE) {
+			goto err;
+		}
+		for (j = 0; j < 16; j++) {
+			if (buffer[j] == 0xffffffff) {
+				/* nothing to program on an erased sector */
+				continue;
+			}
+			flash_program(dest + i + (j << 2), buffer[j], 2, 32, err);
+			if (err != FLASH_ERR_NONE) {
+				goto err;
+			}
+			if (flash_has_programming_errors()) {
+				err = FLASH_ERR_PROG;
+				goto err;
+			}
+		}
+	}
 	log_printf("End of copy\n");
+    flash_last_err = FLASH_ERR_NONE;
+    return FLASH_ERR_NONE;
 err:
-    return;
+    flash_last_err = err;
+    return err;
 }
 
 